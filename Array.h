@@ -15,7 +15,23 @@
 #include <stdexcept>
 #include <algorithm>
 #include <cstring>
+#include <cstdint>
 #include <limits>
+#include <bit>
+#include "Optional.hpp"
+#include "Expected.hpp"
+#include "Instrumentation.h"
+#include "Trace.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define POTATO_HAVE_SSE2 1
+#endif
+
+/* 超过该字节数的批量写入使用 non-temporal store 绕过缓存, 默认取常见 LLC 的大小 */
+#if !defined(POTATO_NON_TEMPORAL_THRESHOLD)
+#  define POTATO_NON_TEMPORAL_THRESHOLD (32u * 1024u * 1024u)
+#endif
 
 namespace Potato {
 	namespace TypeTools {
@@ -173,6 +189,303 @@ namespace Potato {
 			>;
 
 
+		template <typename Alloc, typename = void>
+		struct HasMemberConstruct : std::false_type{};
+
+		template <typename Alloc>
+		struct HasMemberConstruct <
+			Alloc,
+			std::void_t<
+				/* 检测 Alloc 是否有自定义的 construct(pointer, const value_type&) */
+				decltype(std::declval<Alloc&>().construct(
+					std::declval<typename std::allocator_traits<Alloc>::pointer>(),
+					std::declval<const typename Alloc::value_type&>()
+				))
+			>
+		> : std::true_type{};
+
+		template <typename Alloc>
+		constexpr bool UseDefaultConstructVal = (!HasMemberConstruct<Alloc>::value) ||
+			std::is_same_v<Alloc, std::allocator<typename Alloc::value_type>>;
+
+		/**
+		 * @brief 是否可以把 Alloc 上的批量构造/拷贝/搬运/析构降级为 memcpy / memmove / memset
+		 * @note: 需要同时满足:
+		 *     1. 指针是裸指针 (IsSimpleAllocVal)
+		 *     2. 元素是平凡可拷贝的
+		 *     3. 分配器没有自定义 construct / destroy (否则绕过它们会改变语义)
+		 */
+		template <typename Alloc>
+		constexpr bool UseTrivialBulkVal = TypeTools::IsSimpleAllocVal<Alloc>
+			&& std::is_trivially_copyable_v<typename Alloc::value_type>
+			&& UseDefaultConstructVal<Alloc>
+			&& UseDefaultDestroyVal<Alloc>;
+
+		/**
+		 * @brief 扩容时能否把旧元素 memcpy 到新缓冲区, 并且不再析构旧元素
+		 * @note: 比 UseTrivialBulkVal 宽松: 只要求元素可重定位 (见 Core::Traits::TriviallyRelocatable),
+		 *     例如 Optional<std::unique_ptr<T>>, std::shared_ptr<T>, Array<T>
+		 */
+		template <typename Alloc>
+		constexpr bool UseTrivialRelocateVal = TypeTools::IsSimpleAllocVal<Alloc>
+			&& Core::Traits::IsTriviallyRelocatableVal<typename Alloc::value_type>
+			&& UseDefaultConstructVal<Alloc>
+			&& UseDefaultDestroyVal<Alloc>;
+
+		/* 平凡类型的值初始化 (Ty()) 等价于全零字节 */
+		template <typename Alloc>
+		constexpr bool UseTrivialZeroVal = UseTrivialBulkVal<Alloc>
+			&& std::is_trivially_default_constructible_v<typename Alloc::value_type>
+			&& !std::is_member_pointer_v<typename Alloc::value_type>;
+
+		/**
+		 * @brief Iter 指向的区间能否直接作为 memcpy 的源: 连续迭代器, 且元素类型与 Ty 一致
+		 * @note: move_iterator 对平凡类型来说移动就是拷贝, 所以解开后同样可以 memcpy
+		 */
+		template <typename Iter, typename Ty>
+		constexpr bool IsMemcpySourceVal = std::contiguous_iterator<Iter>
+			&& std::is_same_v<std::remove_cv_t<std::iter_value_t<Iter>>, Ty>;
+
+		template <typename Iter, typename Ty>
+		constexpr bool IsMemcpySourceVal<std::move_iterator<Iter>, Ty> = IsMemcpySourceVal<Iter, Ty>;
+
+		template <typename Iter>
+		constexpr auto ToRawPointer(Iter iter) noexcept {
+			return std::to_address(iter);
+		}
+
+		template <typename Iter>
+		constexpr auto ToRawPointer(std::move_iterator<Iter> iter) noexcept {
+			return std::to_address(iter.base());
+		}
+
+		inline constexpr std::size_t NonTemporalThreshold = POTATO_NON_TEMPORAL_THRESHOLD;
+
+		/**
+		 * @brief 平凡类型的批量操作层: 全部降级为 memcpy / memmove / memset, 不需要任何异常守卫
+		 * @note: 调用者负责保证 Ty 满足 UseTrivialBulkVal, 返回值均为写入区间的末尾
+		 */
+		template <typename Ty>
+		Ty* TrivialCopy(Ty* dest, const Ty* src, const std::size_t count) noexcept {
+			if (count != 0) {
+				std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(Ty));
+			}
+			return dest + count;
+		}
+
+		/* 源区间与目标区间可以重叠 */
+		template <typename Ty>
+		Ty* TrivialMove(Ty* dest, const Ty* src, const std::size_t count) noexcept {
+			if (count != 0) {
+				std::memmove(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(Ty));
+			}
+			return dest + count;
+		}
+
+		/**
+		 * @brief 绕过缓存的大块拷贝, 源区间与目标区间不能重叠
+		 * @note: 每次处理 64 字节 (一条缓存行): 提前 StreamingPrefetchDistance 字节以 NTA 提示预取源数据,
+		 *     目标用 _mm_stream_si128 直接写回内存. 这样搬运一个远大于 LLC 的数组时,
+		 *     源和目标都不会占据缓存, 同一 socket 上其他线程的工作集得以保留.
+		 *     没有 SSE2 时退化为 memcpy.
+		 */
+		inline constexpr std::size_t StreamingPrefetchDistance = 512;
+
+		inline void StreamingCopy(unsigned char* dest, const unsigned char* src, std::size_t bytes) noexcept {
+#if defined(POTATO_HAVE_SSE2)
+			/* 不足一条缓存行时直接 memcpy, 否则下面的 bytes -= head 可能下溢 (阈值可以由用户调小) */
+			if (bytes < 64) {
+				std::memcpy(dest, src, bytes);
+				return;
+			}
+			/* 头部: 拷贝到 dest 的下一个 16 字节对齐位置 */
+			const std::size_t head = (16u - (reinterpret_cast<std::uintptr_t>(dest) & 15u)) & 15u;
+			std::memcpy(dest, src, head);
+			dest += head;
+			src += head;
+			bytes -= head;
+			const unsigned char* const last = src + (bytes & ~static_cast<std::size_t>(63));
+			for (; src != last; src += 64, dest += 64) {
+				_mm_prefetch(reinterpret_cast<const char*>(src + StreamingPrefetchDistance), _MM_HINT_NTA);
+				const __m128i x0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+				const __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+				const __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+				const __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+				_mm_stream_si128(reinterpret_cast<__m128i*>(dest), x0);
+				_mm_stream_si128(reinterpret_cast<__m128i*>(dest + 16), x1);
+				_mm_stream_si128(reinterpret_cast<__m128i*>(dest + 32), x2);
+				_mm_stream_si128(reinterpret_cast<__m128i*>(dest + 48), x3);
+			}
+			/* non-temporal store 是弱序的, 发布新缓冲区之前必须 sfence */
+			_mm_sfence();
+			std::memcpy(dest, src, bytes & 63u);
+#else
+			std::memcpy(dest, src, bytes);
+#endif
+		}
+
+		/**
+		 * @brief 扩容时把旧缓冲区的平凡元素搬到新缓冲区
+		 * @note: 超过 NonTemporalThreshold 字节时走 StreamingCopy, 否则就是 memcpy.
+		 *     旧缓冲区搬完即被释放, 新缓冲区在下一次写满之前也大多不会再被访问,
+		 *     所以没有必要让它们经过缓存.
+		 */
+		template <typename Ty>
+		Ty* TrivialRelocate(Ty* dest, const Ty* src, const std::size_t count) noexcept {
+			const std::size_t bytes = count * sizeof(Ty);
+			if (bytes >= NonTemporalThreshold) {
+				StreamingCopy(reinterpret_cast<unsigned char*>(dest), reinterpret_cast<const unsigned char*>(src), bytes);
+				return dest + count;
+			}
+			return TrivialCopy(dest, src, count);
+		}
+
+		/**
+		 * @brief 统计 count 个步长为 stride 的记录中, 偏移 offset 处的标志字节非零的个数
+		 * @note: 用于 Array<Optional<T>>::CountPresent. stride 整除 16 时, SSE2 下一次读取
+		 *     16 / stride 条记录, _mm_cmpeq_epi8 与 0 比较后取 movemask, 只保留标志字节所在的位
+		 *     再 popcount, 整个循环没有数据相关的分支. 其他情况逐字节累加 (同样无分支).
+		 */
+		inline std::size_t CountFlagBytes(const unsigned char* base, const std::size_t count, const std::size_t stride, const std::size_t offset) noexcept {
+			std::size_t result = 0;
+			std::size_t index = 0;
+#if defined(POTATO_HAVE_SSE2)
+			if (stride <= 16 && 16 % stride == 0) {
+				const std::size_t per_block = 16 / stride;
+				unsigned lane_mask = 0;
+				for (std::size_t k = 0; k < per_block; ++k) {
+					lane_mask |= 1u << (k * stride + offset);
+				}
+				const __m128i zero = _mm_setzero_si128();
+				const std::size_t blocks = count / per_block;
+				const unsigned char* cursor = base;
+				for (std::size_t block = 0; block < blocks; ++block, cursor += 16) {
+					const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cursor));
+					const unsigned empty = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero)));
+					result += static_cast<std::size_t>(std::popcount(~empty & lane_mask));
+				}
+				index = blocks * per_block;
+			}
+#endif
+			for (; index < count; ++index) {
+				result += base[index * stride + offset] != 0;
+			}
+			return result;
+		}
+
+		/**
+		 * @brief 用 16 字节的 pattern 填充 [dest, dest + bytes) 字节
+		 * @param pattern: 写入 dest 处的 16 个字节, 调用者保证元素大小整除 16,
+		 *     这样每一个 16 字节块的内容都相同
+		 * @note: SSE2 下使用 16 字节的广播存储; 字节数超过 NonTemporalThreshold (约为 LLC 大小)
+		 *     时改用 non-temporal store (_mm_stream_si128), 填充大块内存时不会把其他线程的
+		 *     工作集挤出缓存. 没有 SSE2 时退化为 memcpy 倍增.
+		 */
+		inline void PatternFill(unsigned char* dest, const unsigned char (&pattern)[16], std::size_t bytes) noexcept {
+#if defined(POTATO_HAVE_SSE2)
+			const __m128i lane = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern));
+			/* 不足一条缓存行时走下面的普通存储, 否则头部的 16 字节写入可能越界 (阈值可以由用户调小) */
+			if (bytes >= NonTemporalThreshold && bytes >= 64) {
+				/* 先用一次非对齐写入覆盖头部, 再从下一个 16 字节对齐的位置开始流式写入 */
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), lane);
+				const std::size_t head = 16u - (reinterpret_cast<std::uintptr_t>(dest) & 15u);
+				unsigned char rotated[16];
+				for (std::size_t i = 0; i < 16; ++i) {
+					rotated[i] = pattern[(head + i) & 15u];
+				}
+				const __m128i aligned_lane = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rotated));
+				unsigned char* cursor = dest + head;
+				unsigned char* const last = dest + bytes;
+				for (; last - cursor >= 64; cursor += 64) {
+					_mm_stream_si128(reinterpret_cast<__m128i*>(cursor), aligned_lane);
+					_mm_stream_si128(reinterpret_cast<__m128i*>(cursor + 16), aligned_lane);
+					_mm_stream_si128(reinterpret_cast<__m128i*>(cursor + 32), aligned_lane);
+					_mm_stream_si128(reinterpret_cast<__m128i*>(cursor + 48), aligned_lane);
+				}
+				/* non-temporal store 是弱序的, 必须 sfence 之后其他线程才能看到一致的结果 */
+				_mm_sfence();
+				for (; last - cursor >= 16; cursor += 16) {
+					_mm_store_si128(reinterpret_cast<__m128i*>(cursor), aligned_lane);
+				}
+				std::memcpy(cursor, rotated, static_cast<std::size_t>(last - cursor));
+				return;
+			}
+			std::size_t offset = 0;
+			for (; bytes - offset >= 64; offset += 64) {
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + offset), lane);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + offset + 16), lane);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + offset + 32), lane);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + offset + 48), lane);
+			}
+			for (; bytes - offset >= 16; offset += 16) {
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + offset), lane);
+			}
+			std::memcpy(dest + offset, pattern, bytes - offset);
+#else
+			std::size_t filled = std::min<std::size_t>(bytes, 16u);
+			std::memcpy(dest, pattern, filled);
+			while (filled <= bytes - filled) {
+				std::memcpy(dest + filled, dest, filled);
+				filled *= 2;
+			}
+			std::memcpy(dest + filled, dest, bytes - filled);
+#endif
+		}
+
+		template <typename Ty>
+		Ty* TrivialZero(Ty* dest, const std::size_t count) noexcept {
+			const std::size_t bytes = count * sizeof(Ty);
+			if (bytes >= NonTemporalThreshold) {
+				const unsigned char zeros[16] = {};
+				PatternFill(reinterpret_cast<unsigned char*>(dest), zeros, bytes);
+			} else if (bytes != 0) {
+				std::memset(static_cast<void*>(dest), 0, bytes);
+			}
+			return dest + count;
+		}
+
+		/**
+		 * @brief 用 value 填充 [dest, dest + count)
+		 * @note: 1. 全零字节的值走 TrivialZero (memset)
+		 *        2. 元素大小整除 16 (1, 2, 4, 8, 16 字节) 时把 value 广播成 16 字节, 交给 PatternFill
+		 *        3. 其他大小先写入一个元素, 再以 1, 2, 4, 8 ... 个元素为块用 memcpy 倍增复制,
+		 *           只需要 log2(count) 次调用
+		 */
+		template <typename Ty>
+		Ty* TrivialFill(Ty* dest, const std::size_t count, const Ty& value) noexcept {
+			if (count == 0) {
+				return dest;
+			}
+			unsigned char bytes[sizeof(Ty)];
+			std::memcpy(bytes, std::addressof(value), sizeof(Ty));
+			if (std::all_of(bytes, bytes + sizeof(Ty), [](unsigned char byte) { return byte == 0; })) {
+				return TrivialZero(dest, count);
+			}
+			if constexpr (sizeof(Ty) == 1) {
+				if (count < NonTemporalThreshold) {
+					std::memset(static_cast<void*>(dest), bytes[0], count);
+					return dest + count;
+				}
+			}
+			if constexpr (16 % sizeof(Ty) == 0) {
+				unsigned char pattern[16];
+				for (std::size_t i = 0; i < 16; ++i) {
+					pattern[i] = bytes[i % sizeof(Ty)];
+				}
+				PatternFill(reinterpret_cast<unsigned char*>(dest), pattern, count * sizeof(Ty));
+				return dest + count;
+			} else {
+				std::memcpy(static_cast<void*>(dest), bytes, sizeof(Ty));
+				std::size_t filled = 1;
+				while (filled <= count - filled) {
+					TrivialCopy(dest + filled, dest, filled);
+					filled *= 2;
+				}
+				TrivialCopy(dest + filled, dest, count - filled);
+				return dest + count;
+			}
+		}
+
 		template <typename Alloc>
 		constexpr void DestroyRange(AllocPointer<Alloc> first, AllocPointer<Alloc> last, Alloc& allocator) noexcept {
 			using value_type = typename Alloc::value_type;
@@ -197,7 +510,7 @@ namespace Potato {
 			ConstructBackoutGuard& operator=(const ConstructBackoutGuard&) = delete;
 
 			constexpr ~ConstructBackoutGuard() {
-				DestroyRange(m_dest, m_src, allocator);
+				DestroyRange(m_src, m_dest, allocator);
 			}
 
 			template <typename... Types>
@@ -223,19 +536,15 @@ namespace Potato {
 		 */
 		template <typename Alloc>
 		constexpr AllocPointer<Alloc> BatchOfZeroConstruction(AllocPointer<Alloc> start, AllocSize<Alloc> count, Alloc& allocator){
-			using pointer = typename Alloc::value_type*;
 			using size_type = typename std::allocator_traits<Alloc>::size_type;
-			using value_type = std::remove_pointer_t<std::remove_cv_t<pointer>>;
 			/* memset 优化 */
-			if constexpr (std::is_trivially_default_constructible_v<value_type>
-						&& std::is_trivially_copyable_v<value_type>
-						&& !std::is_constant_evaluated()) /* 常量求值的情况下不使用 memset */
-			{
-				auto first = Unfancy(start);
-				char* const first_ = reinterpret_cast<char*>(first);
-				char* const last_ = reinterpret_cast<char*>(first_ + count);
-				std::memset(first_, 0, static_cast<std::size_t>(last_ - first_));
-				return start + count;
+			if constexpr (UseTrivialZeroVal<Alloc>) {
+				/* 常量求值的情况下不使用 memset */
+				/* 注意: is_constant_evaluated 不能放在 if constexpr 的条件里, 那里它恒为 true */
+				if (!std::is_constant_evaluated()) {
+					TrivialZero(Unfancy(start), static_cast<std::size_t>(count));
+					return start + count;
+				}
 			}
 			if (std::is_constant_evaluated()) {
 				for (size_type i=0; i < count; ++i){
@@ -264,16 +573,115 @@ namespace Potato {
 		template <typename Alloc>
 		constexpr AllocPointer<Alloc> BatchOfFillConstruction(AllocPointer<Alloc> start, AllocSize<Alloc> count, const typename Alloc::value_type& value, Alloc& allocator){
 			// memset 路径: 对于标量类型且非 volatile 类型可以使用 memset 优化
+			if constexpr (UseTrivialBulkVal<Alloc>) {
+				if (!std::is_constant_evaluated()) {
+					return TrivialFill(Unfancy(start), static_cast<std::size_t>(count), value);
+				}
+			}
 
 			ConstructBackoutGuard<Alloc> Guard{ start, allocator };
 			for (; 0 < count; --count){
-				Guard.Append();
+				Guard.Append(value);
 			}
 			return Guard.Release();
 		}
 
 	};
 
+	/**
+	 * @brief: 有序区间上的查找算法, Array 与 FlatMap 共用
+	 * @note: 1. BranchlessLowerBound / BranchlessUpperBound: 每一步只用条件选择 (cmov) 收缩区间,
+	 *           循环次数只与长度有关, 不会因为比较结果不可预测而清空流水线;
+	 *           同时预取下一步可能访问的两个中点, 把访存延迟与当前比较重叠
+	 *        2. EytzingerLowerBound: 在 BFS 顺序 (Eytzinger layout, 1-based) 的数组上查找,
+	 *           第 k 个节点的子节点是 2k 和 2k + 1, 一条缓存行能覆盖之后好几层的子孙, 预取更有效
+	 */
+	namespace SearchTools {
+		/* 预取 address 所在的缓存行, 只是提示, 地址无效也不会出错 */
+		inline void Prefetch(const void* address) noexcept {
+#if defined(POTATO_HAVE_SSE2)
+			_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#elif defined(__GNUC__)
+			__builtin_prefetch(address);
+#else
+			(void)address;
+#endif
+		}
+		/* 越界的预取地址不能用指针运算得到, 用整数运算 */
+		template <typename Ty>
+		inline const void* PrefetchAddress(const Ty* base, const std::size_t offset) noexcept {
+			return reinterpret_cast<const void*>(reinterpret_cast<std::uintptr_t>(base) + offset * sizeof(Ty));
+		}
+
+		/* 返回第一个不满足 comp(element, key) 的下标, 不存在时返回 count */
+		template <typename Ty, typename Key, typename Compare>
+		constexpr std::size_t BranchlessLowerBound(const Ty* data, std::size_t count, const Key& key, Compare comp) {
+			if (count == 0) {
+				return 0;
+			}
+			const Ty* base = data;
+			while (count > 1) {
+				const std::size_t half = count / 2;
+				if (!std::is_constant_evaluated()) {
+					Prefetch(PrefetchAddress(base, half / 2));
+					Prefetch(PrefetchAddress(base, half + half / 2));
+				}
+				base = comp(base[half], key) ? base + half : base;
+				count -= half;
+			}
+			return static_cast<std::size_t>(base - data) + static_cast<std::size_t>(comp(*base, key));
+		}
+
+		/* 返回第一个满足 comp(key, element) 的下标, 不存在时返回 count */
+		template <typename Ty, typename Key, typename Compare>
+		constexpr std::size_t BranchlessUpperBound(const Ty* data, std::size_t count, const Key& key, Compare comp) {
+			if (count == 0) {
+				return 0;
+			}
+			const Ty* base = data;
+			while (count > 1) {
+				const std::size_t half = count / 2;
+				if (!std::is_constant_evaluated()) {
+					Prefetch(PrefetchAddress(base, half / 2));
+					Prefetch(PrefetchAddress(base, half + half / 2));
+				}
+				base = comp(key, base[half]) ? base : base + half;
+				count -= half;
+			}
+			return static_cast<std::size_t>(base - data) + static_cast<std::size_t>(!comp(key, *base));
+		}
+
+		/**
+		 * @brief 按中序遍历计算 1-based 的 Eytzinger 数组中每个节点对应的有序下标
+		 * @param ranks: 至少 count + 1 个元素, ranks[0] 不使用; ranks[k] 为节点 k 在有序数组中的下标
+		 * @note: 只计算下标, 键由调用者按节点顺序直接拷贝构造, 不要求元素可默认构造
+		 */
+		template <typename SizeType>
+		constexpr std::size_t EytzingerRanks(std::size_t next, SizeType* ranks, const std::size_t node, const std::size_t count) {
+			if (node <= count) {
+				next = EytzingerRanks(next, ranks, 2 * node, count);
+				ranks[node] = static_cast<SizeType>(next);
+				++next;
+				next = EytzingerRanks(next, ranks, 2 * node + 1, count);
+			}
+			return next;
+		}
+
+		/* 返回 lower bound 所在的节点编号, 不存在时返回 0 */
+		template <typename Ty, typename Key, typename Compare>
+		std::size_t EytzingerLowerBound(const Ty* keys, const std::size_t count, const Key& key, Compare comp) {
+			/* 预取 4 层之后的子孙: 节点 16k 到 16k + 15 是连续的 */
+			constexpr std::size_t PrefetchStride = 16;
+			std::size_t node = 1;
+			while (node <= count) {
+				Prefetch(PrefetchAddress(keys, node * PrefetchStride));
+				node = 2 * node + static_cast<std::size_t>(comp(keys[node], key));
+			}
+			/* 去掉末尾连续的 "向右" (1) 以及最后一次 "向左" (0) */
+			return node >> (std::countr_one(node) + 1);
+		}
+	};
+
 	template <typename ValueType, typename SizeType, typename DifferenceType, typename Pointer, typename ConstPointer, typename Reference, typename ConstReference>
 	struct GenerateElementWrapper {
 		using value_type      = ValueType;
@@ -288,6 +696,19 @@ namespace Potato {
 	struct ZeroInitTag {
 		explicit ZeroInitTag() = default;
 	};
+
+	/* Array 不抛异常的 API (TryAt, TryReserve ...) 返回的错误码 */
+	enum class ArrayErrc : std::uint8_t {
+		OutOfRange = 1,   // 下标越界, 对应 At 抛出的 std::out_of_range
+		LengthError,      // 请求的容量超过 MaxSize, 对应 std::length_error
+		BadAlloc,         // 分配器分配失败, 对应 std::bad_alloc
+	};
+
+	/* 元素类型为 Core::Optional<T> (T 不是引用) 时, Array 提供 Compact / Unwrap / CountPresent 等批量算法 */
+	template <typename Ty>
+	constexpr bool IsOptionalElementVal = false;
+	template <typename Ty>
+	constexpr bool IsOptionalElementVal<Core::Optional<Ty>> = std::is_object_v<Ty>;
 	template <typename Array>
 	struct ArrayConstIterator {
 		using iterator_concept  = std::contiguous_iterator_tag;
@@ -464,6 +885,15 @@ namespace Potato {
 	};
 
 
+	template <typename Ty, typename Compare, typename Allocator>
+	class SearchIndex;
+
+	/* 定义在 HashMap.h, Array.h 末尾包含 */
+	template <typename Key>
+	struct DefaultHash;
+	template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+	class HashSet;
+
 	template <typename ElementType, class AllocatorType=std::allocator<ElementType>>
 	class Array {
 	private:
@@ -524,6 +954,10 @@ namespace Potato {
 		using const_iterator         = ArrayConstIterator<Array>;
 		using reverse_iterator       = std::reverse_iterator<iterator>;
 		using reverse_const_iterator = std::reverse_iterator<const_iterator>;
+		/* Array 只保存分配器和三个裸指针, 分配器可重定位时 Array 本身可重定位 */
+		using TriviallyRelocatableTp = std::bool_constant<
+			TypeTools::IsSimpleAllocVal<M_AllocatorType> && Core::Traits::IsTriviallyRelocatableVal<AllocatorType>
+		>;
 
 	private:
 		using M_DateType = ArrayData<
@@ -543,6 +977,18 @@ namespace Potato {
 		>;
 
 		using M_RealValueType = MemoryTools::CompressedPair<M_AllocatorType, M_DateType>;
+
+		/* 平凡类型特化层: 为 true 时所有批量路径都降级为 memcpy / memmove / memset, 且不需要异常守卫 */
+		static constexpr bool M_IsTrivialVal = MemoryTools::UseTrivialBulkVal<M_AllocatorType>;
+		static constexpr bool M_IsTrivialZeroVal = MemoryTools::UseTrivialZeroVal<M_AllocatorType>;
+		/* 可重定位层: 扩容时旧元素 memcpy 到新缓冲区, 旧缓冲区直接释放而不析构 */
+		static constexpr bool M_IsRelocatableVal = M_IsTrivialVal || MemoryTools::UseTrivialRelocateVal<M_AllocatorType>;
+
+		/* 定义 POTATO_ENABLE_INSTRUMENTATION 时扩容事件计入的记录, 见 Instrumentation.h */
+		using M_InstrumentationTag = Instrumentation::AllocatorTagTp<AllocatorType>;
+
+		/* Compact / Unwrap 需要直接写入另一种元素类型的 Array 的缓冲区 */
+		template <typename, class> friend class Array;
 	public:
 		constexpr explicit Array() noexcept
 			: m_Data(MemoryTools::ZeroConstructCompressedTag{}) {}
@@ -560,7 +1006,6 @@ namespace Potato {
 			: m_Data(MemoryTools::OneConstructCompressedTag{}, allocator) {}
 
 		constexpr explicit Array(const size_type count, const AllocatorType& allocator=AllocatorType())
-			noexcept (std::is_nothrow_copy_constructible_v<AllocatorType>)
 			: m_Data(MemoryTools::OneConstructCompressedTag{}, allocator) {
 			if (count > M_MaxSize()) [[unlikely]] {
 				throw std::length_error("Array size exceeds maximum limit.");
@@ -568,7 +1013,6 @@ namespace Potato {
 			M_FillZeroConstruct(count);
 		}
 		constexpr Array(size_type count, const_reference value, const AllocatorType& allocator=AllocatorType())
-			noexcept (std::is_nothrow_copy_constructible_v<AllocatorType>) 
 			: m_Data(MemoryTools::OneConstructCompressedTag{}, allocator) {
 			if (count > M_MaxSize()) [[unlikely]] {
 				throw std::length_error("Array size exceeds maximum limit.");
@@ -583,7 +1027,7 @@ namespace Potato {
 			: m_Data(MemoryTools::OneConstructCompressedTag{}, allocator) {
 
 			static_assert(
-				std::is_integral_v<typename std::iterator_traits<InputIterator>::value_type> == false,
+				std::is_integral_v<InputIterator> == false,
 				"InputIterator should not be an integral type."
 			);
 			M_RangeInitialize(first, last, typename std::iterator_traits<InputIterator>::iterator_category{});
@@ -593,11 +1037,16 @@ namespace Potato {
 			: Array(list.begin(), list.end(), allocator) /* 委托构造 */ { }
 		constexpr Array(const Array& other) : m_Data(MemoryTools::OneConstructCompressedTag{}, other.M_GetAllocator()) {
 			if (other.IsEmpty()) return;
-			M_AllocateUninitializedMemory(other.Capacity());
-			CleanGuard Guard{ this };
+			/* 只按 Size 分配: 拷贝出来的数组通常只读, 没有必要把 other 的 Slack 也复制过来 */
+			M_AllocateUninitializedMemory(other.Size());
 			auto& M_Data = this->m_Data.data;
-			M_Data.finish = std::uninitialized_copy(other.begin(), other.end(), M_Data.start);
-			Guard.Release();
+			if constexpr (M_IsTrivialVal) {
+				M_Data.finish = MemoryTools::TrivialCopy(M_Data.start, other.m_Data.data.start, other.Size());
+			} else {
+				CleanGuard Guard{ this };
+				M_Data.finish = std::uninitialized_copy(other.begin(), other.end(), M_Data.start);
+				Guard.Release();
+			}
 		}
 
 		constexpr Array(Array&& other) noexcept : m_Data(MemoryTools::OneConstructCompressedTag{}, std::move(other.M_GetAllocator())) {
@@ -757,13 +1206,213 @@ namespace Potato {
 			return static_cast<size_type>(-1);
 		}
 
+		/**
+		 * @brief: 返回下标的查找 API, 找不到时返回空的 Core::Optional<size_type>, 而不是 size_type(-1)
+		 * 		- FindFirst / FindFirstIf / FindLast / FindLastIf: 线性查找, 后两者从末尾向前
+		 * 		- LowerBound / UpperBound / BinarySearch: 要求数组按 comp 有序, 见 SearchTools 的无分支二分
+		 * 		- BuildSearchIndex: 为只读的有序数组构建 Eytzinger 布局的索引, 适合大量重复查找
+		 * @note: 都不分配内存 (BuildSearchIndex 除外), 不抛出异常 (除非比较本身抛出)
+		 */
+		[[nodiscard]] constexpr Core::Optional<size_type> FindFirst(const_reference item) const {
+			return M_ToIndex(Find(item));
+		}
+		template <typename Predicate>
+		[[nodiscard]] constexpr Core::Optional<size_type> FindFirstIf(Predicate pred) const {
+			return M_ToIndex(FindIf(pred));
+		}
+		[[nodiscard]] constexpr Core::Optional<size_type> FindLast(const_reference item) const {
+			for (size_type i = Size(); i > 0; --i) {
+				if (m_Data.data.start[i - 1] == item) return i - 1;
+			}
+			return Core::nullopt;
+		}
+		template <typename Predicate>
+		[[nodiscard]] constexpr Core::Optional<size_type> FindLastIf(Predicate pred) const {
+			for (size_type i = Size(); i > 0; --i) {
+				if (pred(m_Data.data.start[i - 1])) return i - 1;
+			}
+			return Core::nullopt;
+		}
+
+		/* 第一个不小于 key 的元素 */
+		template <typename Key, typename Compare = std::less<>>
+		[[nodiscard]] constexpr Core::Optional<size_type> LowerBound(const Key& key, Compare comp = Compare{}) const {
+			return M_ToIndex(SearchTools::BranchlessLowerBound(std::to_address(m_Data.data.start), Size(), key, comp));
+		}
+		/* 第一个大于 key 的元素 */
+		template <typename Key, typename Compare = std::less<>>
+		[[nodiscard]] constexpr Core::Optional<size_type> UpperBound(const Key& key, Compare comp = Compare{}) const {
+			return M_ToIndex(SearchTools::BranchlessUpperBound(std::to_address(m_Data.data.start), Size(), key, comp));
+		}
+		/* 任意一个等于 key 的元素 (实际是第一个) */
+		template <typename Key, typename Compare = std::less<>>
+		[[nodiscard]] constexpr Core::Optional<size_type> BinarySearch(const Key& key, Compare comp = Compare{}) const {
+			const size_type index = SearchTools::BranchlessLowerBound(std::to_address(m_Data.data.start), Size(), key, comp);
+			if (index == Size() || comp(key, m_Data.data.start[index])) {
+				return Core::nullopt;
+			}
+			return index;
+		}
+
+		/* 索引沿用本数组的分配器 (rebind 到 value_type) */
+		template <typename Compare = std::less<>>
+		[[nodiscard]] auto BuildSearchIndex(Compare comp = Compare{}) const {
+			assert(std::is_sorted(begin(), end(), comp) && "Array::BuildSearchIndex() requires a sorted array");
+			using IndexAllocTp = typename M_AllocatorTraits::template rebind_alloc<value_type>;
+			return SearchIndex<value_type, Compare, IndexAllocTp>(
+				std::to_address(m_Data.data.start), Size(), comp, IndexAllocTp{ M_GetAllocator() });
+		}
+
+		/**
+		 * @brief: 不抛异常的 At, 越界时返回 ArrayErrc::OutOfRange
+		 * @note: 返回的 Core::Expected<T&, ArrayErrc> 引用数组中的元素, 不拷贝
+		 * 		auto item = arr.TryAt(i);
+		 * 		if (!item) { return Core::Unexpected{ item.Error() }; }
+		 */
+		[[nodiscard]] constexpr Core::Expected<reference, ArrayErrc> TryAt(const size_type index) noexcept {
+			if (index >= Size()) return Core::Unexpected{ ArrayErrc::OutOfRange };
+			return m_Data.data.start[index];
+		}
+		[[nodiscard]] constexpr Core::Expected<const_reference, ArrayErrc> TryAt(const size_type index) const noexcept {
+			if (index >= Size()) return Core::Unexpected{ ArrayErrc::OutOfRange };
+			return m_Data.data.start[index];
+		}
+
+		/**
+		 * @brief: "可能存在的元素" 访问 API, 返回指向元素的 Core::Optional<T&>
+		 * @note: 不拷贝元素, 数组为空或找不到时返回空, 不会抛出异常; 返回值只有一个指针大小
+		 * 		if (auto item = arr.TryFind(42)) { *item = 43; }
+		 */
+		[[nodiscard]] constexpr Core::Optional<reference> TryFront() noexcept { return M_TryGet(0); }
+		[[nodiscard]] constexpr Core::Optional<const_reference> TryFront() const noexcept { return M_TryGet(0); }
+		[[nodiscard]] constexpr Core::Optional<reference> TryBack() noexcept { return M_TryGet(Size() - 1); }
+		[[nodiscard]] constexpr Core::Optional<const_reference> TryBack() const noexcept { return M_TryGet(Size() - 1); }
+
+		[[nodiscard]] constexpr Core::Optional<reference> TryFind(const_reference item) {
+			return M_TryGet(Find(item));
+		}
+		[[nodiscard]] constexpr Core::Optional<const_reference> TryFind(const_reference item) const {
+			return M_TryGet(Find(item));
+		}
+		template <typename Predicate>
+		[[nodiscard]] constexpr Core::Optional<reference> TryFindIf(Predicate pred) {
+			return M_TryGet(FindIf(pred));
+		}
+		template <typename Predicate>
+		[[nodiscard]] constexpr Core::Optional<const_reference> TryFindIf(Predicate pred) const {
+			return M_TryGet(FindIf(pred));
+		}
+
+		/**
+		 * @brief: Array<Core::Optional<T>> 的批量算法
+		 * 		- Compact: 按顺序收集所有有值的元素, 返回 Array<T>
+		 * 		- Unwrap: 空的位置填 fallback, 返回与原数组等长的 Array<T>
+		 * 		- CountPresent: 统计有值元素的个数
+		 * 		- TransformPresent: out[i] = fn(*arr[i]), 只对有值的位置调用 fn 并写入 out[i], 返回有值的个数
+		 * @note: 当 Optional<T> 平凡可拷贝且没有 niche 时 (见 Core::OptionalLayout), 直接读取每个元素的标志字节:
+		 * 		Compact 无条件拷贝并按标志前进写指针 (branchless stream compaction),
+		 * 		Unwrap 用条件选择代替分支, CountPresent 使用 SSE2 的字节比较.
+		 * 		混合了大量空值的数据上不会有分支预测失败. 其他情况退化为逐个 HasValue() 的实现.
+		 * 		TransformPresent 总是逐个判断: fn 不一定对 T{} 有定义 (例如 100 / x), 不能对空位置调用;
+		 * 		out 是随机访问迭代器, out[i] 对应 arr[i], 空位置上的 out[i] 不会被读写.
+		 */
+		[[nodiscard]] constexpr auto Compact() const requires IsOptionalElementVal<value_type> {
+			using ValueTp = typename value_type::ValueType;
+			using LayoutTp = Core::OptionalLayout<ValueTp>;
+			using ResultAllocTp = typename M_AllocatorTraits::template rebind_alloc<ValueTp>;
+			Array<ValueTp, ResultAllocTp> result{ ResultAllocTp{ M_GetAllocator() } };
+			const size_type count = Size();
+			if constexpr (LayoutTp::HasFlagByte) {
+				if (!std::is_constant_evaluated()) {
+					result.Reserve(count);
+					const unsigned char* source = reinterpret_cast<const unsigned char*>(m_Data.data.start);
+					unsigned char* dest = reinterpret_cast<unsigned char*>(result.m_Data.data.start);
+					std::size_t written = 0;
+					for (size_type index = 0; index < count; ++index, source += LayoutTp::Stride) {
+						std::memcpy(dest + written * sizeof(ValueTp), source + LayoutTp::ValueOffset, sizeof(ValueTp));
+						written += source[LayoutTp::FlagOffset];
+					}
+					result.m_Data.data.finish = result.m_Data.data.start + written;
+					return result;
+				}
+			}
+			for (const auto& item : *this) {
+				if (item.HasValue()) {
+					result.Append(*item);
+				}
+			}
+			return result;
+		}
+
+		template <typename Uty>
+		[[nodiscard]] constexpr auto Unwrap(const Uty& fallback) const requires IsOptionalElementVal<value_type> {
+			using ValueTp = typename value_type::ValueType;
+			using LayoutTp = Core::OptionalLayout<ValueTp>;
+			using ResultAllocTp = typename M_AllocatorTraits::template rebind_alloc<ValueTp>;
+			Array<ValueTp, ResultAllocTp> result{ ResultAllocTp{ M_GetAllocator() } };
+			const size_type count = Size();
+			result.Reserve(count);
+			if constexpr (LayoutTp::HasFlagByte) {
+				if (!std::is_constant_evaluated()) {
+					/* 条件选择的是拷贝的来源地址: 空位置直接拷贝 fallback, 不读取其中未初始化的字节, 也不需要 T 可默认构造 */
+					const ValueTp other = static_cast<ValueTp>(fallback);
+					const unsigned char* other_bytes = reinterpret_cast<const unsigned char*>(std::addressof(other));
+					const unsigned char* source = reinterpret_cast<const unsigned char*>(m_Data.data.start);
+					ValueTp* dest = result.m_Data.data.start;
+					for (size_type index = 0; index < count; ++index, source += LayoutTp::Stride) {
+						const unsigned char* from = source[LayoutTp::FlagOffset] ? source + LayoutTp::ValueOffset : other_bytes;
+						std::memcpy(static_cast<void*>(dest + index), from, sizeof(ValueTp));
+					}
+					result.m_Data.data.finish = dest + count;
+					return result;
+				}
+			}
+			/* 已经 Reserve 过, 直接在末尾构造: Append 会经过 M_InsertHoles, 要求 T 可默认构造 */
+			auto& result_data = result.m_Data.data;
+			for (const auto& item : *this) {
+				std::allocator_traits<ResultAllocTp>::construct(result.M_GetAllocator(), result_data.finish, item.ValueOr(fallback));
+				++result_data.finish;
+			}
+			return result;
+		}
+
+		[[nodiscard]] constexpr size_type CountPresent() const noexcept requires IsOptionalElementVal<value_type> {
+			using LayoutTp = Core::OptionalLayout<typename value_type::ValueType>;
+			if constexpr (LayoutTp::HasFlagByte) {
+				if (!std::is_constant_evaluated()) {
+					return static_cast<size_type>(MemoryTools::CountFlagBytes(
+						reinterpret_cast<const unsigned char*>(m_Data.data.start), Size(), LayoutTp::Stride, LayoutTp::FlagOffset
+					));
+				}
+			}
+			size_type result = 0;
+			for (const auto& item : *this) {
+				result += item.HasValue();
+			}
+			return result;
+		}
+
+		template <typename Fn, typename RandomAccessIterator>
+		constexpr size_type TransformPresent(Fn fn, RandomAccessIterator out) const requires IsOptionalElementVal<value_type> {
+			const size_type count = Size();
+			size_type present = 0;
+			for (size_type index = 0; index < count; ++index) {
+				const auto& item = m_Data.data.start[index];
+				if (item.HasValue()) {
+					out[index] = std::invoke(fn, *item);
+					++present;
+				}
+			}
+			return present;
+		}
+
 		/**
 		 * @brief: 函数式API, 它们都不会修改原有数组的值, 而是返回一个新的数组或者值
 		 * 		- Filter: 会返回一个新的数组, 该数组包含所有满足谓词条件的元素.
 		 *      - Transform 会返回一个新的数组, 内部元素均应用 FnTransform
 		 *      - Count 会计算满足条件的元素数量并返回该数量.
 		 *      - IsContain  会检查数组中是否包含满足条件的元素并返回布尔值.
-		 *      - Sort 会返回一个新的数组, 该数组包含排序后的元素.
+		 *      - Sort 会返回一个新的数组, 该数组包含排序后的元素 (原地排序见 SortInPlace).
 		 */
 		template <typename Predicate>
 		[[nodiscard]] constexpr Array Filter(Predicate pred) const {
@@ -862,12 +1511,22 @@ namespace Potato {
 			}
 			return false;
 		}
-		template <typename Compare>
-		[[nodiscard]] constexpr Array Sort(Compare comp) {
-			static_assert(std::is_invocable_r_v<bool, Compare, const_reference>, 
-				"EraseIf: Predicate must be callable with const_reference and return bool");
+		template <typename Compare = std::less<>>
+		[[nodiscard]] constexpr Array Sort(Compare comp = Compare{}) const {
+			static_assert(std::is_invocable_r_v<bool, Compare, const_reference, const_reference>,
+				"Sort: Compare must be callable with two const_references and return bool");
+			Array result(*this);
+			result.SortInPlace(comp);
+			return result;
+		}
+		/* 原地排序 (std::sort, 不稳定), 返回数组本身的引用, 支持链式调用 */
+		template <typename Compare = std::less<>>
+		constexpr Array& SortInPlace(Compare comp = Compare{}) {
+			static_assert(std::is_invocable_r_v<bool, Compare, const_reference, const_reference>,
+				"SortInPlace: Compare must be callable with two const_references and return bool");
+			std::sort(Data(), Data() + Size(), comp);
 			return *this;
-		 }
+		}
 
 		 /**
 		  * @brief: 根据谓词删除元素, 返回数组本身的引用, 支持链式调用
@@ -916,20 +1575,38 @@ namespace Potato {
 		template <typename Ty2>
 		bool IsSequence(const Array<Ty2>& sub) const noexcept;
 
-		template <typename Ty2>
-		Array Intersection(const Array<Ty2>& other) const noexcept{
-
-			return *this;
-		}
-		template <typename Ty2>
-		Array Union(const Array<Ty2>& other) const noexcept{
-
-			return *this;
+		/**
+		 * @brief: 集合运算: 交集 / 并集 / 差集 (*this - other)
+		 * @note: 基于 HashSet, 期望 O(Size() + other.Size()); 结果按元素在 *this (并集中随后是 other)
+		 *     中第一次出现的顺序排列, 重复的元素只保留一个.
+		 *     要求 value_type 可以被 DefaultHash 哈希并支持 operator==, Ty2 可以转换为 value_type
+		 */
+		template <typename Ty2, typename Alloc2>
+			requires std::is_convertible_v<const Ty2&, value_type>
+		[[nodiscard]] Array Intersection(const Array<Ty2, Alloc2>& other) const {
+			const M_HashSetTp lookup = M_MakeHashSet(other);
+			return M_Distinct([&](const_reference item) { return lookup.Contains(item); });
+		}
+		template <typename Ty2, typename Alloc2>
+			requires std::is_convertible_v<const Ty2&, value_type>
+		[[nodiscard]] Array Union(const Array<Ty2, Alloc2>& other) const {
+			M_HashSetTp seen(typename M_HashSetTp::hasher{}, typename M_HashSetTp::key_equal{}, M_GetAllocator());
+			seen.Reserve(Size() + other.Size());
+			Array result(M_GetAllocator());
+			for (const_reference item : *this) {
+				if (seen.Insert(item)) result.Append(item);
+			}
+			for (const auto& item : other) {
+				value_type converted(item);
+				if (seen.Insert(converted)) result.Append(std::move(converted));
+			}
+			return result;
 		}
-		template <typename Ty2>
-		Array Difference(const Array<Ty2>& other) const noexcept{
-
-			return *this;
+		template <typename Ty2, typename Alloc2>
+			requires std::is_convertible_v<const Ty2&, value_type>
+		[[nodiscard]] Array Difference(const Array<Ty2, Alloc2>& other) const {
+			const M_HashSetTp lookup = M_MakeHashSet(other);
+			return M_Distinct([&](const_reference item) { return !lookup.Contains(item); });
 		}
 
 		constexpr iterator Insert(const_iterator position, const value_type& value) {
@@ -1238,19 +1915,36 @@ namespace Potato {
 			auto& allocator = M_GetAllocator();
 			auto& M_Data = this->m_Data.data;
 			
-			pointer new_start = allocator.allocate(capacity);
 			size_type current_size = M_Size();
+			POTATO_TRACE_SCOPE(Reallocate, value_type, current_size, current_size * sizeof(value_type));
+			pointer new_start = allocator.allocate(capacity);
 			
 			M_TryUninitializedMove(M_Data.start, current_size, new_start);
 			
 			if (M_Data.start) {
-				std::destroy(M_Data.start, M_Data.finish);
+				M_DestroyRelocated(M_Data.start, M_Data.finish);
 				allocator.deallocate(M_Data.start, M_Data.end_of_storage - M_Data.start);
 			}
 			
 			M_Data.start = new_start;
 			M_Data.finish = new_start + current_size;
 			M_Data.end_of_storage = new_start + capacity;
+			POTATO_RECORD_GROWTH(M_InstrumentationTag, capacity, current_size, current_size);
+		}
+		/**
+		 * @brief: 不抛异常的 Reserve, 成功时返回新的容量
+		 * @note: 超过 MaxSize 返回 ArrayErrc::LengthError, 分配失败返回 ArrayErrc::BadAlloc,
+		 *     失败时数组保持不变. 元素的拷贝构造抛出的异常仍然会向外传播
+		 */
+		[[nodiscard]] constexpr Core::Expected<size_type, ArrayErrc> TryReserve(size_type capacity) {
+			if (capacity <= Capacity()) return Capacity();
+			if (capacity > M_MaxSize()) return Core::Unexpected{ ArrayErrc::LengthError };
+			try {
+				Reserve(capacity);
+			} catch (const std::bad_alloc&) {
+				return Core::Unexpected{ ArrayErrc::BadAlloc };
+			}
+			return Capacity();
 		}
 		constexpr void Swap(Array& other) noexcept {
 			if (this == &other) return;
@@ -1278,6 +1972,10 @@ namespace Potato {
 		size_type Slack() const noexcept {
 			return Capacity() - Size();
 		}
+		/* 分配器的副本, 与 std::vector::get_allocator 相同 */
+		[[nodiscard]] AllocatorType GetAllocator() const noexcept {
+			return AllocatorType(M_GetAllocator());
+		}
 
 
 		/**
@@ -1306,7 +2004,7 @@ namespace Potato {
 			M_TryUninitializedMove(M_Data.start, current_size, new_start);
 			
 			if (M_Data.start) {
-				std::destroy(M_Data.start, M_Data.finish);
+				M_DestroyRelocated(M_Data.start, M_Data.finish);
 				allocator.deallocate(M_Data.start, M_Data.end_of_storage - M_Data.start);
 			}
 			
@@ -1466,7 +2164,7 @@ namespace Potato {
 
 			this->M_AllocateUninitializedMemory(count);
 			CleanGuard Guard{ this };
-			finish = std::uninitialized_value_construct_n(start, count);
+			finish = MemoryTools::BatchOfZeroConstruction(start, count, allocator);
 			Guard.Release();
 		}
 
@@ -1486,7 +2184,7 @@ namespace Potato {
 
 			this->M_AllocateUninitializedMemory(count);
 			CleanGuard Guard{ this };
-			finish = std::uninitialized_fill_n(start, count, value);
+			finish = MemoryTools::BatchOfFillConstruction(start, count, static_cast<const value_type&>(value), allocator);
 			Guard.Release();
 		}
 
@@ -1496,12 +2194,15 @@ namespace Potato {
 			if (count == 0) [[unlikely]] return;
 
 			M_AllocateUninitializedMemory(count);
-			
-			CleanGuard Guard{ this };
 
 			auto&    M_Data = this->m_Data.data;
+			if constexpr (M_IsTrivialVal && MemoryTools::IsMemcpySourceVal<ForwardIterator, value_type>) {
+				M_Data.finish = MemoryTools::TrivialCopy(M_Data.start, MemoryTools::ToRawPointer(first), count);
+				return;
+			}
+
+			CleanGuard Guard{ this };
 			M_Data.finish = std::uninitialized_copy(first, last, M_Data.start);
-			
 			Guard.Release();
 		}
 
@@ -1536,10 +2237,10 @@ namespace Potato {
 				auto increased_size = new_size - old_size;
 
 				if constexpr (std::is_same_v<ResizeType, ZeroInitTag>) {
-					finish = std::uninitialized_value_construct_n(construct_pos, increased_size);
+					finish = MemoryTools::BatchOfZeroConstruction(construct_pos, increased_size, allocator);
 				}else {
 					// 默认路径: 使用 val 进行 resize
-					finish = std::uninitialized_fill_n(construct_pos, increased_size, value);
+					finish = MemoryTools::BatchOfFillConstruction(construct_pos, increased_size, static_cast<const value_type&>(value), allocator);
 				}
 			}
 		}
@@ -1562,32 +2263,56 @@ namespace Potato {
 
 			const auto old_size = static_cast<size_type>(finish - start);
 			size_type new_capacity = M_CalculateGrowth(new_size);
+			POTATO_TRACE_SCOPE(Reallocate, value_type, old_size, old_size * sizeof(value_type));
 
 			const pointer new_arr = allocator.allocate(new_capacity);
 			const pointer appended_start = new_arr + old_size;
 
+			if constexpr (M_IsTrivialVal && (!std::is_same_v<Ty2, ZeroInitTag> || M_IsTrivialZeroVal)) {
+				if constexpr (std::is_same_v<Ty2, ZeroInitTag>) {
+					MemoryTools::BatchOfZeroConstruction(appended_start, new_size - old_size, allocator);
+				} else {
+					MemoryTools::BatchOfFillConstruction(appended_start, new_size - old_size, static_cast<const value_type&>(value), allocator);
+				}
+				MemoryTools::TrivialRelocate(new_arr, start, old_size);
+				/* start 是成员的引用: 先记下旧缓冲区, 提交新缓冲区之后再释放, 不在释放后读取它 */
+				const pointer old_start = start;
+				const auto old_capacity = static_cast<size_type>(end_of_storage - start);
+				this->M_UpdateData(new_arr, new_size, new_capacity);
+				if (old_start) {
+					allocator.deallocate(old_start, old_capacity);
+				}
+				POTATO_RECORD_GROWTH(M_InstrumentationTag, new_capacity, new_size, old_size);
+				return;
+			}
+
 			ReallocateGuard Guard{ allocator, new_arr, new_capacity, appended_start, appended_start };
 			auto& appended_finish = Guard.constructed_finish;
 			const auto& increased_size = new_size - old_size;
 			assert(increased_size>=0 && "Array::M_Relocate(const size_type, const Ty2&) Runtime Error:: new_size must be greater than old_size - M_Relocate 默认 new size >= old size");
 
 			if constexpr (std::is_same_v<Ty2, ZeroInitTag>) {
-				appended_finish = std::uninitialized_value_construct_n(appended_start, increased_size);
+				appended_finish = MemoryTools::BatchOfZeroConstruction(appended_start, increased_size, allocator);
 			}else {
-				appended_finish = std::uninitialized_fill_n(appended_start, increased_size, value);
+				appended_finish = MemoryTools::BatchOfFillConstruction(appended_start, increased_size, static_cast<const value_type&>(value), allocator);
 			}
 
 			// 搬运旧数据: (old_start, count, new_start)
 			M_TryUninitializedMove(start, old_size, new_arr);
 			
-			// 重要: 提交之前必须销毁旧对象
-			if (start) {
-				std::destroy_n(start, old_size);
-				allocator.deallocate(start, static_cast<size_type>(end_of_storage - start));
+			// 重要: 提交之前必须销毁旧对象 (可重定位的类型已经 "搬走", 不再析构)
+			const pointer old_start = start;
+			const auto old_capacity = static_cast<size_type>(end_of_storage - start);
+			if (old_start) {
+				M_DestroyRelocated(old_start, old_start + old_size);
 			}
 
 			this->M_UpdateData(new_arr, new_size, new_capacity);
 			Guard.Release();
+			if (old_start) {
+				allocator.deallocate(old_start, old_capacity);
+			}
+			POTATO_RECORD_GROWTH(M_InstrumentationTag, new_capacity, new_size, old_size);
 		}
 
 		constexpr void M_UpdateData(const pointer first, const size_type size, const size_type capacity) noexcept {
@@ -1620,6 +2345,20 @@ namespace Potato {
 			return new_capacity;
 		}
 
+		/* 越界 (包括 Find 返回的 size_type(-1)) 时返回空的 Optional, 供 Try* 与 FindFirst 等使用 */
+		[[nodiscard]] constexpr Core::Optional<size_type> M_ToIndex(const size_type index) const noexcept {
+			if (index >= Size()) return Core::nullopt;
+			return index;
+		}
+		[[nodiscard]] constexpr Core::Optional<reference> M_TryGet(const size_type index) noexcept {
+			if (index >= Size()) return Core::nullopt;
+			return m_Data.data.start[index];
+		}
+		[[nodiscard]] constexpr Core::Optional<const_reference> M_TryGet(const size_type index) const noexcept {
+			if (index >= Size()) return Core::nullopt;
+			return m_Data.data.start[index];
+		}
+
 		/**
 		 * @berief 当前实现与平台限制下, 调用者理论上能容纳的最大元素个数
 		 */
@@ -1742,6 +2481,56 @@ namespace Potato {
 			return *M_Emplace(cend(), 1, std::forward<Args>(args)...);
 		}
 
+		/**
+		 * @brief 在末尾追加 [first, first + count) 区间的元素
+		 * @note: 需要扩容时先在新内存中构造追加的元素, 再搬运旧数据,
+		 *     这样即使 first 指向数组自身 (Aliasing) 也是安全的.
+		 */
+		template <typename ForwardIterator>
+		constexpr void M_AppendRange(ForwardIterator first, const size_type count) {
+			if (count == 0) [[unlikely]] return;
+			POTATO_TRACE_SCOPE(BulkInsert, value_type, count, count * sizeof(value_type));
+
+			auto& allocator = M_GetAllocator();
+			auto& M_Data    = this->m_Data.data;
+
+			constexpr bool bMemcpy = M_IsTrivialVal && MemoryTools::IsMemcpySourceVal<ForwardIterator, value_type>;
+
+			if (static_cast<size_type>(M_Data.end_of_storage - M_Data.finish) >= count) {
+				if constexpr (bMemcpy) {
+					M_Data.finish = MemoryTools::TrivialCopy(M_Data.finish, MemoryTools::ToRawPointer(first), count);
+				} else {
+					M_Data.finish = std::uninitialized_copy_n(first, count, M_Data.finish);
+				}
+				return;
+			}
+
+			const size_type old_size     = M_Size();
+			const size_type new_capacity = M_CalculateGrowth(old_size + count);
+			POTATO_TRACE_SCOPE(Reallocate, value_type, old_size, old_size * sizeof(value_type));
+			pointer new_start            = allocator.allocate(new_capacity);
+			pointer appended_start       = new_start + old_size;
+
+			if constexpr (bMemcpy) {
+				MemoryTools::TrivialCopy(appended_start, MemoryTools::ToRawPointer(first), count);
+				MemoryTools::TrivialRelocate(new_start, M_Data.start, old_size);
+			} else {
+				ReallocateGuard Guard{ allocator, new_start, new_capacity, appended_start, appended_start };
+				Guard.constructed_finish = std::uninitialized_copy_n(first, count, appended_start);
+				M_TryUninitializedMove(M_Data.start, old_size, new_start);
+				Guard.Release();
+			}
+
+			if (M_Data.start) {
+				M_DestroyRelocated(M_Data.start, M_Data.finish);
+				allocator.deallocate(M_Data.start, static_cast<size_type>(M_Data.end_of_storage - M_Data.start));
+			}
+			M_Data.start          = new_start;
+			M_Data.finish         = new_start + old_size + count;
+			M_Data.end_of_storage = new_start + new_capacity;
+			POTATO_RECORD_GROWTH(M_InstrumentationTag, new_capacity, old_size + count, old_size);
+		}
+
 		/**
 		 * @brief: 重新分配内存并在指定位置插入任意多空洞
 		 * @param pos: 插入位置
@@ -1767,12 +2556,27 @@ namespace Potato {
 
 			const size_type old_size     = M_Size();
 
+			/* count == 0 时下面的 move_backward 会把 [pos, finish) 自我移动赋值, 直接返回 */
+			if (count == 0) [[unlikely]] return pos;
+			/* 追踪钩子是外部调用, 编译器会认为它可能改写 M_Data; 先在局部变量里决定走哪条路径 */
+			pointer old_finish   = M_Data.finish;
+			const bool bInPlace  = static_cast<size_type>(M_Data.end_of_storage - old_finish) >= count;
+			POTATO_TRACE_SCOPE(BulkInsert, value_type, count, static_cast<size_type>(old_finish - pos) * sizeof(value_type));
+
 			// 1. Fast Path: 不需要扩容
 			//    在现有 capacity 内移动元素，并确保 Hole 区域是 Valid Object (Default Constructed)
-			if (static_cast<size_type>(M_Data.end_of_storage - M_Data.finish) >= count) {
-				pointer old_finish = M_Data.finish;
+			if (bInPlace) {
 				const size_type elems_after = old_finish - pos;
 
+				if constexpr (M_IsTrivialVal) {
+					MemoryTools::TrivialMove(pos + count, pos, elems_after);
+					if (is_zero_construct) {
+						M_TrivialZeroConstruct(pos, count);
+					}
+					M_Data.finish += count;
+					return pos;
+				}
+
 				if (pos == old_finish) {
 					if (is_zero_construct) {
 						M_Data.finish = std::uninitialized_value_construct_n(old_finish, count);
@@ -1810,24 +2614,35 @@ namespace Potato {
 			const size_type new_capacity = M_CalculateGrowth(old_size + count);
 			const size_type forward_size = static_cast<size_type>(pos - M_Data.start);
 			const size_type backward_size = static_cast<size_type>(M_Data.finish - pos);
+			POTATO_TRACE_SCOPE(Reallocate, value_type, old_size, old_size * sizeof(value_type));
 
 			pointer new_start = allocator.allocate(new_capacity);
 			pointer new_hole_start = new_start + forward_size;
 			pointer new_backward_start = new_hole_start + count;
 			pointer new_finish = new_backward_start + backward_size;
 
-			ReallocateGuard Guard{ allocator, new_start, new_capacity, new_start, new_start };
-			
-			if constexpr (TypeTools::IsSimpleAllocVal<M_AllocatorType> && std::is_trivially_copyable_v<ElementType>) {
-				if (forward_size > 0) std::memcpy(new_start, M_Data.start, forward_size * sizeof(ElementType));
-				if (backward_size > 0) std::memcpy(new_backward_start, pos, backward_size * sizeof(ElementType));
+			if constexpr (M_IsTrivialVal) {
+				MemoryTools::TrivialRelocate(new_start, M_Data.start, forward_size);
+				MemoryTools::TrivialRelocate(new_backward_start, pos, backward_size);
 				
 				if (is_zero_construct) {
-					std::memset(new_hole_start, 0, count * sizeof(ElementType));
+					M_TrivialZeroConstruct(new_hole_start, count);
 				}
 				// 即使不 zero construct，对于 trivial 类型，内存已经是分配状态，逻辑上可以说既是 initialized 也是 uninitialized
+			} else if constexpr (M_IsRelocatableVal) {
+				// 先构造可能抛异常的 Gap, 成功之后再 memcpy 两侧; 否则 Guard 会析构 memcpy 出来的副本, 与旧元素重复析构
+				ReallocateGuard Guard{ allocator, new_start, new_capacity, new_hole_start, new_hole_start };
+				if (is_zero_construct) {
+					Guard.constructed_finish = std::uninitialized_value_construct_n(new_hole_start, count);
+				} else {
+					Guard.constructed_finish = std::uninitialized_default_construct_n(new_hole_start, count);
+				}
+				M_TryUninitializedMove(M_Data.start, forward_size, new_start);
+				M_TryUninitializedMove(pos, backward_size, new_backward_start);
 				Guard.Release();
 			} else {
+				ReallocateGuard Guard{ allocator, new_start, new_capacity, new_start, new_start };
+
 				// 1. Move 前半部分
 				M_TryUninitializedMove(M_Data.start, forward_size, new_start);
 				Guard.constructed_finish = new_hole_start;
@@ -1847,28 +2662,79 @@ namespace Potato {
 			}
 
 			if (M_Data.start) {
-				std::destroy(M_Data.start, M_Data.finish);
+				M_DestroyRelocated(M_Data.start, M_Data.finish);
 				allocator.deallocate(M_Data.start, static_cast<size_type>(M_Data.end_of_storage - M_Data.start));
 			}
 
 			M_Data.start          = new_start;
 			M_Data.finish         = new_finish;
 			M_Data.end_of_storage = new_start + new_capacity;
+			POTATO_RECORD_GROWTH(M_InstrumentationTag, new_capacity, old_size + count, old_size);
 
 			return new_hole_start;
 		}
 
+		/* 平凡可拷贝但值初始化不等价于全零字节的类型 (如成员指针) 仍然走值初始化 */
+		pointer M_TrivialZeroConstruct(pointer first, size_type count) {
+			if constexpr (M_IsTrivialZeroVal) {
+				return MemoryTools::TrivialZero(first, count);
+			} else {
+				return std::uninitialized_value_construct_n(first, count);
+			}
+		}
+
+		/* 可重定位的类型直接 memcpy, 之后旧区间必须交给 M_DestroyRelocated 而不是 std::destroy */
 		pointer M_TryUninitializedMove(pointer old_start, size_type count, pointer new_start) {
-			if constexpr (std::is_nothrow_move_constructible_v<ElementType> || !std::is_copy_constructible_v<ElementType>) {
+			if constexpr (M_IsRelocatableVal) {
+				return MemoryTools::TrivialRelocate(new_start, old_start, count);
+			} else if constexpr (std::is_nothrow_move_constructible_v<ElementType> || !std::is_copy_constructible_v<ElementType>) {
 				return std::uninitialized_move(old_start, old_start + count, new_start);
 			} else {
 				return std::uninitialized_copy(old_start, old_start + count, new_start);
 			}
 		}
 		
+		/* 扩容搬运之后的旧元素: 可重定位的类型已经被 memcpy 走, 不能再析构 */
+		constexpr void M_DestroyRelocated(pointer first, pointer last) noexcept {
+			if constexpr (!M_IsRelocatableVal) {
+				std::destroy(first, last);
+			}
+		}
+
+		using M_HashSetTp = HashSet<value_type, DefaultHash<value_type>, std::equal_to<>, AllocatorType>;
+
+		template <typename Ty2, typename Alloc2>
+		[[nodiscard]] M_HashSetTp M_MakeHashSet(const Array<Ty2, Alloc2>& items) const {
+			M_HashSetTp result(typename M_HashSetTp::hasher{}, typename M_HashSetTp::key_equal{}, M_GetAllocator());
+			result.Reserve(items.Size());
+			for (const auto& item : items) result.Insert(value_type(item));
+			return result;
+		}
+
+		/* *this 中满足 pred 的元素, 重复的只保留第一个 */
+		template <typename Predicate>
+		[[nodiscard]] Array M_Distinct(Predicate pred) const {
+			M_HashSetTp seen(typename M_HashSetTp::hasher{}, typename M_HashSetTp::key_equal{}, M_GetAllocator());
+			Array result(M_GetAllocator());
+			for (const_reference item : *this) {
+				if (pred(item) && seen.Insert(item)) result.Append(item);
+			}
+			return result;
+		}
+
 		pointer M_EraseElement(pointer pos, const size_t count) {
 			auto& M_Data = this->m_Data.data;
 
+			/* count == 0 时下面的 std::move 会把 [pos, finish) 自我移动赋值 (std::string 会被清空), 直接返回 */
+			if (count == 0) [[unlikely]] return pos;
+			POTATO_TRACE_SCOPE(BulkErase, value_type, count, static_cast<size_type>(M_Data.finish - (pos + count)) * sizeof(value_type));
+
+			if constexpr (M_IsTrivialVal) {
+				MemoryTools::TrivialMove(pos, pos + count, static_cast<size_type>(M_Data.finish - (pos + count)));
+				M_Data.finish -= count;
+				return pos;
+			}
+
 			pointer new_finish = std::move(pos + count, M_Data.finish, pos);
 
 			std::destroy(new_finish, M_Data.finish);
@@ -1880,6 +2746,66 @@ namespace Potato {
 		M_RealValueType m_Data;
 	};
 
+	/**
+	 * @brief: 有序数组的只读查找索引, 由 Array::BuildSearchIndex() 构建
+	 * @note: 把元素按 Eytzinger (BFS) 顺序重新排列: 查找时访问的前几层集中在开头几条缓存行里,
+	 *     而且每一步都可以提前预取 4 层之后的子孙, 对大数组的重复查找比普通二分快得多.
+	 *     返回的下标都是原数组中的下标; 原数组修改之后索引失效, 需要重新构建.
+	 */
+	template <typename Ty, typename Compare = std::less<>, typename Allocator = std::allocator<Ty>>
+	class SearchIndex {
+		using M_RankAllocatorTp = typename std::allocator_traits<Allocator>::template rebind_alloc<std::size_t>;
+	public:
+		using value_type     = Ty;
+		using size_type      = std::size_t;
+		using allocator_type = Allocator;
+
+		SearchIndex() = default;
+		SearchIndex(const Ty* sorted, const size_type count, Compare comp = Compare{}, const Allocator& allocator = Allocator())
+			: m_Keys(allocator), m_Ranks(M_RankAllocatorTp(allocator)), m_Compare(comp)
+		{
+			if (count == 0) return;
+			m_Ranks.Resize(count + 1);
+			SearchTools::EytzingerRanks(0, m_Ranks.Data(), 1, count);
+			/* 按节点顺序拷贝构造 (走区间追加, 不经过默认构造的空洞); 不使用的 m_Keys[0] 复制第一个元素占位, 避免要求 Ty 可默认构造 */
+			m_Keys.Reserve(count + 1);
+			m_Keys.Append(sorted, size_type{ 1 });
+			for (size_type node = 1; node <= count; ++node) {
+				m_Keys.Append(sorted + m_Ranks[node], size_type{ 1 });
+			}
+		}
+
+		[[nodiscard]] size_type Size() const noexcept {
+			return m_Keys.Size() == 0 ? 0 : m_Keys.Size() - 1;
+		}
+		[[nodiscard]] allocator_type GetAllocator() const noexcept { return m_Keys.GetAllocator(); }
+
+		template <typename Key>
+		[[nodiscard]] Core::Optional<size_type> LowerBound(const Key& key) const {
+			const std::size_t node = M_LowerBoundNode(key);
+			if (node == 0) return Core::nullopt;
+			return m_Ranks[node];
+		}
+
+		template <typename Key>
+		[[nodiscard]] Core::Optional<size_type> BinarySearch(const Key& key) const {
+			const std::size_t node = M_LowerBoundNode(key);
+			if (node == 0 || m_Compare(key, m_Keys[node])) return Core::nullopt;
+			return m_Ranks[node];
+		}
+
+	private:
+		template <typename Key>
+		[[nodiscard]] std::size_t M_LowerBoundNode(const Key& key) const {
+			if (Size() == 0) return 0;
+			return SearchTools::EytzingerLowerBound(m_Keys.Data(), Size(), key, m_Compare);
+		}
+
+		Array<Ty, Allocator> m_Keys;                // 1-based, m_Keys[0] 不使用
+		Array<size_type, M_RankAllocatorTp> m_Ranks; // m_Ranks[k]: m_Keys[k] 在原数组中的下标
+		[[no_unique_address]] Compare m_Compare;
+	};
+
 }
 
 /**
@@ -1972,5 +2898,7 @@ auto operator<=>(const Potato::Array<T, Alloc>& lhs, const Potato::Array<T, Allo
 // };
 	
 
+/* HashMap.h 依赖完整的 Array, 而 Array 的集合运算依赖 HashSet, 所以放在最后 */
+#include "HashMap.h"
 
 #endif // ARRAY_HPP
@@ -0,0 +1,368 @@
+#ifndef BITARRAY_HPP
+#define BITARRAY_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include "Array.h"
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#  define POTATO_HAVE_AVX2 1
+#endif
+
+/**
+ * @brief: 按位压缩的布尔数组 Potato::BitArray, 每个元素只占 1 位
+ * @note: 1. 位保存在 Potato::Array<std::uint64_t> 中, 第 i 位位于第 i / 64 个字的第 i % 64 位.
+ *           最后一个字中超出 Size() 的位始终为 0, 所以 Count / Find / == 都可以按整字处理, 不需要特判末尾.
+ *        2. Count 使用 popcount, Find 使用 countr_zero / countl_zero, 每次处理 64 位;
+ *           编译时开启 -mpopcnt / -mbmi (或 -march=native) 时它们分别对应一条 popcnt / tzcnt 指令.
+ *        3. And / Or / Xor / AndNot 在开启 AVX2 时每次处理 256 位, 否则按 64 位字处理.
+ *           两个 BitArray 长度不同时, 较短的一方视为用 0 补齐, 结果的长度始终是 *this 的长度.
+ *        4. 没有特化 Potato::Array<bool>: 按位保存无法提供 bool& 与连续的 bool*,
+ *           这会破坏 Array 的接口约定 (std::vector<bool> 的教训). 需要按位保存时直接使用 BitArray.
+ */
+namespace Potato {
+	namespace BitTools {
+		using Word = std::uint64_t;
+		inline constexpr std::size_t WordBits = 64;
+
+		enum class BitOp : std::uint8_t {
+			And,
+			Or,
+			Xor,
+			AndNot, // dest & ~src
+		};
+
+		[[nodiscard]] constexpr std::size_t WordsFor(const std::size_t bits) noexcept {
+			return (bits + WordBits - 1) / WordBits;
+		}
+		/* 最后一个字中有效位的掩码, bits 是 64 的倍数时为全 1 */
+		[[nodiscard]] constexpr Word TailMask(const std::size_t bits) noexcept {
+			const std::size_t rest = bits % WordBits;
+			return rest == 0 ? ~Word{ 0 } : (Word{ 1 } << rest) - 1;
+		}
+
+		template <BitOp Op>
+		[[nodiscard]] constexpr Word Apply(const Word dest, const Word src) noexcept {
+			if constexpr (Op == BitOp::And) return dest & src;
+			else if constexpr (Op == BitOp::Or) return dest | src;
+			else if constexpr (Op == BitOp::Xor) return dest ^ src;
+			else return dest & ~src;
+		}
+
+#if defined(POTATO_HAVE_AVX2)
+		template <BitOp Op>
+		[[nodiscard]] inline __m256i Apply(const __m256i dest, const __m256i src) noexcept {
+			if constexpr (Op == BitOp::And) return _mm256_and_si256(dest, src);
+			else if constexpr (Op == BitOp::Or) return _mm256_or_si256(dest, src);
+			else if constexpr (Op == BitOp::Xor) return _mm256_xor_si256(dest, src);
+			else return _mm256_andnot_si256(src, dest); // andnot(a, b) = ~a & b
+		}
+#endif
+
+		/* dest[i] = dest[i] op src[i], i ∈ [0, count) */
+		template <BitOp Op>
+		inline void Transform(Word* dest, const Word* src, const std::size_t count) noexcept {
+			std::size_t i = 0;
+#if defined(POTATO_HAVE_AVX2)
+			for (; i + 4 <= count; i += 4) {
+				const __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dest + i));
+				const __m256i rhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), Apply<Op>(lhs, rhs));
+			}
+#endif
+			for (; i < count; ++i) {
+				dest[i] = Apply<Op>(dest[i], src[i]);
+			}
+		}
+
+		/* [words, words + count) 中 1 的个数 */
+		[[nodiscard]] inline std::size_t PopCount(const Word* words, const std::size_t count) noexcept {
+			std::size_t i = 0;
+			std::size_t total = 0;
+#if defined(POTATO_HAVE_AVX2)
+			/**
+			 * 没有 AVX-512 VPOPCNTQ 时的按半字节查表法 (Mula): pshufb 查出每个半字节的 1 的个数,
+			 * 再用 sad_epu8 把 32 个字节的计数累加到 4 个 64 位的和中
+			 */
+			const __m256i lookup = _mm256_setr_epi8(
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+			const __m256i low_mask = _mm256_set1_epi8(0x0f);
+			__m256i sums = _mm256_setzero_si256();
+			for (; i + 4 <= count; i += 4) {
+				const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+				const __m256i low   = _mm256_shuffle_epi8(lookup, _mm256_and_si256(value, low_mask));
+				const __m256i high  = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(value, 4), low_mask));
+				sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+			}
+			total += static_cast<std::size_t>(_mm256_extract_epi64(sums, 0)) + static_cast<std::size_t>(_mm256_extract_epi64(sums, 1))
+				+ static_cast<std::size_t>(_mm256_extract_epi64(sums, 2)) + static_cast<std::size_t>(_mm256_extract_epi64(sums, 3));
+#endif
+			for (; i < count; ++i) {
+				total += static_cast<std::size_t>(std::popcount(words[i]));
+			}
+			return total;
+		}
+	}
+
+	class BitArray {
+	public:
+		using size_type  = std::size_t;
+		using value_type = bool;
+		using Word       = BitTools::Word;
+		using WordArray  = Array<Word>;
+		static constexpr size_type WordBits = BitTools::WordBits;
+		static constexpr size_type npos     = static_cast<size_type>(-1);
+
+		/* 非 const 的 operator[] 返回的代理, 可以像 bool& 一样读写 */
+		class Reference {
+		public:
+			Reference(Word& word, const Word mask) noexcept : m_Word(word), m_Mask(mask) {}
+			Reference& operator=(const bool value) noexcept {
+				m_Word = value ? (m_Word | m_Mask) : (m_Word & ~m_Mask);
+				return *this;
+			}
+			Reference& operator=(const Reference& other) noexcept { return *this = static_cast<bool>(other); }
+			[[nodiscard]] operator bool() const noexcept { return (m_Word & m_Mask) != 0; }
+			void Flip() noexcept { m_Word ^= m_Mask; }
+
+		private:
+			Word& m_Word;
+			Word m_Mask;
+		};
+
+		BitArray() = default;
+		explicit BitArray(const size_type count, const bool value = false) {
+			Resize(count, value);
+		}
+		BitArray(std::initializer_list<bool> list) {
+			Reserve(list.size());
+			for (const bool value : list) Append(value);
+		}
+
+	public:
+		[[nodiscard]] size_type Size() const noexcept { return m_Size; }
+		[[nodiscard]] bool IsEmpty() const noexcept { return m_Size == 0; }
+		[[nodiscard]] size_type Capacity() const noexcept { return m_Words.Capacity() * WordBits; }
+		[[nodiscard]] size_type WordCount() const noexcept { return m_Words.Size(); }
+		/* 底层的字数组, 末尾超出 Size() 的位为 0 */
+		[[nodiscard]] const Word* Data() const noexcept { return m_Words.Data(); }
+		[[nodiscard]] const WordArray& Words() const noexcept { return m_Words; }
+
+		void Reserve(const size_type bits) { m_Words.Reserve(BitTools::WordsFor(bits)); }
+		void ShrinkToFit() { m_Words.ShrinkToFit(); }
+		void Clear() noexcept {
+			m_Words.Clear();
+			m_Size = 0;
+		}
+		void Swap(BitArray& other) noexcept {
+			m_Words.Swap(other.m_Words);
+			std::swap(m_Size, other.m_Size);
+		}
+
+		// @brief: 元素访问 API
+		[[nodiscard]] bool operator[](const size_type index) const noexcept {
+			return (m_Words.Data()[index / WordBits] >> (index % WordBits)) & 1;
+		}
+		[[nodiscard]] Reference operator[](const size_type index) noexcept {
+			return Reference(m_Words[index / WordBits], Word{ 1 } << (index % WordBits));
+		}
+		[[nodiscard]] bool At(const size_type index) const {
+			if (index >= m_Size) {
+				throw std::out_of_range("BitArray::At: Index out of range");
+			}
+			return (*this)[index];
+		}
+		[[nodiscard]] bool Front() const noexcept { return (*this)[0]; }
+		[[nodiscard]] bool Back() const noexcept { return (*this)[m_Size - 1]; }
+
+		BitArray& Set(const size_type index, const bool value = true) noexcept {
+			(*this)[index] = value;
+			return *this;
+		}
+		BitArray& Reset(const size_type index) noexcept { return Set(index, false); }
+		BitArray& Flip(const size_type index) noexcept {
+			m_Words[index / WordBits] ^= Word{ 1 } << (index % WordBits);
+			return *this;
+		}
+		/* 所有位置为 value */
+		BitArray& Fill(const bool value) noexcept {
+			const Word word = value ? ~Word{ 0 } : Word{ 0 };
+			for (Word& item : m_Words) item = word;
+			M_ClearTail();
+			return *this;
+		}
+		/* 所有位取反 */
+		BitArray& Flip() noexcept {
+			for (Word& item : m_Words) item = ~item;
+			M_ClearTail();
+			return *this;
+		}
+
+		// @brief: 修改大小的 API
+		BitArray& Append(const bool value) {
+			if (m_Size % WordBits == 0) {
+				m_Words.Append(Word{ 0 });
+			}
+			m_Words.Back() |= Word{ value } << (m_Size % WordBits);
+			++m_Size;
+			return *this;
+		}
+		/* 追加另一个 BitArray; 当前长度是 64 的倍数时直接追加整字, 否则每个字拆成两半移位合并 */
+		BitArray& Append(const BitArray& other) {
+			if (&other == this) {
+				const BitArray copy(other);
+				return Append(copy);
+			}
+			const size_type offset     = m_Size % WordBits;
+			const size_type first_word = m_Size / WordBits;
+			const size_type new_size   = m_Size + other.m_Size;
+			m_Words.Resize(BitTools::WordsFor(new_size));
+			Word* words       = m_Words.Data();
+			const Word* input = other.m_Words.Data();
+			for (size_type i = 0; i < other.m_Words.Size(); ++i) {
+				words[first_word + i] |= input[i] << offset;
+				if (offset != 0 && first_word + i + 1 < m_Words.Size()) {
+					words[first_word + i + 1] |= input[i] >> (WordBits - offset);
+				}
+			}
+			m_Size = new_size;
+			return *this;
+		}
+		void Pop() noexcept {
+			--m_Size;
+			if (m_Size % WordBits == 0) {
+				m_Words.Pop();
+			} else {
+				M_ClearTail();
+			}
+		}
+		/* 新增的位置为 value */
+		void Resize(const size_type count, const bool value = false) {
+			if (count <= m_Size) {
+				m_Words.Resize(BitTools::WordsFor(count));
+				m_Size = count;
+				M_ClearTail();
+				return;
+			}
+			if (value && m_Size % WordBits != 0) {
+				m_Words.Back() |= ~BitTools::TailMask(m_Size);
+			}
+			m_Words.Resize(BitTools::WordsFor(count), value ? ~Word{ 0 } : Word{ 0 });
+			m_Size = count;
+			M_ClearTail();
+		}
+
+		// @brief: 查找与统计 API, 都按 64 位字处理
+		[[nodiscard]] size_type Count() const noexcept {
+			return BitTools::PopCount(m_Words.Data(), m_Words.Size());
+		}
+		[[nodiscard]] size_type Count(const bool value) const noexcept {
+			return value ? Count() : m_Size - Count();
+		}
+		[[nodiscard]] bool All() const noexcept { return Count() == m_Size; }
+		[[nodiscard]] bool Any() const noexcept { return Find(true) != npos; }
+		[[nodiscard]] bool None() const noexcept { return !Any(); }
+		[[nodiscard]] bool IsContain(const bool value) const noexcept { return Find(value) != npos; }
+
+		/* 从 start 开始第一个值为 value 的位置, 找不到时返回 npos (与 Array::Find 相同) */
+		[[nodiscard]] size_type Find(const bool value, const size_type start = 0) const noexcept {
+			if (start >= m_Size) return npos;
+			const Word invert = value ? Word{ 0 } : ~Word{ 0 };
+			const Word* words = m_Words.Data();
+			size_type index = start / WordBits;
+			Word word = (words[index] ^ invert) & (~Word{ 0 } << (start % WordBits));
+			while (word == 0) {
+				if (++index == m_Words.Size()) return npos;
+				word = words[index] ^ invert;
+			}
+			const size_type result = index * WordBits + static_cast<size_type>(std::countr_zero(word));
+			return result < m_Size ? result : npos; // 查找 false 时, 末尾补齐的 0 取反后为 1
+		}
+		[[nodiscard]] Core::Optional<size_type> FindFirst(const bool value) const noexcept {
+			return M_ToIndex(Find(value));
+		}
+		[[nodiscard]] Core::Optional<size_type> FindLast(const bool value) const noexcept {
+			if (m_Size == 0) return Core::nullopt;
+			const Word invert = value ? Word{ 0 } : ~Word{ 0 };
+			const Word* words = m_Words.Data();
+			size_type index = m_Words.Size() - 1;
+			Word word = (words[index] ^ invert) & BitTools::TailMask(m_Size);
+			while (word == 0) {
+				if (index-- == 0) return Core::nullopt;
+				word = words[index] ^ invert;
+			}
+			return index * WordBits + (WordBits - 1 - static_cast<size_type>(std::countl_zero(word)));
+		}
+
+		/**
+		 * @brief: 依次以下标调用 func, 只访问值为 true 的位
+		 * @note: 每个字用 countr_zero 取最低位再清除, 代价与 1 的个数成正比, 适合稀疏的可见性掩码
+		 */
+		template <typename Function>
+		void ForEachSet(Function func) const {
+			const Word* words = m_Words.Data();
+			for (size_type index = 0; index < m_Words.Size(); ++index) {
+				for (Word word = words[index]; word != 0; word &= word - 1) {
+					func(index * WordBits + static_cast<size_type>(std::countr_zero(word)));
+				}
+			}
+		}
+
+		// @brief: 按位逻辑运算, 原地修改并返回 *this; 较短的一方视为用 0 补齐
+		BitArray& And(const BitArray& other) noexcept {
+			const size_type common = M_CommonWords(other);
+			BitTools::Transform<BitTools::BitOp::And>(m_Words.Data(), other.m_Words.Data(), common);
+			for (size_type i = common; i < m_Words.Size(); ++i) m_Words[i] = 0;
+			M_ClearTail();
+			return *this;
+		}
+		BitArray& Or(const BitArray& other) noexcept { return M_Transform<BitTools::BitOp::Or>(other); }
+		BitArray& Xor(const BitArray& other) noexcept { return M_Transform<BitTools::BitOp::Xor>(other); }
+		BitArray& AndNot(const BitArray& other) noexcept { return M_Transform<BitTools::BitOp::AndNot>(other); }
+
+		BitArray& operator&=(const BitArray& other) noexcept { return And(other); }
+		BitArray& operator|=(const BitArray& other) noexcept { return Or(other); }
+		BitArray& operator^=(const BitArray& other) noexcept { return Xor(other); }
+		[[nodiscard]] friend BitArray operator&(BitArray lhs, const BitArray& rhs) { return std::move(lhs.And(rhs)); }
+		[[nodiscard]] friend BitArray operator|(BitArray lhs, const BitArray& rhs) { return std::move(lhs.Or(rhs)); }
+		[[nodiscard]] friend BitArray operator^(BitArray lhs, const BitArray& rhs) { return std::move(lhs.Xor(rhs)); }
+		[[nodiscard]] friend BitArray operator~(BitArray value) { return std::move(value.Flip()); }
+
+		[[nodiscard]] friend bool operator==(const BitArray& lhs, const BitArray& rhs) noexcept {
+			return lhs.m_Size == rhs.m_Size && lhs.m_Words == rhs.m_Words;
+		}
+
+	private:
+		[[nodiscard]] static Core::Optional<size_type> M_ToIndex(const size_type index) noexcept {
+			if (index == npos) return Core::nullopt;
+			return index;
+		}
+		[[nodiscard]] size_type M_CommonWords(const BitArray& other) const noexcept {
+			return m_Words.Size() < other.m_Words.Size() ? m_Words.Size() : other.m_Words.Size();
+		}
+		/* Or / Xor / AndNot 与 0 运算不改变原值, 只需处理公共部分 */
+		template <BitTools::BitOp Op>
+		BitArray& M_Transform(const BitArray& other) noexcept {
+			BitTools::Transform<Op>(m_Words.Data(), other.m_Words.Data(), M_CommonWords(other));
+			M_ClearTail();
+			return *this;
+		}
+		/* 维持 "超出 Size() 的位为 0" 的不变量 */
+		void M_ClearTail() noexcept {
+			if (!m_Words.IsEmpty()) {
+				m_Words.Back() &= BitTools::TailMask(m_Size);
+			}
+		}
+
+		WordArray m_Words;
+		size_type m_Size{ 0 };
+	};
+}
+
+#endif // BITARRAY_HPP
@@ -0,0 +1,159 @@
+#ifndef CAPACITY_HINT_HPP
+#define CAPACITY_HINT_HPP
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief: 按调用点学习容器的最终大小, 之后的实例在构造时直接 Reserve, 跳过 1→2→3→4→6... 的扩容阶梯
+ * @note: 用法:
+ * 		Potato::Array<Token> tokens;
+ * 		Potato::ScopedCapacityHint hint(tokens, POTATO_CAPACITY_HINT("ParseTokens"));
+ * 		... 填充 tokens ...
+ * 		// hint 析构时记录 tokens.Size()
+ *
+ * 		每个调用点一个静态的 CapacityHint, 内部是无锁的对数直方图 (每个 2 的幂区间再分 4 档, 误差 < 25%),
+ * 		建议容量取 p90 所在档位的上界. 样本不足 MinSamples 之前使用构造时给出的基线.
+ * 		WriteCapacityHints() 把学到的结果输出为 C++ 常量, 可以直接作为基线写回代码:
+ * 		POTATO_CAPACITY_HINT("ParseTokens", ParseTokens)
+ */
+namespace Potato {
+	class CapacityHint {
+	public:
+		static constexpr std::size_t BucketCount = 256;
+		static constexpr std::uint64_t MinSamples = 8;
+		static constexpr double DefaultQuantile = 0.9;
+
+		CapacityHint(const char* name, const char* file, const int line, const std::size_t baseline = 0) noexcept
+			: m_Name(name), m_File(file), m_Line(line), m_Suggested(baseline)
+		{
+			auto& head = Head();
+			m_Next = head.load(std::memory_order_relaxed);
+			while (!head.compare_exchange_weak(m_Next, this, std::memory_order_release, std::memory_order_relaxed)) {}
+		}
+		CapacityHint(const CapacityHint&) = delete;
+		CapacityHint& operator=(const CapacityHint&) = delete;
+
+		/* 0..7 各占一档; 之后每个 [2^e, 2^(e+1)) 按最高的两位之后再分 4 档 */
+		[[nodiscard]] static constexpr std::size_t BucketOf(const std::uint64_t size) noexcept {
+			if (size < 8) return static_cast<std::size_t>(size);
+			const int exponent = std::bit_width(size) - 1;
+			const auto sub = static_cast<std::size_t>((size >> (exponent - 2)) & 3);
+			return 8 + static_cast<std::size_t>(exponent - 3) * 4 + sub;
+		}
+		/* 该档位能容纳的最大大小 */
+		[[nodiscard]] static constexpr std::uint64_t BucketUpperBound(const std::size_t bucket) noexcept {
+			if (bucket < 8) return bucket;
+			const std::size_t exponent = (bucket - 8) / 4 + 3;
+			const std::uint64_t sub = (bucket - 8) % 4;
+			const std::uint64_t next = (4 + sub + 1) << (exponent - 2);
+			return next == 0 ? UINT64_MAX : next - 1;
+		}
+
+		void Record(const std::size_t size) noexcept {
+			m_Buckets[BucketOf(size)].fetch_add(1, std::memory_order_relaxed);
+			const std::uint64_t samples = m_Samples.fetch_add(1, std::memory_order_relaxed) + 1;
+			/* 每 MinSamples 个样本重新计算一次, 避免每次析构都扫描整个直方图 */
+			if (samples % MinSamples == 0) {
+				m_Suggested.store(static_cast<std::size_t>(Quantile(DefaultQuantile)), std::memory_order_relaxed);
+			}
+		}
+
+		/* 建议预留的容量: 样本足够时是 p90, 否则是基线 */
+		[[nodiscard]] std::size_t Suggest() const noexcept {
+			return m_Suggested.load(std::memory_order_relaxed);
+		}
+
+		/* 直方图给出的分位数 (档位上界), 没有样本时返回 0 */
+		[[nodiscard]] std::uint64_t Quantile(const double quantile) const noexcept {
+			std::array<std::uint64_t, BucketCount> counts{};
+			std::uint64_t total = 0;
+			for (std::size_t i = 0; i < BucketCount; ++i) {
+				counts[i] = m_Buckets[i].load(std::memory_order_relaxed);
+				total += counts[i];
+			}
+			if (total == 0) return 0;
+			const auto target = static_cast<std::uint64_t>(quantile * static_cast<double>(total - 1)) + 1;
+			std::uint64_t seen = 0;
+			for (std::size_t i = 0; i < BucketCount; ++i) {
+				seen += counts[i];
+				if (seen >= target) return BucketUpperBound(i);
+			}
+			return BucketUpperBound(BucketCount - 1);
+		}
+
+		[[nodiscard]] std::uint64_t Samples() const noexcept { return m_Samples.load(std::memory_order_relaxed); }
+		[[nodiscard]] const char* Name() const noexcept { return m_Name; }
+		[[nodiscard]] const char* File() const noexcept { return m_File; }
+		[[nodiscard]] int Line() const noexcept { return m_Line; }
+		[[nodiscard]] const CapacityHint* Next() const noexcept { return m_Next; }
+
+		/* 全局链表, 每个调用点的 CapacityHint 在第一次执行到时注册, 之后不会移除 */
+		static std::atomic<CapacityHint*>& Head() noexcept {
+			static std::atomic<CapacityHint*> head{ nullptr };
+			return head;
+		}
+
+	private:
+		const char* m_Name;
+		const char* m_File;
+		int m_Line;
+		std::atomic<std::size_t> m_Suggested;
+		std::atomic<std::uint64_t> m_Samples{ 0 };
+		std::array<std::atomic<std::uint64_t>, BucketCount> m_Buckets{};
+		CapacityHint* m_Next{ nullptr };
+	};
+
+	/**
+	 * @brief: 构造时按 hint 预留容量, 析构时把容器的最终大小记录回 hint
+	 * @note: 只要求容器有 Reserve(size) 与 Size(), 不改变容器本身的布局
+	 */
+	template <typename Container>
+	class ScopedCapacityHint {
+	public:
+		ScopedCapacityHint(Container& container, CapacityHint& hint)
+			: m_Container(container), m_Hint(hint)
+		{
+			if (const std::size_t suggested = hint.Suggest(); suggested > container.Size()) {
+				container.Reserve(suggested);
+			}
+		}
+		ScopedCapacityHint(const ScopedCapacityHint&) = delete;
+		ScopedCapacityHint& operator=(const ScopedCapacityHint&) = delete;
+
+		~ScopedCapacityHint() {
+			m_Hint.Record(static_cast<std::size_t>(m_Container.Size()));
+		}
+
+	private:
+		Container& m_Container;
+		CapacityHint& m_Hint;
+	};
+
+	/**
+	 * @brief: 以 C++ 常量的形式输出所有调用点学到的 p90 容量
+	 * @note: 输出形如 "inline constexpr std::size_t ParseTokens = 1535; // file:line, 1024 samples, p50 = 767, p99 = 2047"
+	 */
+	inline void WriteCapacityHints(std::ostream& out) {
+		for (const CapacityHint* hint = CapacityHint::Head().load(std::memory_order_acquire); hint; hint = hint->Next()) {
+			out << "inline constexpr std::size_t " << hint->Name() << " = " << hint->Quantile(CapacityHint::DefaultQuantile) << ";"
+				<< " // " << hint->File() << ":" << hint->Line() << ", " << hint->Samples() << " samples"
+				<< ", p50 = " << hint->Quantile(0.5) << ", p99 = " << hint->Quantile(0.99) << "\n";
+		}
+	}
+}
+
+/**
+ * @brief: 当前调用点的 CapacityHint, 第二个参数可选, 是样本不足时使用的基线容量
+ */
+#define POTATO_CAPACITY_HINT(name, ...)                                                        \
+	([]() -> ::Potato::CapacityHint& {                                                         \
+		static ::Potato::CapacityHint potato_capacity_hint(name, __FILE__, __LINE__ __VA_OPT__(, __VA_ARGS__)); \
+		return potato_capacity_hint;                                                           \
+	}())
+
+#endif // CAPACITY_HINT_HPP
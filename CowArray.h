@@ -0,0 +1,362 @@
+#ifndef COW_ARRAY_HPP
+#define COW_ARRAY_HPP
+
+#include <atomic>
+#include "Array.h"
+
+namespace Potato {
+	/**
+	 * @brief: 写时复制 (Copy-On-Write) 的共享数组
+	 *     CowArray 的拷贝只增加引用计数, 是 O(1) 的; 多个副本共享同一块 Array 缓冲区.
+	 *     只有在第一次调用修改型 API (Append, EraseIf, 非 const 的 operator[] ...) 时,
+	 *     如果缓冲区仍被其他副本共享, 才会真正拷贝一份 (Detach).
+	 *
+	 *     	CowArray<int> a{ 1, 2, 3 };
+	 *     	CowArray<int> b = a;     // O(1), a 和 b 共享缓冲区
+	 *     	b.Append(4);             // b Detach, a 不受影响
+	 *
+	 * @note: 读 API 直接转发到内部的 Array, 所以行为与 Array 完全一致.
+	 *     迭代只提供 const 版本, 避免范围 for 在非 const 对象上意外触发 Detach;
+	 *     需要原地修改时使用 Mutate() 取得独占的 Array&.
+	 * @note: Mutate / 非 const 的 operator[] / At / EmplaceBack 交出可写引用之后, 缓冲区被标记为不可共享:
+	 *     之后的拷贝都会深拷贝, 否则通过旧引用的写入会同时改变新的副本. 标记随缓冲区一起在 Clear / 赋值时丢弃.
+	 * @note: 引用计数是原子的, 不同线程可以安全地拷贝/销毁共享同一缓冲区的 CowArray,
+	 *     但同一个 CowArray 对象本身的读写仍需要外部同步 (与 std::shared_ptr 相同).
+	 */
+	template <typename ElementType, class AllocatorType=std::allocator<ElementType>>
+	class CowArray {
+	public:
+		using ArrayType              = Array<ElementType, AllocatorType>;
+		using value_type             = typename ArrayType::value_type;
+		using allocator_type         = typename ArrayType::allocator_type;
+		using size_type              = typename ArrayType::size_type;
+		using difference_type        = typename ArrayType::difference_type;
+		using pointer                = typename ArrayType::pointer;
+		using const_pointer          = typename ArrayType::const_pointer;
+		using reference              = typename ArrayType::reference;
+		using const_reference        = typename ArrayType::const_reference;
+		using iterator               = typename ArrayType::iterator;
+		using const_iterator         = typename ArrayType::const_iterator;
+		using reverse_const_iterator = typename ArrayType::reverse_const_iterator;
+
+	private:
+		struct SharedBlock {
+			template <typename ... Args>
+			explicit SharedBlock(Args&& ... args) : refs(1), array(std::forward<Args>(args)...) {}
+
+			std::atomic<size_type> refs;
+			/* 交出过可写引用之后置位, 之后的拷贝必须深拷贝; 只有独占缓冲区的那个 CowArray 会写它 */
+			bool bUnshareable{ false };
+			ArrayType array;
+		};
+
+		using M_BlockAllocatorType =
+			typename std::allocator_traits<AllocatorType>::template rebind_alloc<SharedBlock>;
+		using M_BlockAllocatorTraits = std::allocator_traits<M_BlockAllocatorType>;
+		using M_RealValueType = MemoryTools::CompressedPair<M_BlockAllocatorType, SharedBlock*>;
+
+	public:
+		constexpr CowArray() noexcept
+			: m_Data(MemoryTools::ZeroConstructCompressedTag{}, nullptr) {}
+
+		explicit CowArray(const AllocatorType& allocator)
+			: m_Data(MemoryTools::OneConstructCompressedTag{}, allocator, nullptr) {}
+
+		explicit CowArray(ArrayType&& array)
+			: m_Data(MemoryTools::OneConstructCompressedTag{}, M_BlockAllocatorType(array.GetAllocator()), nullptr) {
+			if (!array.IsEmpty()) {
+				m_Data.data = M_CreateBlock(std::move(array));
+			}
+		}
+
+		explicit CowArray(const ArrayType& array)
+			: m_Data(MemoryTools::OneConstructCompressedTag{}, M_BlockAllocatorType(array.GetAllocator()), nullptr) {
+			if (!array.IsEmpty()) {
+				m_Data.data = M_CreateBlock(array);
+			}
+		}
+
+		CowArray(std::initializer_list<value_type> list, const AllocatorType& allocator=AllocatorType())
+			: CowArray(ArrayType(list, allocator)) {}
+
+		/* O(1): 只增加引用计数; other 已经交出过可写引用 (见 M_MarkUnshareable) 时深拷贝 */
+		CowArray(const CowArray& other)
+			: m_Data(MemoryTools::OneConstructCompressedTag{}, other.m_Data.GetFirst(), nullptr) {
+			M_ShareOrCopy(other);
+		}
+
+		CowArray(CowArray&& other) noexcept
+			: m_Data(MemoryTools::OneConstructCompressedTag{}, std::move(other.m_Data.GetFirst()), other.m_Data.data) {
+			other.m_Data.data = nullptr;
+		}
+
+		/**
+		 * @note: 与 Array::operator= 相同, 遵守 propagate_on_container_copy/move_assignment;
+		 *     分配器不传播且不相等时不能共享对方的缓冲区 (之后会用自己的分配器释放它),
+		 *     而是用自己的分配器新建一份
+		 */
+		CowArray& operator=(const CowArray& other) {
+			if (this == &other) {
+				return *this;
+			}
+			if constexpr (M_BlockAllocatorTraits::propagate_on_container_copy_assignment::value) {
+				if (m_Data.GetFirst() != other.m_Data.GetFirst()) {
+					M_Release(m_Data.data);
+					m_Data.data = nullptr;
+				}
+				m_Data.GetFirst() = other.m_Data.GetFirst();
+			}
+			if (m_Data.data != other.m_Data.data || M_IsUnshareable(other.m_Data.data)) {
+				SharedBlock* previous = m_Data.data;
+				m_Data.data = nullptr;
+				try {
+					M_ShareOrCopy(other);
+				} catch (...) {
+					m_Data.data = previous;
+					throw;
+				}
+				M_Release(previous);
+			}
+			return *this;
+		}
+
+		CowArray& operator=(CowArray&& other)
+			noexcept(M_BlockAllocatorTraits::propagate_on_container_move_assignment::value || M_BlockAllocatorTraits::is_always_equal::value)
+		{
+			if (this == &other) {
+				return *this;
+			}
+			if constexpr (!M_BlockAllocatorTraits::propagate_on_container_move_assignment::value) {
+				if (m_Data.GetFirst() != other.m_Data.GetFirst()) {
+					/* 不能接管对方的缓冲区: 逐个元素搬到自己分配器的新缓冲区, 对方随后放弃引用 */
+					SharedBlock* fresh = nullptr;
+					if (SharedBlock* block = other.m_Data.data) {
+						ArrayType& source = block->array;
+						fresh = block->refs.load(std::memory_order_acquire) == 1
+							? M_CreateBlock(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()), AllocatorType(m_Data.GetFirst()))
+							: M_CreateBlock(source.cbegin(), source.cend(), AllocatorType(m_Data.GetFirst()));
+					}
+					M_Release(m_Data.data);
+					m_Data.data = fresh;
+					other.M_Release(other.m_Data.data);
+					other.m_Data.data = nullptr;
+					return *this;
+				}
+			}
+			M_Release(m_Data.data);
+			if constexpr (M_BlockAllocatorTraits::propagate_on_container_move_assignment::value) {
+				m_Data.GetFirst() = std::move(other.m_Data.GetFirst());
+			}
+			m_Data.data = other.m_Data.data;
+			other.m_Data.data = nullptr;
+			return *this;
+		}
+
+		~CowArray() noexcept {
+			M_Release(m_Data.data);
+		}
+
+	public:
+		/**
+		 * @brief: 读 API, 全部转发到共享的 Array, 不会触发 Detach
+		 */
+		[[nodiscard]] const ArrayType& operator*() const noexcept { return M_View(); }
+		[[nodiscard]] const ArrayType* operator->() const noexcept { return std::addressof(M_View()); }
+
+		[[nodiscard]] const_reference operator[](const size_type index) const noexcept { return M_View()[index]; }
+		[[nodiscard]] const_reference At(const size_type index) const { return M_View().At(index); }
+		[[nodiscard]] const_reference Front() const { return M_View().Front(); }
+		[[nodiscard]] const_reference Back() const { return M_View().Back(); }
+		[[nodiscard]] const value_type* Data() const noexcept { return M_View().Data(); }
+
+		[[nodiscard]] bool IsEmpty() const noexcept { return M_View().IsEmpty(); }
+		[[nodiscard]] size_type Size() const noexcept { return M_View().Size(); }
+		[[nodiscard]] size_type Capacity() const noexcept { return M_View().Capacity(); }
+		[[nodiscard]] size_type Slack() const noexcept { return M_View().Slack(); }
+
+		[[nodiscard]] size_type Find(const_reference item) const { return M_View().Find(item); }
+		template <typename Predicate>
+		[[nodiscard]] size_type FindIf(Predicate pred) const { return M_View().FindIf(pred); }
+		template <typename Ty2>
+		[[nodiscard]] size_type Count(const Ty2& item_or_pred) const { return M_View().Count(item_or_pred); }
+		template <typename ... Args>
+		[[nodiscard]] bool IsContain(Args&& ... args) const { return M_View().IsContain(std::forward<Args>(args)...); }
+		template <typename Predicate>
+		[[nodiscard]] ArrayType Filter(Predicate pred) const { return M_View().Filter(pred); }
+		template <typename FnTransform>
+		[[nodiscard]] auto Transform(FnTransform func) const { return M_View().Transform(func); }
+
+		[[nodiscard]] const_iterator begin() const noexcept { return M_View().begin(); }
+		[[nodiscard]] const_iterator end() const noexcept { return M_View().end(); }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return M_View().cbegin(); }
+		[[nodiscard]] const_iterator cend() const noexcept { return M_View().cend(); }
+		[[nodiscard]] reverse_const_iterator rbegin() const noexcept { return M_View().rbegin(); }
+		[[nodiscard]] reverse_const_iterator rend() const noexcept { return M_View().rend(); }
+
+		/* 拷贝出一个独立的 Array */
+		[[nodiscard]] ArrayType ToArray() const { return M_View(); }
+
+		/* 当前缓冲区被多少个 CowArray 共享, 空数组返回 0 */
+		[[nodiscard]] size_type UseCount() const noexcept {
+			return m_Data.data ? m_Data.data->refs.load(std::memory_order_acquire) : 0u;
+		}
+		[[nodiscard]] bool IsShared() const noexcept {
+			return UseCount() > 1;
+		}
+
+	public:
+		/**
+		 * @brief: 写 API, 在修改之前先保证独占缓冲区 (必要时 Detach)
+		 */
+		[[nodiscard]] ArrayType& Mutate() {
+			return M_MarkUnshareable(M_Detach());
+		}
+
+		[[nodiscard]] reference operator[](const size_type index) { return M_MarkUnshareable(M_Detach())[index]; }
+		[[nodiscard]] reference At(const size_type index) { return M_MarkUnshareable(M_Detach()).At(index); }
+
+		template <typename ... Args>
+		CowArray& Append(Args&& ... args) {
+			M_Detach().Append(std::forward<Args>(args)...);
+			return *this;
+		}
+		template <typename ... Args>
+		reference EmplaceBack(Args&& ... args) {
+			return M_MarkUnshareable(M_Detach()).EmplaceBack(std::forward<Args>(args)...);
+		}
+		template <typename Predicate>
+		CowArray& EraseIf(Predicate pred) {
+			/* 没有需要删除的元素时不 Detach */
+			if (M_View().IsContain(pred)) {
+				M_Detach().EraseIf(pred);
+			}
+			return *this;
+		}
+		CowArray& EraseAt(const size_type index) {
+			M_Detach().EraseAt(index);
+			return *this;
+		}
+		void Pop() {
+			M_Detach().Pop();
+		}
+		void Resize(size_type count) {
+			M_Detach().Resize(count);
+		}
+		void Resize(size_type count, const value_type& value) {
+			M_Detach().Resize(count, value);
+		}
+		void Reserve(size_type capacity) {
+			if (capacity > Capacity() || IsShared()) {
+				M_Detach().Reserve(capacity);
+			}
+		}
+		/* Clear 不需要拷贝共享的数据, 直接放弃引用即可 */
+		void Clear() noexcept {
+			if (IsShared()) {
+				M_Release(m_Data.data);
+				m_Data.data = nullptr;
+			} else if (m_Data.data) {
+				/* 元素都已销毁, 之前交出的引用随之失效, 缓冲区可以重新共享 */
+				m_Data.data->array.Clear();
+				m_Data.data->bUnshareable = false;
+			}
+		}
+
+		/* 与标准容器相同: 分配器不随 swap 传播时, 两边的分配器必须相等 */
+		void Swap(CowArray& other) noexcept {
+			using std::swap;
+			if constexpr (M_BlockAllocatorTraits::propagate_on_container_swap::value) {
+				swap(m_Data.GetFirst(), other.m_Data.GetFirst());
+			} else {
+				assert(m_Data.GetFirst() == other.m_Data.GetFirst() && "CowArray::Swap: allocators must compare equal");
+			}
+			swap(m_Data.data, other.m_Data.data);
+		}
+
+	private:
+		[[nodiscard]] static const ArrayType& M_EmptyArray() noexcept {
+			static const ArrayType empty;
+			return empty;
+		}
+
+		[[nodiscard]] const ArrayType& M_View() const noexcept {
+			return m_Data.data ? m_Data.data->array : M_EmptyArray();
+		}
+
+		template <typename ... Args>
+		[[nodiscard]] SharedBlock* M_CreateBlock(Args&& ... args) {
+			auto& allocator = m_Data.GetFirst();
+			SharedBlock* block = MemoryTools::Unfancy(M_BlockAllocatorTraits::allocate(allocator, 1));
+			try {
+				M_BlockAllocatorTraits::construct(allocator, block, std::forward<Args>(args)...);
+			} catch (...) {
+				M_BlockAllocatorTraits::deallocate(allocator, block, 1);
+				throw;
+			}
+			return block;
+		}
+
+		void M_Release(SharedBlock* block) noexcept {
+			if (block && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				auto& allocator = m_Data.GetFirst();
+				M_BlockAllocatorTraits::destroy(allocator, block);
+				M_BlockAllocatorTraits::deallocate(allocator, block, 1);
+			}
+		}
+
+		[[nodiscard]] static bool M_IsUnshareable(const SharedBlock* block) noexcept {
+			return block && block->bUnshareable;
+		}
+
+		/* 返回的引用可能在之后的拷贝之后仍被写入, 所以缓冲区从此不再共享 */
+		ArrayType& M_MarkUnshareable(ArrayType& array) noexcept {
+			m_Data.data->bUnshareable = true;
+			return array;
+		}
+
+		/**
+		 * @brief: 调用前 m_Data.data 为空. 分配器相等且 other 的缓冲区可共享时增加引用计数,
+		 *     否则用自己的分配器深拷贝一份
+		 */
+		void M_ShareOrCopy(const CowArray& other) {
+			SharedBlock* block = other.m_Data.data;
+			if (block == nullptr) {
+				return;
+			}
+			if (!block->bUnshareable && m_Data.GetFirst() == other.m_Data.GetFirst()) {
+				block->refs.fetch_add(1, std::memory_order_relaxed);
+				m_Data.data = block;
+			} else {
+				m_Data.data = M_CreateBlock(block->array.cbegin(), block->array.cend(), AllocatorType(m_Data.GetFirst()));
+			}
+		}
+
+		/**
+		 * @brief: 保证当前对象独占缓冲区
+		 * @note: refs == 1 时说明没有其他副本, 可以直接修改; 否则拷贝一份新的缓冲区
+		 *     再放弃旧的引用. 拷贝失败时旧缓冲区保持不变 (强异常安全).
+		 */
+		ArrayType& M_Detach() {
+			SharedBlock* block = m_Data.data;
+			if (block == nullptr) {
+				/* 新缓冲区沿用容器自己的分配器, 有状态的分配器不能丢 */
+				m_Data.data = M_CreateBlock(AllocatorType(m_Data.GetFirst()));
+			} else if (block->refs.load(std::memory_order_acquire) != 1) {
+				SharedBlock* fresh = M_CreateBlock(static_cast<const ArrayType&>(block->array));
+				M_Release(block);
+				m_Data.data = fresh;
+			}
+			return m_Data.data->array;
+		}
+
+	private:
+		M_RealValueType m_Data;
+	};
+}
+
+template <typename T, typename Alloc>
+bool operator==(const Potato::CowArray<T, Alloc>& lhs, const Potato::CowArray<T, Alloc>& rhs) noexcept {
+	return *lhs == *rhs;
+}
+
+#endif // COW_ARRAY_HPP
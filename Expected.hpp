@@ -0,0 +1,683 @@
+#pragma once
+#include <expected>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "TraitsTools.hpp"
+#include "TypeTraits.hpp"
+#include "Optional.hpp"
+
+namespace Core {
+
+/*
+ * @function: 携带错误值的包装, 用于构造处于错误状态的 Expected
+ *     return Core::Unexpected{ ArrayErrc::OutOfRange };
+ */
+template <typename Err>
+class Unexpected {
+	static_assert(std::is_object_v<Err> && !std::is_array_v<Err> && !std::is_const_v<Err> && !std::is_volatile_v<Err>,
+		"Unexpected<E> requires E to be a non-array, non-cv object type");
+public:
+	template <
+		typename Err2 = Err,
+		std::enable_if_t<
+			!std::is_same_v<std::remove_cvref_t<Err2>, Unexpected> &&
+			!std::is_same_v<std::remove_cvref_t<Err2>, std::in_place_t> &&
+			std::is_constructible_v<Err, Err2>,
+			int
+		> = 0
+	>
+	constexpr explicit Unexpected(Err2&& error)
+		noexcept(std::is_nothrow_constructible_v<Err, Err2>)
+		: m_Error(std::forward<Err2>(error)) {}
+
+	template <typename... Types>
+	constexpr explicit Unexpected(std::in_place_t, Types&&... args)
+		noexcept(std::is_nothrow_constructible_v<Err, Types...>)
+		: m_Error(std::forward<Types>(args)...) {}
+
+	[[nodiscard]] constexpr const Err& Error() const & noexcept { return m_Error; }
+	[[nodiscard]] constexpr Err& Error() & noexcept { return m_Error; }
+	[[nodiscard]] constexpr const Err&& Error() const && noexcept { return std::move(m_Error); }
+	[[nodiscard]] constexpr Err&& Error() && noexcept { return std::move(m_Error); }
+
+	template <typename Err2>
+	[[nodiscard]] friend constexpr bool operator==(const Unexpected& left, const Unexpected<Err2>& right) {
+		return left.Error() == right.Error();
+	}
+private:
+	Err m_Error;
+};
+
+template <typename Err>
+Unexpected(Err) -> Unexpected<Err>;
+
+/* 在错误状态下原地构造 Expected 的标签 */
+struct UnexpectTp {
+	explicit UnexpectTp() = default;
+};
+inline constexpr UnexpectTp unexpect{};
+
+/* 只借用保留的哨兵: 空智能指针与 NaN 都是 Expected 的合法值, 不能表示错误 */
+template <typename Ty, typename Err>
+constexpr bool HasExpectedNicheVal =
+	HasReservedNicheVal<Ty> &&
+	std::is_empty_v<Err> &&
+	std::is_nothrow_default_constructible_v<Err>;
+
+/*
+ * @function: Expected 的存储层, 与 OptionDestruct 同样的 union 布局
+ * @note: 判别式是一个 uint8_t: 0 只在 AutoControlSMF 的拷贝/移动构造过程中短暂出现 (尚未构造任何成员),
+ *     1 表示 value, 2 表示 error. 平凡析构的 Ty / Err 不会声明析构函数, 保证 Expected 的平凡性.
+ */
+template <
+	typename Ty,
+	typename Err,
+	bool bTrivialDestructible = std::is_trivially_destructible_v<Ty> && std::is_trivially_destructible_v<Err>,
+	bool = HasExpectedNicheVal<Ty, Err>
+>
+struct ExpectedDestruct {
+	union {
+		NonTrivialDummyTp dummy;
+		std::remove_cv_t<Ty> value;
+		std::remove_cv_t<Err> error;
+	};
+
+	constexpr ExpectedDestruct() noexcept : dummy{}, m_State(M_None) {}
+
+	template <typename... Types>
+	constexpr explicit ExpectedDestruct(std::in_place_t, Types&&... Args)
+		noexcept(std::is_nothrow_constructible_v<Ty, Types...>)
+		: value(std::forward<Types>(Args)...), m_State(M_Value) {}
+
+	template <typename... Types>
+	constexpr explicit ExpectedDestruct(UnexpectTp, Types&&... Args)
+		noexcept(std::is_nothrow_constructible_v<Err, Types...>)
+		: error(std::forward<Types>(Args)...), m_State(M_Error) {}
+
+	template <typename Fn, typename Uty>
+	constexpr ExpectedDestruct(ConstructFromInvokeResultTag, Fn&& fn, Uty&& arg)
+		noexcept(noexcept(static_cast<Ty>(std::invoke(std::forward<Fn>(fn), std::forward<Uty>(arg)))))
+		: value(std::invoke(std::forward<Fn>(fn), std::forward<Uty>(arg))), m_State(M_Value) {}
+
+	~ExpectedDestruct() requires bTrivialDestructible = default;
+	constexpr ~ExpectedDestruct() requires (!bTrivialDestructible) {
+		__Cleanup();
+	}
+	ExpectedDestruct(const ExpectedDestruct&) = default;
+	ExpectedDestruct& operator=(const ExpectedDestruct&) = default;
+	ExpectedDestruct(ExpectedDestruct&&) = default;
+	ExpectedDestruct& operator=(ExpectedDestruct&&) = default;
+
+	constexpr void __Cleanup() noexcept {
+		if constexpr (!bTrivialDestructible) {
+			if (m_State == M_Value) {
+				value.~Ty();
+			} else if (m_State == M_Error) {
+				error.~Err();
+			}
+		}
+		m_State = M_None;
+	}
+
+	template <typename... Types>
+	constexpr void __ConstructValue(Types&&... Args)
+		noexcept(std::is_nothrow_constructible_v<Ty, Types...>)
+	{
+		std::construct_at(&value, std::forward<Types>(Args)...);
+		m_State = M_Value;
+	}
+	template <typename... Types>
+	constexpr void __ConstructError(Types&&... Args)
+		noexcept(std::is_nothrow_constructible_v<Err, Types...>)
+	{
+		std::construct_at(&error, std::forward<Types>(Args)...);
+		m_State = M_Error;
+	}
+
+	constexpr bool HasValue() const noexcept {
+		return m_State == M_Value;
+	}
+private:
+	static constexpr std::uint8_t M_None = 0;
+	static constexpr std::uint8_t M_Value = 1;
+	static constexpr std::uint8_t M_Error = 2;
+
+	std::uint8_t m_State;
+};
+
+/*
+ * @function: Err 为空类型且 Ty 有保留的 niche (IsReservedNiche) 时, 错误状态用 Ty 的哨兵值表示, sizeof(Expected) == sizeof(Ty)
+ * @note: error 始终存活且不占空间 ([[no_unique_address]]), 默认状态是错误状态
+ */
+template <typename Ty, typename Err, bool bTrivialDestructible>
+struct ExpectedDestruct<Ty, Err, bTrivialDestructible, true> {
+	using NicheTraitsTp = OptionalTraits<std::remove_cv_t<Ty>>;
+	union {
+		NonTrivialDummyTp dummy;
+		std::remove_cv_t<Ty> value;
+	};
+	[[no_unique_address]] std::remove_cv_t<Err> error;
+
+	constexpr ExpectedDestruct() noexcept : value(NicheTraitsTp::EmptyValue()), error() {}
+
+	template <typename... Types>
+	constexpr explicit ExpectedDestruct(std::in_place_t, Types&&... Args)
+		noexcept(std::is_nothrow_constructible_v<Ty, Types...>)
+		: value(std::forward<Types>(Args)...), error() {}
+
+	template <typename... Types>
+	constexpr explicit ExpectedDestruct(UnexpectTp, Types&&... Args)
+		noexcept(std::is_nothrow_constructible_v<Err, Types...>)
+		: value(NicheTraitsTp::EmptyValue()), error(std::forward<Types>(Args)...) {}
+
+	template <typename Fn, typename Uty>
+	constexpr ExpectedDestruct(ConstructFromInvokeResultTag, Fn&& fn, Uty&& arg)
+		noexcept(noexcept(static_cast<Ty>(std::invoke(std::forward<Fn>(fn), std::forward<Uty>(arg)))))
+		: value(std::invoke(std::forward<Fn>(fn), std::forward<Uty>(arg))), error() {}
+
+	~ExpectedDestruct() requires bTrivialDestructible = default;
+	constexpr ~ExpectedDestruct() requires (!bTrivialDestructible) {
+		value.~Ty();
+	}
+	ExpectedDestruct(const ExpectedDestruct&) = default;
+	ExpectedDestruct& operator=(const ExpectedDestruct&) = default;
+	ExpectedDestruct(ExpectedDestruct&&) = default;
+	ExpectedDestruct& operator=(ExpectedDestruct&&) = default;
+
+	/* 把 value 重置为哨兵, 即错误状态 */
+	constexpr void __Cleanup() noexcept {
+		if constexpr (bTrivialDestructible) {
+			std::construct_at(&value, NicheTraitsTp::EmptyValue());
+		} else if (HasValue()) {
+			value.~Ty();
+			std::construct_at(&value, NicheTraitsTp::EmptyValue());
+		}
+	}
+
+	template <typename... Types>
+	constexpr void __ConstructValue(Types&&... Args)
+		noexcept(std::is_nothrow_constructible_v<Ty, Types...>)
+	{
+		std::construct_at(&value, std::forward<Types>(Args)...);
+	}
+	template <typename... Types>
+	constexpr void __ConstructError(Types&&... Args)
+		noexcept(std::is_nothrow_constructible_v<Err, Types...>)
+	{
+		__Cleanup();
+		error = std::remove_cv_t<Err>(std::forward<Types>(Args)...);
+	}
+
+	constexpr bool HasValue() const noexcept {
+		return !NicheTraitsTp::IsEmpty(value);
+	}
+};
+
+/*
+ * @function: 为 AutoControlSMF 提供 __ConstructFrom / __AssignFrom
+ */
+template <typename Ty, typename Err>
+struct ExpectedConstruct : ExpectedDestruct<Ty, Err> {
+	using ExpectedDestruct<Ty, Err>::ExpectedDestruct;
+
+	template <typename Self>
+	constexpr void __ConstructFrom(Self&& right)
+		noexcept(
+			std::is_nothrow_constructible_v<Ty, decltype(std::forward<Self>(right).value)> &&
+			std::is_nothrow_constructible_v<Err, decltype(std::forward<Self>(right).error)>
+		)
+	{
+		if (right.HasValue()) {
+			this->__ConstructValue(std::forward<Self>(right).value);
+		} else {
+			this->__ConstructError(std::forward<Self>(right).error);
+		}
+	}
+
+	/**
+	 * @brief: 状态不同时切换到 value (bToValue) 或 error, 即标准中的 reinit-expected
+	 * @note: 新成员的构造可能抛出时, 先构造到临时对象再 noexcept 移动进来; 新成员的移动也可能抛出时,
+	 *     先把旧成员 noexcept 移动到临时对象, 构造失败再移回. 失败时 *this 保持原来的状态 (强异常安全).
+	 *     与标准相同, 要求 Ty 与 Err 中至少一个可以 noexcept 移动构造.
+	 */
+	template <bool bToValue, typename... Types>
+	constexpr void __Reinit(Types&&... Args) {
+		using NewTp = std::remove_cv_t<std::conditional_t<bToValue, Ty, Err>>;
+		using OldTp = std::remove_cv_t<std::conditional_t<bToValue, Err, Ty>>;
+		if constexpr (std::is_nothrow_constructible_v<NewTp, Types...>) {
+			this->__Cleanup();
+			M_ConstructAlternative<bToValue>(std::forward<Types>(Args)...);
+		} else if constexpr (std::is_nothrow_move_constructible_v<NewTp>) {
+			NewTp temp(std::forward<Types>(Args)...);
+			this->__Cleanup();
+			M_ConstructAlternative<bToValue>(std::move(temp));
+		} else {
+			static_assert(std::is_nothrow_move_constructible_v<OldTp>,
+				"Expected<T, E> assignment requires T or E to be nothrow move constructible");
+			OldTp saved(std::move(M_Alternative<!bToValue>()));
+			this->__Cleanup();
+			try {
+				M_ConstructAlternative<bToValue>(std::forward<Types>(Args)...);
+			} catch (...) {
+				M_ConstructAlternative<!bToValue>(std::move(saved));
+				throw;
+			}
+		}
+	}
+
+	/* 状态相同时直接赋值, 状态不同时通过 __Reinit 切换 */
+	template <typename Self>
+	constexpr void __AssignFrom(Self&& right)
+		noexcept(
+			std::is_nothrow_constructible_v<Ty, decltype(std::forward<Self>(right).value)> &&
+			std::is_nothrow_constructible_v<Err, decltype(std::forward<Self>(right).error)> &&
+			std::is_nothrow_assignable_v<Ty&, decltype(std::forward<Self>(right).value)> &&
+			std::is_nothrow_assignable_v<Err&, decltype(std::forward<Self>(right).error)>
+		)
+	{
+		const bool bHasValue = this->HasValue();
+		if (bHasValue && right.HasValue()) {
+			this->value = std::forward<Self>(right).value;
+		} else if (!bHasValue && !right.HasValue()) {
+			this->error = std::forward<Self>(right).error;
+		} else if (right.HasValue()) {
+			__Reinit<true>(std::forward<Self>(right).value);
+		} else {
+			__Reinit<false>(std::forward<Self>(right).error);
+		}
+	}
+
+private:
+	template <bool bValue>
+	constexpr auto& M_Alternative() noexcept {
+		if constexpr (bValue) return this->value;
+		else return this->error;
+	}
+	template <bool bValue, typename... Types>
+	constexpr void M_ConstructAlternative(Types&&... Args) {
+		if constexpr (bValue) this->__ConstructValue(std::forward<Types>(Args)...);
+		else this->__ConstructError(std::forward<Types>(Args)...);
+	}
+};
+
+template <typename Ty, typename Err>
+class Expected;
+
+/*
+ * @function: Expected<T, E>: 要么是一个 T, 要么是一个错误 E
+ *     用于热路径上的可失败调用: 不抛异常, 也不会丢失失败的原因
+ * @note: 1. 建立在 AutoControlSMF 之上: Ty 与 Err 都是平凡可拷贝时 Expected 也是平凡可拷贝的
+ *        2. 判别式是一个字节; 若 Err 为空类型且 Ty 存在保留的 niche (OptionalTraits::IsReservedNiche), 则不需要判别式
+ *        3. Map / AndThen / OrElse 与 Optional 一致, 另有 MapError 转换错误类型
+ */
+template <typename Ty, typename Err>
+class Expected : private Traits::AutoControlSMF<ExpectedConstruct<Ty, Err>, Ty, Err> {
+	using MyBaseClassTp = Traits::AutoControlSMF<ExpectedConstruct<Ty, Err>, Ty, Err>;
+	using MyBaseClassTp::MyBaseClassTp;
+
+	template <class, class>
+	friend class Expected;
+public:
+	static_assert(std::is_object_v<Ty> && std::is_destructible_v<Ty> && !std::is_array_v<Ty>,
+		"Expected<T, E> requires T to be a destructible, non-array object type");
+	static_assert(std::is_object_v<Err> && std::is_destructible_v<Err> && !std::is_array_v<Err>,
+		"Expected<T, E> requires E to be a destructible, non-array object type");
+	static_assert(!IsSpecializationValOf<std::remove_cv_t<Ty>, Unexpected> && !IsAnyValOf<std::remove_cv_t<Ty>, std::in_place_t, UnexpectTp>,
+		"Expected<T, E> requires T to be neither Unexpected nor a tag type");
+
+	using ValueType = Ty;
+	using ErrorType = Err;
+	using TriviallyRelocatableTp = Traits::TriviallyRelocatableIfTp<Ty, Err>;
+
+	/* 必须是非模板的构造函数, 否则会输给继承来的 ExpectedDestruct() (不构造任何成员) */
+	constexpr Expected() noexcept(std::is_nothrow_default_constructible_v<Ty>)
+		requires std::is_default_constructible_v<Ty>
+		: MyBaseClassTp(std::in_place) {}
+
+	template <
+		typename Ty2 = std::remove_cv_t<Ty>,
+		std::enable_if_t<
+			!std::is_same_v<std::remove_cvref_t<Ty2>, Expected> &&
+			!IsSpecializationValOf<std::remove_cvref_t<Ty2>, Unexpected> &&
+			!IsAnyValOf<std::remove_cvref_t<Ty2>, std::in_place_t, UnexpectTp> &&
+			std::is_constructible_v<Ty, Ty2>,
+			int
+		> = 0
+	>
+	constexpr explicit(!std::is_convertible_v<Ty2, Ty>) Expected(Ty2&& right)
+		noexcept(std::is_nothrow_constructible_v<Ty, Ty2>)
+		: MyBaseClassTp(std::in_place, std::forward<Ty2>(right)) {}
+
+	template <typename Err2, std::enable_if_t<std::is_constructible_v<Err, const Err2&>, int> = 0>
+	constexpr explicit(!std::is_convertible_v<const Err2&, Err>) Expected(const Unexpected<Err2>& that)
+		noexcept(std::is_nothrow_constructible_v<Err, const Err2&>)
+		: MyBaseClassTp(unexpect, that.Error()) {}
+
+	template <typename Err2, std::enable_if_t<std::is_constructible_v<Err, Err2>, int> = 0>
+	constexpr explicit(!std::is_convertible_v<Err2, Err>) Expected(Unexpected<Err2>&& that)
+		noexcept(std::is_nothrow_constructible_v<Err, Err2>)
+		: MyBaseClassTp(unexpect, std::move(that).Error()) {}
+
+	template <typename... Types, std::enable_if_t<std::is_constructible_v<Ty, Types...>, int> = 0>
+	constexpr explicit Expected(std::in_place_t, Types&&... Args)
+		noexcept(std::is_nothrow_constructible_v<Ty, Types...>)
+		: MyBaseClassTp(std::in_place, std::forward<Types>(Args)...) {}
+
+	template <typename... Types, std::enable_if_t<std::is_constructible_v<Err, Types...>, int> = 0>
+	constexpr explicit Expected(UnexpectTp, Types&&... Args)
+		noexcept(std::is_nothrow_constructible_v<Err, Types...>)
+		: MyBaseClassTp(unexpect, std::forward<Types>(Args)...) {}
+
+	template <typename Fn, typename Uty>
+	constexpr Expected(ConstructFromInvokeResultTag tag, Fn&& fn, Uty&& arg)
+		noexcept(noexcept(static_cast<Ty>(std::invoke(std::forward<Fn>(fn), std::forward<Uty>(arg)))))
+		: MyBaseClassTp(tag, std::forward<Fn>(fn), std::forward<Uty>(arg)) {}
+
+	template <
+		typename Ty2 = std::remove_cv_t<Ty>,
+		std::enable_if_t<
+			!std::is_same_v<std::remove_cvref_t<Ty2>, Expected> &&
+			!IsSpecializationValOf<std::remove_cvref_t<Ty2>, Unexpected> &&
+			std::is_constructible_v<Ty, Ty2> &&
+			std::is_assignable_v<Ty&, Ty2>,
+			int
+		> = 0
+	>
+	constexpr Expected& operator=(Ty2&& right) {
+		if (this->HasValue()) {
+			this->value = std::forward<Ty2>(right);
+		} else {
+			this->template __Reinit<true>(std::forward<Ty2>(right));
+		}
+		return *this;
+	}
+
+	template <typename Err2>
+	constexpr Expected& operator=(const Unexpected<Err2>& that) {
+		if (this->HasValue()) {
+			this->template __Reinit<false>(that.Error());
+		} else {
+			this->error = that.Error();
+		}
+		return *this;
+	}
+
+public:
+	[[nodiscard]] constexpr bool HasValue() const noexcept {
+		return MyBaseClassTp::HasValue();
+	}
+	[[nodiscard]] constexpr explicit operator bool() const noexcept {
+		return this->HasValue();
+	}
+
+	[[nodiscard]] constexpr Ty& operator*() & noexcept { return this->value; }
+	[[nodiscard]] constexpr const Ty& operator*() const & noexcept { return this->value; }
+	[[nodiscard]] constexpr Ty&& operator*() && noexcept { return std::move(this->value); }
+	[[nodiscard]] constexpr const Ty&& operator*() const && noexcept { return std::move(this->value); }
+	[[nodiscard]] constexpr Ty* operator->() noexcept { return std::addressof(this->value); }
+	[[nodiscard]] constexpr const Ty* operator->() const noexcept { return std::addressof(this->value); }
+
+	[[nodiscard]] constexpr Ty& Value() & {
+		M_ThrowIfError();
+		return this->value;
+	}
+	[[nodiscard]] constexpr const Ty& Value() const & {
+		M_ThrowIfError();
+		return this->value;
+	}
+	[[nodiscard]] constexpr Ty&& Value() && {
+		M_ThrowIfError();
+		return std::move(this->value);
+	}
+
+	/* 有值时调用 Error() 是未定义行为 */
+	[[nodiscard]] constexpr Err& Error() & noexcept { return this->error; }
+	[[nodiscard]] constexpr const Err& Error() const & noexcept { return this->error; }
+	[[nodiscard]] constexpr Err&& Error() && noexcept { return std::move(this->error); }
+
+	template <typename Ty2>
+	[[nodiscard]] constexpr std::remove_cv_t<Ty> ValueOr(Ty2&& that) const & {
+		if (this->HasValue()) {
+			return this->value;
+		}
+		return static_cast<std::remove_cv_t<Ty>>(std::forward<Ty2>(that));
+	}
+	template <typename Ty2>
+	[[nodiscard]] constexpr std::remove_cv_t<Ty> ValueOr(Ty2&& that) && {
+		if (this->HasValue()) {
+			return std::move(this->value);
+		}
+		return static_cast<std::remove_cv_t<Ty>>(std::forward<Ty2>(that));
+	}
+
+	template <typename Err2>
+	[[nodiscard]] constexpr std::remove_cv_t<Err> ErrorOr(Err2&& that) const & {
+		if (!this->HasValue()) {
+			return this->error;
+		}
+		return static_cast<std::remove_cv_t<Err>>(std::forward<Err2>(that));
+	}
+
+public:
+	/* fn: Expected<U, Err> fn(T), 错误原样传递 */
+	template <typename Fn> constexpr auto AndThen(Fn&& fn) & { return M_AndThen(*this, std::forward<Fn>(fn)); }
+	template <typename Fn> constexpr auto AndThen(Fn&& fn) const & { return M_AndThen(*this, std::forward<Fn>(fn)); }
+	template <typename Fn> constexpr auto AndThen(Fn&& fn) && { return M_AndThen(std::move(*this), std::forward<Fn>(fn)); }
+
+	/* fn: U fn(T), 结果为 Expected<U, Err> */
+	template <typename Fn> constexpr auto Map(Fn&& fn) & { return M_Map(*this, std::forward<Fn>(fn)); }
+	template <typename Fn> constexpr auto Map(Fn&& fn) const & { return M_Map(*this, std::forward<Fn>(fn)); }
+	template <typename Fn> constexpr auto Map(Fn&& fn) && { return M_Map(std::move(*this), std::forward<Fn>(fn)); }
+
+	/* fn: Expected<T, G> fn(Err), 有值时原样传递 */
+	template <typename Fn> constexpr auto OrElse(Fn&& fn) & { return M_OrElse(*this, std::forward<Fn>(fn)); }
+	template <typename Fn> constexpr auto OrElse(Fn&& fn) const & { return M_OrElse(*this, std::forward<Fn>(fn)); }
+	template <typename Fn> constexpr auto OrElse(Fn&& fn) && { return M_OrElse(std::move(*this), std::forward<Fn>(fn)); }
+
+	/* fn: G fn(Err), 结果为 Expected<T, G> */
+	template <typename Fn> constexpr auto MapError(Fn&& fn) & { return M_MapError(*this, std::forward<Fn>(fn)); }
+	template <typename Fn> constexpr auto MapError(Fn&& fn) const & { return M_MapError(*this, std::forward<Fn>(fn)); }
+	template <typename Fn> constexpr auto MapError(Fn&& fn) && { return M_MapError(std::move(*this), std::forward<Fn>(fn)); }
+
+private:
+	constexpr void M_ThrowIfError() const {
+		if (!this->HasValue()) {
+			throw std::bad_expected_access<std::remove_cv_t<Err>>(this->error);
+		}
+	}
+
+	template <typename Self, typename Fn>
+	static constexpr auto M_AndThen(Self&& self, Fn&& fn) {
+		using Utp = std::remove_cvref_t<std::invoke_result_t<Fn, decltype(*std::forward<Self>(self))>>;
+		static_assert(IsSpecializationValOf<Utp, Expected>,
+			"Expected<T, E>::AndThen(Fn) requires the return type of Fn to be a specialization of Expected");
+		static_assert(std::is_same_v<typename Utp::ErrorType, Err>,
+			"Expected<T, E>::AndThen(Fn) requires Fn to return an Expected with the same error type");
+		if (self.HasValue()) {
+			return std::invoke(std::forward<Fn>(fn), *std::forward<Self>(self));
+		}
+		return Utp{ unexpect, std::forward<Self>(self).error };
+	}
+
+	template <typename Self, typename Fn>
+	static constexpr auto M_Map(Self&& self, Fn&& fn) {
+		using Rtp = std::invoke_result_t<Fn, decltype(*std::forward<Self>(self))>;
+		using Utp = std::conditional_t<
+			std::is_lvalue_reference_v<Rtp>,
+			Rtp,
+			std::remove_cv_t<std::remove_reference_t<Rtp>>
+		>;
+		using ResultTp = Expected<Utp, Err>;
+		if (self.HasValue()) {
+			if constexpr (std::is_lvalue_reference_v<Utp>) {
+				return ResultTp{ std::invoke(std::forward<Fn>(fn), *std::forward<Self>(self)) };
+			} else {
+				return ResultTp{ ConstructFromInvokeResultTag{}, std::forward<Fn>(fn), *std::forward<Self>(self) };
+			}
+		}
+		return ResultTp{ unexpect, std::forward<Self>(self).error };
+	}
+
+	template <typename Self, typename Fn>
+	static constexpr auto M_OrElse(Self&& self, Fn&& fn) {
+		using Utp = std::remove_cvref_t<std::invoke_result_t<Fn, decltype(std::forward<Self>(self).error)>>;
+		static_assert(IsSpecializationValOf<Utp, Expected>,
+			"Expected<T, E>::OrElse(Fn) requires the return type of Fn to be a specialization of Expected");
+		static_assert(std::is_same_v<typename Utp::ValueType, Ty>,
+			"Expected<T, E>::OrElse(Fn) requires Fn to return an Expected with the same value type");
+		if (self.HasValue()) {
+			return Utp{ std::in_place, *std::forward<Self>(self) };
+		}
+		return std::invoke(std::forward<Fn>(fn), std::forward<Self>(self).error);
+	}
+
+	template <typename Self, typename Fn>
+	static constexpr auto M_MapError(Self&& self, Fn&& fn) {
+		using Gtp = std::remove_cv_t<std::invoke_result_t<Fn, decltype(std::forward<Self>(self).error)>>;
+		using ResultTp = Expected<Ty, Gtp>;
+		if (self.HasValue()) {
+			return ResultTp{ std::in_place, *std::forward<Self>(self) };
+		}
+		return ResultTp{ unexpect, std::invoke(std::forward<Fn>(fn), std::forward<Self>(self).error) };
+	}
+};
+
+/*
+ * @function: 引用特化, 内部就是一个 Expected<T*, E>, 不拷贝被引用的对象
+ * @note: 与 Optional<T&> 相同, 禁止绑定到临时对象
+ */
+template <typename Ty, typename Err>
+class Expected<Ty&, Err> {
+	template <class, class>
+	friend class Expected;
+public:
+	using ValueType = Ty&;
+	using ErrorType = Err;
+
+	template <
+		typename Ty2,
+		std::enable_if_t<std::is_convertible_v<Ty2*, Ty*>, int> = 0
+	>
+	constexpr Expected(Ty2& that) noexcept : m_Impl(std::in_place, std::addressof(that)) {}
+
+	template <
+		typename Ty2,
+		std::enable_if_t<std::is_convertible_v<Ty2*, Ty*>, int> = 0
+	>
+	Expected(const Ty2&&) = delete;
+
+	template <typename Err2, std::enable_if_t<std::is_constructible_v<Err, const Err2&>, int> = 0>
+	constexpr Expected(const Unexpected<Err2>& that) : m_Impl(that) {}
+
+	template <typename Err2, std::enable_if_t<std::is_constructible_v<Err, Err2>, int> = 0>
+	constexpr Expected(Unexpected<Err2>&& that) : m_Impl(std::move(that)) {}
+
+	template <typename... Types, std::enable_if_t<std::is_constructible_v<Err, Types...>, int> = 0>
+	constexpr explicit Expected(UnexpectTp, Types&&... Args)
+		: m_Impl(unexpect, std::forward<Types>(Args)...) {}
+
+	[[nodiscard]] constexpr bool HasValue() const noexcept { return m_Impl.HasValue(); }
+	[[nodiscard]] constexpr explicit operator bool() const noexcept { return m_Impl.HasValue(); }
+
+	[[nodiscard]] constexpr Ty& operator*() const noexcept { return **m_Impl; }
+	[[nodiscard]] constexpr Ty* operator->() const noexcept { return *m_Impl; }
+	[[nodiscard]] constexpr Ty& Value() const { return *m_Impl.Value(); }
+
+	[[nodiscard]] constexpr Err& Error() & noexcept { return m_Impl.Error(); }
+	[[nodiscard]] constexpr const Err& Error() const & noexcept { return m_Impl.Error(); }
+	[[nodiscard]] constexpr Err&& Error() && noexcept { return std::move(m_Impl).Error(); }
+
+	/* 返回值而不是引用: that 可能是临时对象 */
+	template <typename Ty2>
+	[[nodiscard]] constexpr std::remove_cv_t<Ty> ValueOr(Ty2&& that) const {
+		if (m_Impl.HasValue()) {
+			return **m_Impl;
+		}
+		return static_cast<std::remove_cv_t<Ty>>(std::forward<Ty2>(that));
+	}
+
+	template <typename Fn>
+	constexpr auto AndThen(Fn&& fn) const {
+		using Utp = std::remove_cvref_t<std::invoke_result_t<Fn, Ty&>>;
+		static_assert(IsSpecializationValOf<Utp, Expected>,
+			"Expected<T&, E>::AndThen(Fn) requires the return type of Fn to be a specialization of Expected");
+		if (m_Impl.HasValue()) {
+			return std::invoke(std::forward<Fn>(fn), **m_Impl);
+		}
+		return Utp{ unexpect, m_Impl.Error() };
+	}
+
+	template <typename Fn>
+	constexpr auto Map(Fn&& fn) const {
+		using Rtp = std::invoke_result_t<Fn, Ty&>;
+		using Utp = std::conditional_t<
+			std::is_lvalue_reference_v<Rtp>,
+			Rtp,
+			std::remove_cv_t<std::remove_reference_t<Rtp>>
+		>;
+		using ResultTp = Expected<Utp, Err>;
+		if (m_Impl.HasValue()) {
+			if constexpr (std::is_lvalue_reference_v<Utp>) {
+				return ResultTp{ std::invoke(std::forward<Fn>(fn), **m_Impl) };
+			} else {
+				return ResultTp{ ConstructFromInvokeResultTag{}, std::forward<Fn>(fn), **m_Impl };
+			}
+		}
+		return ResultTp{ unexpect, m_Impl.Error() };
+	}
+
+	template <typename Fn>
+	constexpr auto OrElse(Fn&& fn) const {
+		using Utp = std::remove_cvref_t<std::invoke_result_t<Fn, const Err&>>;
+		static_assert(IsSpecializationValOf<Utp, Expected>,
+			"Expected<T&, E>::OrElse(Fn) requires the return type of Fn to be a specialization of Expected");
+		if (m_Impl.HasValue()) {
+			return Utp{ **m_Impl };
+		}
+		return std::invoke(std::forward<Fn>(fn), m_Impl.Error());
+	}
+
+	template <typename Fn>
+	constexpr auto MapError(Fn&& fn) const {
+		using Gtp = std::remove_cv_t<std::invoke_result_t<Fn, const Err&>>;
+		using ResultTp = Expected<Ty&, Gtp>;
+		if (m_Impl.HasValue()) {
+			return ResultTp{ **m_Impl };
+		}
+		return ResultTp{ unexpect, std::invoke(std::forward<Fn>(fn), m_Impl.Error()) };
+	}
+
+private:
+	Expected<Ty*, Err> m_Impl;
+};
+
+template <typename Ty1, typename Err1, typename Ty2, typename Err2>
+[[nodiscard]] constexpr bool operator==(const Expected<Ty1, Err1>& left, const Expected<Ty2, Err2>& right) {
+	if (left.HasValue() != right.HasValue()) {
+		return false;
+	}
+	return left.HasValue() ? *left == *right : left.Error() == right.Error();
+}
+
+template <
+	typename Ty1,
+	typename Err1,
+	typename Ty2,
+	std::enable_if_t<
+		!IsSpecializationValOf<Ty2, Expected> &&
+		!IsSpecializationValOf<Ty2, Unexpected>,
+		int
+	> = 0
+>
+[[nodiscard]] constexpr bool operator==(const Expected<Ty1, Err1>& left, const Ty2& right) {
+	return left.HasValue() && static_cast<bool>(*left == right);
+}
+
+template <typename Ty1, typename Err1, typename Err2>
+[[nodiscard]] constexpr bool operator==(const Expected<Ty1, Err1>& left, const Unexpected<Err2>& right) {
+	return !left.HasValue() && static_cast<bool>(left.Error() == right.Error());
+}
+
+}
@@ -0,0 +1,426 @@
+#ifndef FLATMAP_HPP
+#define FLATMAP_HPP
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "Array.h"
+
+/**
+ * @brief: 基于有序 Potato::Array 的 FlatMap / FlatSet
+ * @note: 1. 键按 Compare 升序保存在连续的 Array 中, FlatMap 的值单独保存在另一个 Array 里 (键值分离),
+ *           查找只扫描键数组, 每条缓存行能放下更多的键.
+ *        2. 查找使用 SearchTools::BranchlessLowerBound, 每一步只是条件选择, 没有难以预测的分支.
+ *        3. 单个 Insert / Erase 需要搬移插入点之后的元素, 是 O(n) 的;
+ *           批量插入请用 InsertRange: 新元素放进临时数组排序, 再与原有元素归并去重, 总共 O(n + m log m).
+ *        4. 与 std::map::insert 相同, 已存在的键不会被覆盖 (InsertOrAssign 除外);
+ *           InsertRange 中重复的键保留第一次出现的.
+ *        5. 任何插入或删除都会使迭代器与 Find 返回的引用失效.
+ */
+namespace Potato {
+	namespace FlatTools {
+		/* 在有序的 keys 中查找 key: 返回下标, 以及该下标处的键是否与 key 等价 */
+		template <typename Key, typename Alloc, typename Key2, typename Compare>
+		[[nodiscard]] constexpr std::pair<std::size_t, bool> Locate(const Array<Key, Alloc>& keys, const Key2& key, const Compare& comp) {
+			const std::size_t index = SearchTools::BranchlessLowerBound(keys.Data(), keys.Size(), key, comp);
+			return { index, index != keys.Size() && !comp(key, keys.Data()[index]) };
+		}
+
+		/**
+		 * @brief: 按键稳定排序之后的下标序列, 等价的键只保留第一次出现的
+		 * @note: 下标数组的分配器由 keys 的分配器 rebind 得到
+		 */
+		template <typename Key, typename Alloc, typename Compare>
+		[[nodiscard]] auto SortedUniqueOrder(const Array<Key, Alloc>& keys, const Compare& comp) {
+			using OrderAllocTp = typename std::allocator_traits<Alloc>::template rebind_alloc<std::size_t>;
+			Array<std::size_t, OrderAllocTp> order{ OrderAllocTp(keys.GetAllocator()) };
+			order.Reserve(keys.Size());
+			for (std::size_t i = 0; i < keys.Size(); ++i) order.Append(i);
+			const Key* data = keys.Data();
+			std::stable_sort(order.begin(), order.end(), [&](const std::size_t lhs, const std::size_t rhs) {
+				return comp(data[lhs], data[rhs]);
+			});
+			auto last = std::unique(order.begin(), order.end(), [&](const std::size_t lhs, const std::size_t rhs) {
+				return !comp(data[lhs], data[rhs]);
+			});
+			order.Erase(last, order.end());
+			return order;
+		}
+	}
+
+	/**
+	 * @brief: 有序的键值映射, 键与值分别保存在两个 Potato::Array 中
+	 * @note: Find 返回 Core::Optional<Value&>; Compare 默认是透明的 std::less<>, 可以用任何能与 Key 比较的类型查找
+	 */
+	template <typename Key, typename Value, typename Compare = std::less<>,
+		typename KeyAllocator = std::allocator<Key>, typename ValueAllocator = std::allocator<Value>>
+	class FlatMap {
+	public:
+		using key_type        = Key;
+		using mapped_type     = Value;
+		using key_compare     = Compare;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using KeyArray        = Array<Key, KeyAllocator>;
+		using ValueArray      = Array<Value, ValueAllocator>;
+
+		/* 迭代器解引用得到 std::pair<const Key&, Value&> 代理, 支持结构化绑定 */
+		template <bool bConst>
+		class Iterator {
+			using M_MapTp = std::conditional_t<bConst, const FlatMap, FlatMap>;
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using difference_type   = std::ptrdiff_t;
+			using value_type        = std::pair<const Key&, std::conditional_t<bConst, const Value&, Value&>>;
+			using reference         = value_type;
+
+			Iterator() = default;
+			Iterator(M_MapTp* map, const size_type index) noexcept : m_Map(map), m_Index(index) {}
+			template <bool bOther> requires (bConst && !bOther)
+			Iterator(const Iterator<bOther>& other) noexcept : m_Map(other.Map()), m_Index(other.Index()) {}
+
+			[[nodiscard]] reference operator*() const noexcept {
+				return { m_Map->m_Keys[m_Index], m_Map->m_Values[m_Index] };
+			}
+			[[nodiscard]] reference operator[](const difference_type offset) const noexcept { return *(*this + offset); }
+
+			Iterator& operator++() noexcept { ++m_Index; return *this; }
+			Iterator operator++(int) noexcept { Iterator temp = *this; ++m_Index; return temp; }
+			Iterator& operator--() noexcept { --m_Index; return *this; }
+			Iterator operator--(int) noexcept { Iterator temp = *this; --m_Index; return temp; }
+			Iterator& operator+=(const difference_type offset) noexcept { m_Index += offset; return *this; }
+			Iterator& operator-=(const difference_type offset) noexcept { m_Index -= offset; return *this; }
+			[[nodiscard]] Iterator operator+(const difference_type offset) const noexcept { return Iterator(m_Map, m_Index + offset); }
+			[[nodiscard]] Iterator operator-(const difference_type offset) const noexcept { return Iterator(m_Map, m_Index - offset); }
+			[[nodiscard]] difference_type operator-(const Iterator& other) const noexcept {
+				return static_cast<difference_type>(m_Index) - static_cast<difference_type>(other.m_Index);
+			}
+			[[nodiscard]] bool operator==(const Iterator& other) const noexcept { return m_Index == other.m_Index; }
+			[[nodiscard]] auto operator<=>(const Iterator& other) const noexcept { return m_Index <=> other.m_Index; }
+
+			[[nodiscard]] M_MapTp* Map() const noexcept { return m_Map; }
+			[[nodiscard]] size_type Index() const noexcept { return m_Index; }
+
+		private:
+			M_MapTp* m_Map{ nullptr };
+			size_type m_Index{ 0 };
+		};
+		using iterator       = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		FlatMap() = default;
+		explicit FlatMap(const Compare& comp) : m_Compare(comp) {}
+		FlatMap(const KeyAllocator& key_allocator, const ValueAllocator& value_allocator)
+			: m_Keys(key_allocator), m_Values(value_allocator) {}
+		FlatMap(const Compare& comp, const KeyAllocator& key_allocator, const ValueAllocator& value_allocator)
+			: m_Keys(key_allocator), m_Values(value_allocator), m_Compare(comp) {}
+		FlatMap(std::initializer_list<std::pair<Key, Value>> list, const Compare& comp = Compare(),
+			const KeyAllocator& key_allocator = KeyAllocator(), const ValueAllocator& value_allocator = ValueAllocator())
+			: m_Keys(key_allocator), m_Values(value_allocator), m_Compare(comp) {
+			InsertRange(list.begin(), list.end());
+		}
+
+	public:
+		[[nodiscard]] size_type Size() const noexcept { return m_Keys.Size(); }
+		[[nodiscard]] bool IsEmpty() const noexcept { return m_Keys.IsEmpty(); }
+		[[nodiscard]] size_type Capacity() const noexcept { return m_Keys.Capacity(); }
+		/* 按键有序的键数组与对应的值数组, 下标一一对应 */
+		[[nodiscard]] const KeyArray& Keys() const noexcept { return m_Keys; }
+		[[nodiscard]] const ValueArray& Values() const noexcept { return m_Values; }
+		[[nodiscard]] ValueArray& Values() noexcept { return m_Values; }
+		[[nodiscard]] KeyAllocator GetKeyAllocator() const noexcept { return m_Keys.GetAllocator(); }
+		[[nodiscard]] ValueAllocator GetValueAllocator() const noexcept { return m_Values.GetAllocator(); }
+
+		void Reserve(const size_type count) {
+			m_Keys.Reserve(count);
+			m_Values.Reserve(count);
+		}
+		void Clear() noexcept {
+			m_Keys.Clear();
+			m_Values.Clear();
+		}
+		void ShrinkToFit() {
+			m_Keys.ShrinkToFit();
+			m_Values.ShrinkToFit();
+		}
+
+		[[nodiscard]] iterator begin() noexcept { return iterator(this, 0); }
+		[[nodiscard]] iterator end() noexcept { return iterator(this, Size()); }
+		[[nodiscard]] const_iterator begin() const noexcept { return const_iterator(this, 0); }
+		[[nodiscard]] const_iterator end() const noexcept { return const_iterator(this, Size()); }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+		template <typename Key2>
+		[[nodiscard]] Core::Optional<Value&> Find(const Key2& key) {
+			const auto [index, found] = FlatTools::Locate(m_Keys, key, m_Compare);
+			if (!found) return Core::nullopt;
+			return m_Values[index];
+		}
+		template <typename Key2>
+		[[nodiscard]] Core::Optional<const Value&> Find(const Key2& key) const {
+			const auto [index, found] = FlatTools::Locate(m_Keys, key, m_Compare);
+			if (!found) return Core::nullopt;
+			return m_Values[index];
+		}
+		template <typename Key2>
+		[[nodiscard]] bool Contains(const Key2& key) const {
+			return FlatTools::Locate(m_Keys, key, m_Compare).second;
+		}
+		/* 第一个不小于 key 的元素的下标, 不存在时为空 */
+		template <typename Key2>
+		[[nodiscard]] Core::Optional<size_type> LowerBound(const Key2& key) const {
+			return m_Keys.LowerBound(key, m_Compare);
+		}
+
+		/* 不存在时抛出 std::out_of_range */
+		template <typename Key2>
+		[[nodiscard]] Value& At(const Key2& key) {
+			return const_cast<Value&>(std::as_const(*this).At(key));
+		}
+		template <typename Key2>
+		[[nodiscard]] const Value& At(const Key2& key) const {
+			const auto [index, found] = FlatTools::Locate(m_Keys, key, m_Compare);
+			if (!found) [[unlikely]] {
+				throw std::out_of_range("FlatMap::At: key not found");
+			}
+			return m_Values[index];
+		}
+
+		/* 不存在时插入值初始化的 Value */
+		Value& operator[](const Key& key) {
+			return m_Values[TryEmplace(key).first.Index()];
+		}
+
+		/* 键已存在时什么都不做, 返回 (位置, 是否插入) */
+		template <typename... Args>
+		std::pair<iterator, bool> TryEmplace(const Key& key, Args&&... args) {
+			const auto [index, found] = FlatTools::Locate(m_Keys, key, m_Compare);
+			if (found) return { iterator(this, index), false };
+			M_InsertAt(index, key, std::forward<Args>(args)...);
+			return { iterator(this, index), true };
+		}
+		std::pair<iterator, bool> Insert(const Key& key, const Value& value) {
+			return TryEmplace(key, value);
+		}
+		template <typename Value2>
+		std::pair<iterator, bool> InsertOrAssign(const Key& key, Value2&& value) {
+			const auto [index, found] = FlatTools::Locate(m_Keys, key, m_Compare);
+			if (found) {
+				m_Values[index] = std::forward<Value2>(value);
+				return { iterator(this, index), false };
+			}
+			M_InsertAt(index, key, std::forward<Value2>(value));
+			return { iterator(this, index), true };
+		}
+
+		/**
+		 * @brief: 批量插入 (key, value) 对, 返回新插入的个数
+		 * @note: 新元素先追加到临时数组, 按键稳定排序并去重, 再与原有元素一次归并: O(n + m log m),
+		 *     而不是逐个 Insert 的 O(n * m). 所有临时数组都用 m_Keys / m_Values 的分配器
+		 */
+		template <typename InputIterator>
+		size_type InsertRange(InputIterator first, InputIterator last) {
+			KeyArray new_keys{ m_Keys.GetAllocator() };
+			ValueArray new_values{ m_Values.GetAllocator() };
+			if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>) {
+				const auto count = static_cast<size_type>(std::distance(first, last));
+				new_keys.Reserve(count);
+				new_values.Reserve(count);
+			}
+			for (; first != last; ++first) {
+				const auto& [key, value] = *first;
+				new_keys.Append(key);
+				new_values.Append(value);
+			}
+			if (new_keys.IsEmpty()) return 0;
+
+			const auto order = FlatTools::SortedUniqueOrder(new_keys, m_Compare);
+			KeyArray keys{ m_Keys.GetAllocator() };
+			ValueArray values{ m_Values.GetAllocator() };
+			keys.Reserve(Size() + order.Size());
+			values.Reserve(Size() + order.Size());
+
+			/**
+			 * 归并: 等价的键保留原有的元素. 只有键和值的移动以及比较都不会抛出时才移动原有元素,
+			 * 否则拷贝它们, 这样归并中途失败时 *this 保持不变 (强异常安全)
+			 */
+			constexpr bool bMoveOld = std::is_nothrow_move_constructible_v<Key> && std::is_nothrow_move_constructible_v<Value>
+				&& std::is_nothrow_invocable_v<const Compare&, const Key&, const Key&>;
+			auto append_old = [&](const size_type index) {
+				if constexpr (bMoveOld) {
+					keys.Append(std::move(m_Keys[index]));
+					values.Append(std::move(m_Values[index]));
+				} else {
+					keys.Append(std::as_const(m_Keys[index]));
+					values.Append(std::as_const(m_Values[index]));
+				}
+			};
+			size_type inserted = 0;
+			size_type old_index = 0;
+			for (const size_type new_index : order) {
+				Key& key = new_keys[new_index];
+				while (old_index < Size() && m_Compare(m_Keys[old_index], key)) {
+					append_old(old_index++);
+				}
+				if (old_index < Size() && !m_Compare(key, m_Keys[old_index])) continue;
+				keys.Append(std::move(key));
+				values.Append(std::move(new_values[new_index]));
+				++inserted;
+			}
+			for (; old_index < Size(); ++old_index) {
+				append_old(old_index);
+			}
+			m_Keys.Swap(keys);
+			m_Values.Swap(values);
+			return inserted;
+		}
+
+		/* 返回删除的元素个数 (0 或 1) */
+		template <typename Key2>
+		size_type Erase(const Key2& key) {
+			const auto [index, found] = FlatTools::Locate(m_Keys, key, m_Compare);
+			if (!found) return 0;
+			m_Keys.EraseAt(index);
+			m_Values.EraseAt(index);
+			return 1;
+		}
+
+	private:
+		template <typename... Args>
+		void M_InsertAt(const size_type index, const Key& key, Args&&... args) {
+			m_Keys.Insert(m_Keys.cbegin() + index, key);
+			try {
+				m_Values.EmplaceAt(index, std::forward<Args>(args)...);
+			} catch (...) {
+				m_Keys.EraseAt(index);
+				throw;
+			}
+		}
+
+		KeyArray m_Keys;
+		ValueArray m_Values;
+		[[no_unique_address]] Compare m_Compare;
+	};
+
+	/**
+	 * @brief: 有序集合, 元素保存在一个有序的 Potato::Array 中
+	 */
+	template <typename Key, typename Compare = std::less<>, typename Allocator = std::allocator<Key>>
+	class FlatSet {
+	public:
+		using key_type       = Key;
+		using value_type     = Key;
+		using key_compare    = Compare;
+		using size_type      = std::size_t;
+		using KeyArray       = Array<Key, Allocator>;
+		using const_iterator = typename KeyArray::const_iterator;
+		using iterator       = const_iterator;
+
+		FlatSet() = default;
+		explicit FlatSet(const Compare& comp) : m_Compare(comp) {}
+		explicit FlatSet(const Allocator& allocator) : m_Keys(allocator) {}
+		FlatSet(const Compare& comp, const Allocator& allocator) : m_Keys(allocator), m_Compare(comp) {}
+		FlatSet(std::initializer_list<Key> list, const Compare& comp = Compare(), const Allocator& allocator = Allocator())
+			: m_Keys(allocator), m_Compare(comp) {
+			InsertRange(list.begin(), list.end());
+		}
+
+	public:
+		[[nodiscard]] size_type Size() const noexcept { return m_Keys.Size(); }
+		[[nodiscard]] bool IsEmpty() const noexcept { return m_Keys.IsEmpty(); }
+		[[nodiscard]] size_type Capacity() const noexcept { return m_Keys.Capacity(); }
+		[[nodiscard]] const KeyArray& Keys() const noexcept { return m_Keys; }
+		[[nodiscard]] Allocator GetAllocator() const noexcept { return m_Keys.GetAllocator(); }
+
+		void Reserve(const size_type count) { m_Keys.Reserve(count); }
+		void Clear() noexcept { m_Keys.Clear(); }
+		void ShrinkToFit() { m_Keys.ShrinkToFit(); }
+
+		[[nodiscard]] const_iterator begin() const noexcept { return m_Keys.begin(); }
+		[[nodiscard]] const_iterator end() const noexcept { return m_Keys.end(); }
+
+		template <typename Key2>
+		[[nodiscard]] bool Contains(const Key2& key) const {
+			return FlatTools::Locate(m_Keys, key, m_Compare).second;
+		}
+		template <typename Key2>
+		[[nodiscard]] Core::Optional<const Key&> Find(const Key2& key) const {
+			const auto [index, found] = FlatTools::Locate(m_Keys, key, m_Compare);
+			if (!found) return Core::nullopt;
+			return m_Keys[index];
+		}
+		template <typename Key2>
+		[[nodiscard]] Core::Optional<size_type> LowerBound(const Key2& key) const {
+			return m_Keys.LowerBound(key, m_Compare);
+		}
+
+		/* 返回是否插入了新元素 */
+		bool Insert(const Key& key) {
+			const auto [index, found] = FlatTools::Locate(m_Keys, key, m_Compare);
+			if (found) return false;
+			m_Keys.Insert(m_Keys.cbegin() + index, key);
+			return true;
+		}
+
+		/**
+		 * @brief: 批量插入, 返回新插入的个数
+		 * @note: 新元素先放进临时数组并稳定排序, 再与原有元素归并去重 (保留原有的) 到另一个临时数组,
+		 *     归并成功后才与 m_Keys 交换: 比较或拷贝中途抛出时 *this 保持不变 (强异常安全)
+		 */
+		template <typename InputIterator>
+		size_type InsertRange(InputIterator first, InputIterator last) {
+			KeyArray new_keys{ m_Keys.GetAllocator() };
+			new_keys.Append(first, last);
+			if (new_keys.IsEmpty()) return 0;
+			std::stable_sort(new_keys.begin(), new_keys.end(), m_Compare);
+
+			KeyArray keys{ m_Keys.GetAllocator() };
+			keys.Reserve(Size() + new_keys.Size());
+			/* 与 FlatMap::InsertRange 相同: 移动与比较都不会抛出时才移动原有元素 */
+			constexpr bool bMoveOld = std::is_nothrow_move_constructible_v<Key>
+				&& std::is_nothrow_invocable_v<const Compare&, const Key&, const Key&>;
+			auto append_old = [&](const size_type index) {
+				if constexpr (bMoveOld) {
+					keys.Append(std::move(m_Keys[index]));
+				} else {
+					keys.Append(std::as_const(m_Keys[index]));
+				}
+			};
+			const size_type old_size = Size();
+			size_type old_index = 0;
+			for (Key& key : new_keys) {
+				while (old_index < old_size && m_Compare(m_Keys[old_index], key)) {
+					append_old(old_index++);
+				}
+				if (old_index < old_size && !m_Compare(key, m_Keys[old_index])) continue;
+				/* keys 有序且末尾不大于 key, 末尾不小于 key 即与 key 等价 (新元素之间的重复) */
+				if (!keys.IsEmpty() && !m_Compare(keys.Back(), key)) continue;
+				keys.Append(std::move(key));
+			}
+			for (; old_index < old_size; ++old_index) {
+				append_old(old_index);
+			}
+			m_Keys.Swap(keys);
+			return Size() - old_size;
+		}
+
+		template <typename Key2>
+		size_type Erase(const Key2& key) {
+			const auto [index, found] = FlatTools::Locate(m_Keys, key, m_Compare);
+			if (!found) return 0;
+			m_Keys.EraseAt(index);
+			return 1;
+		}
+
+	private:
+		KeyArray m_Keys;
+		[[no_unique_address]] Compare m_Compare;
+	};
+}
+
+#endif // FLATMAP_HPP
@@ -0,0 +1,862 @@
+#ifndef HASHMAP_HPP
+#define HASHMAP_HPP
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "Array.h"
+
+/**
+ * @brief: Swiss Table 风格的开放寻址哈希表: Potato::HashMap / Potato::HashSet
+ * @note: 1. 元素直接存放在一整块槽位数组中 (没有 std::unordered_map 的逐节点分配),
+ *           另有一个控制字节数组 (Potato::Array), 每个槽位一个字节:
+ *               Empty   = 0b10000000
+ *               Deleted = 0b11111110
+ *               Full    = 0b0xxxxxxx (哈希值的低 7 位, H2)
+ *        2. 查找时以哈希值的高位 (H1) 决定起始位置, 每次比较一组 (SSE2 下 16 个, 否则 8 个) 控制字节,
+ *           只有 H2 相同的槽位才真正比较键; 一组中出现 Empty 即可停止.
+ *        3. 容量总是 2 的幂, 最大负载 7/8. 控制字节数组末尾多复制了一组开头的字节,
+ *           所以从任意位置开始加载一组都不会越界, 也不需要处理回绕.
+ *        4. 删除只留下墓碑 (Deleted), 扩容或墓碑过多时整体重新散列.
+ *        5. 任何插入都可能使迭代器和 Find 返回的引用失效 (与 Potato::Array 相同), Reserve 之后在预留范围内插入不会.
+ */
+namespace Potato {
+	namespace HashTools {
+		using ControlByte = std::int8_t;
+
+		inline constexpr ControlByte EmptyByte   = static_cast<ControlByte>(-128);
+		inline constexpr ControlByte DeletedByte = static_cast<ControlByte>(-2);
+
+		[[nodiscard]] constexpr bool IsFull(const ControlByte ctrl) noexcept { return ctrl >= 0; }
+
+		/* 一组匹配结果, 每个匹配的位置对应一位 (SSE2) 或一个字节的最高位 (SWAR) */
+		template <int Shift>
+		struct BitMask {
+			std::uint64_t mask;
+
+			[[nodiscard]] constexpr explicit operator bool() const noexcept { return mask != 0; }
+			[[nodiscard]] constexpr std::size_t Lowest() const noexcept {
+				return static_cast<std::size_t>(std::countr_zero(mask)) >> Shift;
+			}
+			constexpr void ClearLowest() noexcept { mask &= mask - 1; }
+		};
+
+#if defined(POTATO_HAVE_SSE2)
+		inline constexpr std::size_t GroupWidth = 16;
+
+		struct Group {
+			__m128i ctrl;
+
+			explicit Group(const ControlByte* pos) noexcept
+				: ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+			[[nodiscard]] BitMask<0> Match(const ControlByte h2) const noexcept {
+				return { static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))) };
+			}
+			[[nodiscard]] BitMask<0> MatchEmpty() const noexcept {
+				return Match(EmptyByte);
+			}
+			/* Full 是唯一最高位为 0 的状态 */
+			[[nodiscard]] BitMask<0> MatchEmptyOrDeleted() const noexcept {
+				return { static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl)) };
+			}
+		};
+#else
+		inline constexpr std::size_t GroupWidth = 8;
+
+		/* 没有 SSE2 时在一个 64 位整数里同时比较 8 个字节 (SWAR) */
+		struct Group {
+			static constexpr std::uint64_t Lsbs = 0x0101010101010101ull;
+			static constexpr std::uint64_t Msbs = 0x8080808080808080ull;
+			std::uint64_t ctrl;
+
+			explicit Group(const ControlByte* pos) noexcept {
+				std::memcpy(&ctrl, pos, sizeof(ctrl));
+				if constexpr (std::endian::native == std::endian::big) {
+					ctrl = std::byteswap(ctrl);
+				}
+			}
+
+			/* 可能有假阳性 (之后总会比较键), 不会有假阴性 */
+			[[nodiscard]] BitMask<3> Match(const ControlByte h2) const noexcept {
+				const std::uint64_t x = ctrl ^ (Lsbs * static_cast<std::uint8_t>(h2));
+				return { (x - Lsbs) & ~x & Msbs };
+			}
+			/* Empty 与 Deleted 的区别在第 1 位 */
+			[[nodiscard]] BitMask<3> MatchEmpty() const noexcept {
+				return { ctrl & ~(ctrl << 6) & Msbs };
+			}
+			[[nodiscard]] BitMask<3> MatchEmptyOrDeleted() const noexcept {
+				return { ctrl & Msbs };
+			}
+		};
+#endif
+
+		/**
+		 * @brief: 打散哈希值: std::hash 对整数通常是恒等映射, 低 7 位 (H2) 与高位 (H1) 都需要充分混合
+		 */
+		[[nodiscard]] constexpr std::size_t Mix(const std::size_t hash) noexcept {
+#if defined(__SIZEOF_INT128__)
+			const auto product = static_cast<unsigned __int128>(hash) * 0x9E3779B97F4A7C15ull;
+			return static_cast<std::size_t>(static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64));
+#else
+			std::uint64_t x = hash;
+			x ^= x >> 33;
+			x *= 0xFF51AFD7ED558CCDull;
+			x ^= x >> 33;
+			return static_cast<std::size_t>(x);
+#endif
+		}
+		[[nodiscard]] constexpr std::size_t H1(const std::size_t hash) noexcept { return hash >> 7; }
+		[[nodiscard]] constexpr ControlByte H2(const std::size_t hash) noexcept { return static_cast<ControlByte>(hash & 0x7F); }
+
+		/* 最大负载 7/8 */
+		[[nodiscard]] constexpr std::size_t MaxLoad(const std::size_t capacity) noexcept {
+			return capacity - capacity / 8;
+		}
+		/* 能容纳 count 个元素的最小容量 (2 的幂, 至少一组) */
+		[[nodiscard]] constexpr std::size_t CapacityFor(const std::size_t count) noexcept {
+			if (count == 0) return 0;
+			std::size_t capacity = std::bit_ceil(std::max(count + count / 7, GroupWidth));
+			while (MaxLoad(capacity) < count) capacity *= 2;
+			return capacity;
+		}
+
+		/* 以组为单位的三角数探测序列: 容量是 2 的幂时会访问到每一组 */
+		struct ProbeSequence {
+			std::size_t mask;
+			std::size_t offset;
+			std::size_t index{ 0 };
+
+			constexpr ProbeSequence(const std::size_t hash, const std::size_t capacity) noexcept
+				: mask(capacity - 1), offset(H1(hash) & (capacity - 1)) {}
+
+			[[nodiscard]] constexpr std::size_t Offset(const std::size_t i) const noexcept { return (offset + i) & mask; }
+			constexpr void Next() noexcept {
+				index += GroupWidth;
+				offset = (offset + index) & mask;
+			}
+		};
+
+		template <typename Ty>
+		inline constexpr bool IsTransparentVal = requires { typename Ty::is_transparent; };
+
+		/* HashMap<Key, Value> 的槽位保存 std::pair<const Key, Value> */
+		template <typename Key, typename Value>
+		struct MapPolicy {
+			using key_type  = Key;
+			using slot_type = std::pair<const Key, Value>;
+			[[nodiscard]] static constexpr const Key& KeyOf(const slot_type& slot) noexcept { return slot.first; }
+		};
+		/* HashSet<Key> 的槽位就是键本身 */
+		template <typename Key>
+		struct SetPolicy {
+			using key_type  = Key;
+			using slot_type = Key;
+			[[nodiscard]] static constexpr const Key& KeyOf(const slot_type& slot) noexcept { return slot; }
+		};
+	}
+
+	/**
+	 * @brief: 默认的哈希函数: std::hash, 对字符串额外支持异构查找 (std::string_view / const char*)
+	 */
+	template <typename Key>
+	struct DefaultHash : std::hash<Key> {};
+
+	template <typename CharT, typename Traits, typename Alloc>
+	struct DefaultHash<std::basic_string<CharT, Traits, Alloc>> {
+		using is_transparent = void;
+		[[nodiscard]] std::size_t operator()(const std::basic_string_view<CharT, Traits> value) const noexcept {
+			return std::hash<std::basic_string_view<CharT, Traits>>{}(value);
+		}
+	};
+
+	template <typename Ty, bool bConst>
+	class HashTableIterator {
+		template <typename, bool> friend class HashTableIterator;
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type        = Ty;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = std::conditional_t<bConst, const Ty*, Ty*>;
+		using reference         = std::conditional_t<bConst, const Ty&, Ty&>;
+
+		HashTableIterator() = default;
+		HashTableIterator(const HashTools::ControlByte* ctrl, const HashTools::ControlByte* last, Ty* slot) noexcept
+			: m_Ctrl(ctrl), m_Last(last), m_Slot(slot) { M_SkipEmpty(); }
+		/* iterator -> const_iterator */
+		template <bool bOther> requires (bConst && !bOther)
+		HashTableIterator(const HashTableIterator<Ty, bOther>& other) noexcept
+			: m_Ctrl(other.m_Ctrl), m_Last(other.m_Last), m_Slot(other.m_Slot) {}
+
+		[[nodiscard]] reference operator*() const noexcept { return *m_Slot; }
+		[[nodiscard]] pointer operator->() const noexcept { return m_Slot; }
+
+		HashTableIterator& operator++() noexcept {
+			++m_Ctrl;
+			++m_Slot;
+			M_SkipEmpty();
+			return *this;
+		}
+		HashTableIterator operator++(int) noexcept {
+			HashTableIterator temp = *this;
+			++*this;
+			return temp;
+		}
+
+		template <bool bOther>
+		[[nodiscard]] bool operator==(const HashTableIterator<Ty, bOther>& other) const noexcept {
+			return m_Ctrl == other.m_Ctrl;
+		}
+
+	private:
+		void M_SkipEmpty() noexcept {
+			while (m_Ctrl != m_Last && !HashTools::IsFull(*m_Ctrl)) {
+				++m_Ctrl;
+				++m_Slot;
+			}
+		}
+
+		const HashTools::ControlByte* m_Ctrl{ nullptr };
+		const HashTools::ControlByte* m_Last{ nullptr };
+		Ty* m_Slot{ nullptr };
+	};
+
+	/**
+	 * @brief: HashMap 与 HashSet 的公共实现
+	 * @note: 哈希函数, 键比较与分配器都是空类时不占空间 (MemoryTools::CompressedPair).
+	 *     控制字节存放在 Potato::Array 中; 槽位是一块未初始化的内存, 用 rebind 之后的分配器分配.
+	 */
+	template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+	class HashTable {
+	protected:
+		using M_SlotTp           = typename Policy::slot_type;
+		using M_SlotAllocatorTp  = typename std::allocator_traits<Allocator>::template rebind_alloc<M_SlotTp>;
+		using M_SlotTraits       = std::allocator_traits<M_SlotAllocatorTp>;
+		using M_CtrlAllocatorTp  = typename std::allocator_traits<Allocator>::template rebind_alloc<HashTools::ControlByte>;
+		using M_CtrlArrayTp      = Array<HashTools::ControlByte, M_CtrlAllocatorTp>;
+		using M_HashAllocatorTp  = typename std::allocator_traits<Allocator>::template rebind_alloc<std::size_t>;
+		using M_HashArrayTp      = Array<std::size_t, M_HashAllocatorTp>;
+
+		static constexpr bool M_IsTransparentVal = HashTools::IsTransparentVal<Hash> && HashTools::IsTransparentVal<KeyEqual>;
+		static constexpr bool M_IsRelocatableVal = MemoryTools::UseTrivialRelocateVal<M_SlotAllocatorTp>;
+	public:
+		using key_type        = typename Policy::key_type;
+		using value_type      = M_SlotTp;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using hasher          = Hash;
+		using key_equal       = KeyEqual;
+		using allocator_type  = Allocator;
+		using reference       = value_type&;
+		using const_reference = const value_type&;
+		using iterator        = HashTableIterator<value_type, false>;
+		using const_iterator  = HashTableIterator<value_type, true>;
+
+		HashTable() : HashTable(Hash(), KeyEqual(), Allocator()) {}
+		explicit HashTable(const Hash& hash, const KeyEqual& equal = KeyEqual(), const Allocator& allocator = Allocator())
+			: m_Data(MemoryTools::OneConstructCompressedTag{}, hash,
+				MemoryTools::OneConstructCompressedTag{}, equal,
+				MemoryTools::OneConstructCompressedTag{}, M_SlotAllocatorTp(allocator), M_CtrlAllocatorTp(allocator)) {}
+
+		HashTable(const HashTable& other)
+			: HashTable(other.M_GetHasher(), other.M_GetKeyEqual(),
+				Allocator(M_SlotTraits::select_on_container_copy_construction(other.M_GetAllocator())))
+		{
+			M_InsertAllFrom(other);
+		}
+		HashTable(HashTable&& other) noexcept
+			: m_Data(MemoryTools::OneConstructCompressedTag{}, std::move(other.M_GetHasher()),
+				MemoryTools::OneConstructCompressedTag{}, std::move(other.M_GetKeyEqual()),
+				MemoryTools::OneConstructCompressedTag{}, std::move(other.M_GetAllocator()), M_CtrlAllocatorTp(other.M_GetAllocator()))
+		{
+			M_Steal(other);
+		}
+		/**
+		 * @note: 与 Array::operator= 相同, 遵守 propagate_on_container_copy/move_assignment.
+		 *     副本先在目标分配器下建好再接管, 所以拷贝赋值失败时 *this 保持不变;
+		 *     移动时分配器不传播且不相等, 不能接管对方的槽位, 逐个元素在自己的存储中重建
+		 */
+		HashTable& operator=(const HashTable& other) {
+			if (this == &other) {
+				return *this;
+			}
+			constexpr bool bPropagate = M_SlotTraits::propagate_on_container_copy_assignment::value;
+			HashTable copy(other.M_GetHasher(), other.M_GetKeyEqual(),
+				Allocator(bPropagate ? other.M_GetAllocator() : M_GetAllocator()));
+			copy.M_InsertAllFrom(other);
+			M_DestroyAll();
+			M_Deallocate();
+			if constexpr (bPropagate) {
+				M_ResetAllocator(other.M_GetAllocator());
+			}
+			M_GetHasher() = std::move(copy.M_GetHasher());
+			M_GetKeyEqual() = std::move(copy.M_GetKeyEqual());
+			M_Steal(copy);
+			return *this;
+		}
+		HashTable& operator=(HashTable&& other)
+			noexcept(M_SlotTraits::propagate_on_container_move_assignment::value || M_SlotTraits::is_always_equal::value)
+		{
+			if (this == &other) {
+				return *this;
+			}
+			if constexpr (!M_SlotTraits::propagate_on_container_move_assignment::value) {
+				if (M_GetAllocator() != other.M_GetAllocator()) {
+					HashTable rebuilt(other.M_GetHasher(), other.M_GetKeyEqual(), Allocator(M_GetAllocator()));
+					rebuilt.M_InsertAllFrom(std::move(other));
+					other.M_DestroyAll();
+					other.M_Deallocate();
+					M_DestroyAll();
+					M_Deallocate();
+					M_GetHasher() = std::move(rebuilt.M_GetHasher());
+					M_GetKeyEqual() = std::move(rebuilt.M_GetKeyEqual());
+					M_Steal(rebuilt);
+					return *this;
+				}
+			}
+			M_DestroyAll();
+			M_Deallocate();
+			if constexpr (M_SlotTraits::propagate_on_container_move_assignment::value) {
+				M_ResetAllocator(std::move(other.M_GetAllocator()));
+			}
+			M_GetHasher() = std::move(other.M_GetHasher());
+			M_GetKeyEqual() = std::move(other.M_GetKeyEqual());
+			M_Steal(other);
+			return *this;
+		}
+		~HashTable() {
+			M_DestroyAll();
+			M_Deallocate();
+		}
+
+	public:
+		[[nodiscard]] size_type Size() const noexcept { return M_Storage().size; }
+		[[nodiscard]] bool IsEmpty() const noexcept { return M_Storage().size == 0; }
+		/* 槽位数, 可容纳的元素数是 Capacity() * 7 / 8 */
+		[[nodiscard]] size_type Capacity() const noexcept { return M_Storage().capacity; }
+		[[nodiscard]] hasher HashFunction() const { return M_GetHasher(); }
+		[[nodiscard]] key_equal KeyEq() const { return M_GetKeyEqual(); }
+		[[nodiscard]] allocator_type GetAllocator() const { return allocator_type(M_GetAllocator()); }
+
+		/**
+		 * @brief: 与 Array::Reserve 相同的语义: 之后插入到 count 个元素之前不会再重新散列
+		 * @note: 从不缩小; 墓碑过多时即使容量足够也会原地重新散列一次
+		 */
+		void Reserve(const size_type count) {
+			auto& storage = M_Storage();
+			if (count <= storage.size + storage.growth_left) return;
+			M_Rehash(std::max(storage.capacity, HashTools::CapacityFor(count)));
+		}
+
+		/* 析构所有元素, 保留容量 */
+		void Clear() noexcept {
+			auto& storage = M_Storage();
+			if (storage.capacity == 0) return;
+			M_DestroyAll();
+			std::fill(storage.ctrl.begin(), storage.ctrl.end(), HashTools::EmptyByte);
+			storage.size = 0;
+			storage.growth_left = HashTools::MaxLoad(storage.capacity);
+		}
+
+		/* 与标准容器相同: 分配器不随 swap 传播时, 两边的分配器必须相等 */
+		void Swap(HashTable& other) noexcept {
+			using std::swap;
+			swap(M_GetHasher(), other.M_GetHasher());
+			swap(M_GetKeyEqual(), other.M_GetKeyEqual());
+			if constexpr (M_SlotTraits::propagate_on_container_swap::value) {
+				swap(M_GetAllocator(), other.M_GetAllocator());
+			} else {
+				assert(M_GetAllocator() == other.M_GetAllocator() && "HashTable::Swap: allocators must compare equal");
+			}
+			auto& lhs = M_Storage();
+			auto& rhs = other.M_Storage();
+			lhs.ctrl.Swap(rhs.ctrl);
+			swap(lhs.slots, rhs.slots);
+			swap(lhs.size, rhs.size);
+			swap(lhs.capacity, rhs.capacity);
+			swap(lhs.growth_left, rhs.growth_left);
+		}
+
+		[[nodiscard]] iterator begin() noexcept {
+			auto& storage = M_Storage();
+			return iterator(storage.ctrl.Data(), storage.ctrl.Data() + storage.capacity, storage.slots);
+		}
+		[[nodiscard]] iterator end() noexcept {
+			auto& storage = M_Storage();
+			const auto* last = storage.ctrl.Data() + storage.capacity;
+			return iterator(last, last, storage.slots + storage.capacity);
+		}
+		[[nodiscard]] const_iterator begin() const noexcept {
+			auto& storage = M_Storage();
+			return const_iterator(storage.ctrl.Data(), storage.ctrl.Data() + storage.capacity, storage.slots);
+		}
+		[[nodiscard]] const_iterator end() const noexcept {
+			auto& storage = M_Storage();
+			const auto* last = storage.ctrl.Data() + storage.capacity;
+			return const_iterator(last, last, storage.slots + storage.capacity);
+		}
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+		[[nodiscard]] bool Contains(const key_type& key) const {
+			return M_FindIndex(key) != M_NotFound;
+		}
+		template <typename Key2> requires M_IsTransparentVal
+		[[nodiscard]] bool Contains(const Key2& key) const {
+			return M_FindIndex(key) != M_NotFound;
+		}
+
+		/* 返回删除的元素个数 (0 或 1) */
+		size_type Erase(const key_type& key) {
+			return M_EraseKey(key);
+		}
+		template <typename Key2> requires M_IsTransparentVal && (!std::is_convertible_v<const Key2&, const_iterator>)
+		size_type Erase(const Key2& key) {
+			return M_EraseKey(key);
+		}
+		/* 删除 position 处的元素, 返回下一个元素 (删除不会移动其他元素) */
+		iterator Erase(iterator position) {
+			return Erase(const_iterator(position));
+		}
+		iterator Erase(const_iterator position) {
+			auto& storage = M_Storage();
+			const auto index = static_cast<size_type>(&*position - storage.slots);
+			M_EraseAt(index);
+			return iterator(storage.ctrl.Data() + index + 1, storage.ctrl.Data() + storage.capacity, storage.slots + index + 1);
+		}
+
+	protected:
+		static constexpr size_type M_NotFound = static_cast<size_type>(-1);
+
+		struct M_StorageTp {
+			explicit M_StorageTp(const M_CtrlAllocatorTp& allocator) : ctrl(allocator) {}
+
+			M_CtrlArrayTp ctrl;              // capacity + GroupWidth 个字节, 末尾一组复制开头一组
+			M_SlotTp* slots{ nullptr };
+			size_type size{ 0 };
+			size_type capacity{ 0 };
+			size_type growth_left{ 0 };      // 不触发重新散列还能占用的 Empty 槽位数
+		};
+
+		[[nodiscard]] Hash& M_GetHasher() noexcept { return m_Data.GetFirst(); }
+		[[nodiscard]] const Hash& M_GetHasher() const noexcept { return m_Data.GetFirst(); }
+		[[nodiscard]] KeyEqual& M_GetKeyEqual() noexcept { return m_Data.data.GetFirst(); }
+		[[nodiscard]] const KeyEqual& M_GetKeyEqual() const noexcept { return m_Data.data.GetFirst(); }
+		[[nodiscard]] M_SlotAllocatorTp& M_GetAllocator() noexcept { return m_Data.data.data.GetFirst(); }
+		[[nodiscard]] const M_SlotAllocatorTp& M_GetAllocator() const noexcept { return m_Data.data.data.GetFirst(); }
+		[[nodiscard]] M_StorageTp& M_Storage() noexcept { return m_Data.data.data.data; }
+		[[nodiscard]] const M_StorageTp& M_Storage() const noexcept { return m_Data.data.data.data; }
+
+		template <typename Key2>
+		[[nodiscard]] size_type M_Hash(const Key2& key) const {
+			return HashTools::Mix(M_GetHasher()(key));
+		}
+
+		template <typename Key2>
+		[[nodiscard]] size_type M_FindIndex(const Key2& key) const {
+			return M_FindIndex(key, M_Hash(key));
+		}
+		template <typename Key2>
+		[[nodiscard]] size_type M_FindIndex(const Key2& key, const size_type hash) const {
+			const auto& storage = M_Storage();
+			if (storage.capacity == 0) return M_NotFound;
+			const HashTools::ControlByte* ctrl = storage.ctrl.Data();
+			const HashTools::ControlByte h2 = HashTools::H2(hash);
+			HashTools::ProbeSequence probe(hash, storage.capacity);
+			while (true) {
+				const HashTools::Group group(ctrl + probe.offset);
+				for (auto match = group.Match(h2); match; match.ClearLowest()) {
+					const size_type index = probe.Offset(match.Lowest());
+					if (M_GetKeyEqual()(Policy::KeyOf(storage.slots[index]), key)) [[likely]] {
+						return index;
+					}
+				}
+				if (group.MatchEmpty()) return M_NotFound;
+				probe.Next();
+			}
+		}
+
+		/* 探测序列上第一个 Empty 或 Deleted 的槽位 (负载 < 1 保证存在) */
+		[[nodiscard]] size_type M_FindFirstNonFull(const size_type hash) const noexcept {
+			const auto& storage = M_Storage();
+			HashTools::ProbeSequence probe(hash, storage.capacity);
+			while (true) {
+				const auto match = HashTools::Group(storage.ctrl.Data() + probe.offset).MatchEmptyOrDeleted();
+				if (match) return probe.Offset(match.Lowest());
+				probe.Next();
+			}
+		}
+
+		void M_SetCtrl(const size_type index, const HashTools::ControlByte value) noexcept {
+			auto& storage = M_Storage();
+			HashTools::ControlByte* ctrl = storage.ctrl.Data();
+			ctrl[index] = value;
+			/* 开头一组的字节同时写入末尾的副本 */
+			if (index < HashTools::GroupWidth) {
+				ctrl[storage.capacity + index] = value;
+			}
+		}
+
+		/**
+		 * @brief: 为一个确定不存在的键找到槽位并占用, 返回槽位下标, 元素由调用者构造
+		 * @note: 需要占用 Empty 槽位但 growth_left 为 0 时先重新散列: 墓碑超过一半时保持容量, 否则容量翻倍
+		 */
+		[[nodiscard]] size_type M_PrepareInsert(const size_type hash) {
+			auto& storage = M_Storage();
+			size_type index = storage.capacity == 0 ? 0 : M_FindFirstNonFull(hash);
+			if (storage.capacity == 0 || (storage.growth_left == 0 && storage.ctrl[index] == HashTools::EmptyByte)) {
+				const size_type capacity = storage.capacity;
+				if (capacity != 0 && storage.size < HashTools::MaxLoad(capacity) / 2) {
+					M_Rehash(capacity);
+				} else {
+					M_Rehash(capacity == 0 ? HashTools::GroupWidth : capacity * 2);
+				}
+				index = M_FindFirstNonFull(hash);
+			}
+			if (storage.ctrl[index] == HashTools::EmptyByte) {
+				--storage.growth_left;
+			}
+			M_SetCtrl(index, HashTools::H2(hash));
+			++storage.size;
+			return index;
+		}
+
+		/* 构造失败时把 M_PrepareInsert 占用的槽位还原为墓碑 */
+		template <typename... Args>
+		size_type M_EmplaceUnique(const size_type hash, Args&&... args) {
+			const size_type index = M_PrepareInsert(hash);
+			auto& storage = M_Storage();
+			try {
+				M_SlotTraits::construct(M_GetAllocator(), storage.slots + index, std::forward<Args>(args)...);
+			} catch (...) {
+				M_SetCtrl(index, HashTools::DeletedByte);
+				--storage.size;
+				throw;
+			}
+			return index;
+		}
+
+		/* 不存在时用 args 构造, 返回 (下标, 是否插入) */
+		template <typename Key2, typename... Args>
+		std::pair<size_type, bool> M_FindOrEmplace(const Key2& key, Args&&... args) {
+			const size_type hash = M_Hash(key);
+			if (const size_type found = M_FindIndex(key, hash); found != M_NotFound) {
+				return { found, false };
+			}
+			return { M_EmplaceUnique(hash, std::forward<Args>(args)...), true };
+		}
+
+		template <typename Key2>
+		size_type M_EraseKey(const Key2& key) {
+			const size_type index = M_FindIndex(key);
+			if (index == M_NotFound) return 0;
+			M_EraseAt(index);
+			return 1;
+		}
+
+		void M_EraseAt(const size_type index) noexcept {
+			auto& storage = M_Storage();
+			M_SlotTraits::destroy(M_GetAllocator(), storage.slots + index);
+			M_SetCtrl(index, HashTools::DeletedByte);
+			--storage.size;
+		}
+
+		/**
+		 * @brief: 分配 new_capacity 个槽位并把所有元素重新散列进去, 同时清除墓碑
+		 * @note: 先计算所有元素的哈希值 (哈希函数可能抛异常), 这一步失败时什么都还没有搬运, 原表保持不变.
+		 *     之后的搬运不再调用哈希函数: 可平凡重定位的元素直接 memcpy, 不会失败;
+		 *     否则使用 move_if_noexcept, 只有拷贝才可能抛异常, 此时析构已经构造的副本, 原表中的元素未被移动.
+		 */
+		void M_Rehash(const size_type new_capacity) {
+			auto& storage = M_Storage();
+			auto& allocator = M_GetAllocator();
+			const size_type old_capacity = storage.capacity;
+			M_SlotTp* old_slots = storage.slots;
+
+			M_HashArrayTp hashes{ M_HashAllocatorTp(allocator) };
+			hashes.Reserve(storage.size);
+			for (size_type i = 0; i < old_capacity; ++i) {
+				if (HashTools::IsFull(storage.ctrl[i])) hashes.Append(M_Hash(Policy::KeyOf(old_slots[i])));
+			}
+
+			/* 显式传入重绑定的分配器, 再 Resize 填充 */
+			M_CtrlArrayTp new_ctrl{ M_CtrlAllocatorTp(allocator) };
+			new_ctrl.Resize(new_capacity + HashTools::GroupWidth, HashTools::EmptyByte);
+			M_SlotTp* new_slots = M_SlotTraits::allocate(allocator, new_capacity);
+
+			M_CtrlArrayTp old_ctrl{ M_CtrlAllocatorTp(allocator) };
+			old_ctrl.Swap(storage.ctrl);
+			storage.ctrl.Swap(new_ctrl);
+			storage.slots = new_slots;
+			storage.capacity = new_capacity;
+
+			size_type moved = 0;
+			try {
+				for (size_type i = 0; i < old_capacity; ++i) {
+					if (!HashTools::IsFull(old_ctrl[i])) continue;
+					const size_type hash = hashes[moved];
+					const size_type index = M_FindFirstNonFull(hash);
+					if constexpr (M_IsRelocatableVal) {
+						std::memcpy(static_cast<void*>(new_slots + index), static_cast<const void*>(old_slots + i), sizeof(M_SlotTp));
+					} else {
+						M_SlotTraits::construct(allocator, new_slots + index, std::move_if_noexcept(old_slots[i]));
+					}
+					M_SetCtrl(index, HashTools::H2(hash));
+					++moved;
+				}
+			} catch (...) {
+				/* 只有拷贝构造会走到这里 (memcpy 与 noexcept 移动不会抛出): 析构已经构造的副本, 恢复原表 */
+				for (size_type i = 0; i < new_capacity; ++i) {
+					if (HashTools::IsFull(storage.ctrl[i])) M_SlotTraits::destroy(allocator, new_slots + i);
+				}
+				M_SlotTraits::deallocate(allocator, new_slots, new_capacity);
+				storage.ctrl.Swap(old_ctrl);
+				storage.slots = old_slots;
+				storage.capacity = old_capacity;
+				throw;
+			}
+
+			if constexpr (!M_IsRelocatableVal) {
+				for (size_type i = 0; i < old_capacity; ++i) {
+					if (HashTools::IsFull(old_ctrl[i])) M_SlotTraits::destroy(allocator, old_slots + i);
+				}
+			}
+			if (old_slots) {
+				M_SlotTraits::deallocate(allocator, old_slots, old_capacity);
+			}
+			storage.growth_left = HashTools::MaxLoad(new_capacity) - moved;
+		}
+
+		void M_DestroyAll() noexcept {
+			auto& storage = M_Storage();
+			if constexpr (!std::is_trivially_destructible_v<M_SlotTp>) {
+				for (size_type i = 0; i < storage.capacity; ++i) {
+					if (HashTools::IsFull(storage.ctrl[i])) M_SlotTraits::destroy(M_GetAllocator(), storage.slots + i);
+				}
+			}
+		}
+
+		void M_Deallocate() noexcept {
+			auto& storage = M_Storage();
+			if (storage.slots) {
+				M_SlotTraits::deallocate(M_GetAllocator(), storage.slots, storage.capacity);
+			}
+			storage.slots = nullptr;
+			storage.capacity = 0;
+			storage.size = 0;
+			storage.growth_left = 0;
+			storage.ctrl.Clear();
+		}
+
+		/* 把 other 的所有元素插入到空表中; other 为右值时移动元素 */
+		template <typename Self>
+		void M_InsertAllFrom(Self&& other) {
+			Reserve(other.Size());
+			for (auto& slot : other) {
+				if constexpr (std::is_lvalue_reference_v<Self>) {
+					M_EmplaceUnique(M_Hash(Policy::KeyOf(slot)), slot);
+				} else {
+					M_EmplaceUnique(M_Hash(Policy::KeyOf(slot)), std::move(slot));
+				}
+			}
+		}
+
+		/* 调用前存储已释放; 槽位与控制字节的分配器一起换成 allocator */
+		template <typename SlotAllocator>
+		void M_ResetAllocator(SlotAllocator&& allocator) {
+			auto& ctrl = M_Storage().ctrl;
+			std::destroy_at(&ctrl);
+			std::construct_at(&ctrl, M_CtrlAllocatorTp(allocator));
+			M_GetAllocator() = std::forward<SlotAllocator>(allocator);
+		}
+
+		void M_Steal(HashTable& other) noexcept {
+			auto& storage = M_Storage();
+			auto& source = other.M_Storage();
+			storage.ctrl.Swap(source.ctrl);
+			storage.slots = std::exchange(source.slots, nullptr);
+			storage.size = std::exchange(source.size, 0);
+			storage.capacity = std::exchange(source.capacity, 0);
+			storage.growth_left = std::exchange(source.growth_left, 0);
+		}
+
+	private:
+		MemoryTools::CompressedPair<Hash,
+			MemoryTools::CompressedPair<KeyEqual,
+				MemoryTools::CompressedPair<M_SlotAllocatorTp, M_StorageTp>>> m_Data;
+	};
+
+	/**
+	 * @brief: 开放寻址的哈希映射, 接口风格与 Potato::Array 一致
+	 * @note: Find 返回 Core::Optional<Value&>, 不存在时为空;
+	 *     哈希函数与键比较都声明了 is_transparent 时 (默认的字符串哈希 + std::equal_to<> 即是),
+	 *     Find / Contains / Erase 可以直接用 std::string_view 或 const char* 查找 std::string 键
+	 */
+	template <typename Key, typename Value, typename Hash = DefaultHash<Key>, typename KeyEqual = std::equal_to<>,
+		typename Allocator = std::allocator<std::pair<const Key, Value>>>
+	class HashMap : public HashTable<HashTools::MapPolicy<Key, Value>, Hash, KeyEqual, Allocator> {
+		using M_BaseTp = HashTable<HashTools::MapPolicy<Key, Value>, Hash, KeyEqual, Allocator>;
+		using M_BaseTp::M_IsTransparentVal;
+		using M_BaseTp::M_NotFound;
+	public:
+		using mapped_type = Value;
+		using typename M_BaseTp::key_type;
+		using typename M_BaseTp::value_type;
+		using typename M_BaseTp::size_type;
+		using typename M_BaseTp::iterator;
+		using typename M_BaseTp::const_iterator;
+
+		using M_BaseTp::M_BaseTp;
+		HashMap() = default;
+		HashMap(std::initializer_list<value_type> list, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+			const Allocator& allocator = Allocator())
+			: M_BaseTp(hash, equal, allocator)
+		{
+			this->Reserve(list.size());
+			for (const auto& item : list) Insert(item);
+		}
+
+		[[nodiscard]] Core::Optional<Value&> Find(const key_type& key) {
+			return M_MappedAt(this->M_FindIndex(key));
+		}
+		[[nodiscard]] Core::Optional<const Value&> Find(const key_type& key) const {
+			return M_MappedAt(this->M_FindIndex(key));
+		}
+		template <typename Key2> requires M_IsTransparentVal
+		[[nodiscard]] Core::Optional<Value&> Find(const Key2& key) {
+			return M_MappedAt(this->M_FindIndex(key));
+		}
+		template <typename Key2> requires M_IsTransparentVal
+		[[nodiscard]] Core::Optional<const Value&> Find(const Key2& key) const {
+			return M_MappedAt(this->M_FindIndex(key));
+		}
+
+		/* 不存在时抛出 std::out_of_range */
+		[[nodiscard]] Value& At(const key_type& key) {
+			return const_cast<Value&>(std::as_const(*this).At(key));
+		}
+		[[nodiscard]] const Value& At(const key_type& key) const {
+			const size_type index = this->M_FindIndex(key);
+			if (index == M_NotFound) [[unlikely]] {
+				throw std::out_of_range("HashMap::At: key not found");
+			}
+			return this->M_Storage().slots[index].second;
+		}
+
+		/* 不存在时插入值初始化的 Value */
+		Value& operator[](const key_type& key) {
+			return TryEmplace(key).first->second;
+		}
+		Value& operator[](key_type&& key) {
+			return TryEmplace(std::move(key)).first->second;
+		}
+
+		/* 键已存在时什么都不做 (args 不会被移走), 返回 (元素, 是否插入) */
+		template <typename... Args>
+		std::pair<iterator, bool> TryEmplace(const key_type& key, Args&&... args) {
+			const auto [index, inserted] = this->M_FindOrEmplace(key,
+				std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+			return { M_IteratorAt(index), inserted };
+		}
+		template <typename... Args>
+		std::pair<iterator, bool> TryEmplace(key_type&& key, Args&&... args) {
+			const auto [index, inserted] = this->M_FindOrEmplace(key,
+				std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+			return { M_IteratorAt(index), inserted };
+		}
+
+		std::pair<iterator, bool> Insert(const value_type& item) {
+			const auto [index, inserted] = this->M_FindOrEmplace(item.first, item);
+			return { M_IteratorAt(index), inserted };
+		}
+		std::pair<iterator, bool> Insert(value_type&& item) {
+			const auto [index, inserted] = this->M_FindOrEmplace(item.first, std::move(item));
+			return { M_IteratorAt(index), inserted };
+		}
+
+		/* 键已存在时赋值, 否则插入 */
+		template <typename Value2>
+		std::pair<iterator, bool> InsertOrAssign(const key_type& key, Value2&& value) {
+			auto result = TryEmplace(key, std::forward<Value2>(value));
+			if (!result.second) result.first->second = std::forward<Value2>(value);
+			return result;
+		}
+		template <typename Value2>
+		std::pair<iterator, bool> InsertOrAssign(key_type&& key, Value2&& value) {
+			auto result = TryEmplace(std::move(key), std::forward<Value2>(value));
+			if (!result.second) result.first->second = std::forward<Value2>(value);
+			return result;
+		}
+
+	private:
+		[[nodiscard]] Core::Optional<Value&> M_MappedAt(const size_type index) noexcept {
+			if (index == M_NotFound) return Core::nullopt;
+			return this->M_Storage().slots[index].second;
+		}
+		[[nodiscard]] Core::Optional<const Value&> M_MappedAt(const size_type index) const noexcept {
+			if (index == M_NotFound) return Core::nullopt;
+			return this->M_Storage().slots[index].second;
+		}
+		[[nodiscard]] iterator M_IteratorAt(const size_type index) noexcept {
+			auto& storage = this->M_Storage();
+			return iterator(storage.ctrl.Data() + index, storage.ctrl.Data() + storage.capacity, storage.slots + index);
+		}
+	};
+
+	/**
+	 * @brief: 开放寻址的哈希集合, 与 HashMap 共用实现; Array::Intersection / Union / Difference 基于它实现
+	 */
+	template <typename Key, typename Hash = DefaultHash<Key>, typename KeyEqual = std::equal_to<>, typename Allocator = std::allocator<Key>>
+	class HashSet : public HashTable<HashTools::SetPolicy<Key>, Hash, KeyEqual, Allocator> {
+		using M_BaseTp = HashTable<HashTools::SetPolicy<Key>, Hash, KeyEqual, Allocator>;
+		using M_BaseTp::M_IsTransparentVal;
+		using M_BaseTp::M_NotFound;
+	public:
+		using typename M_BaseTp::key_type;
+		using typename M_BaseTp::size_type;
+
+		using M_BaseTp::M_BaseTp;
+		HashSet() = default;
+		HashSet(std::initializer_list<Key> list, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+			const Allocator& allocator = Allocator())
+			: M_BaseTp(hash, equal, allocator)
+		{
+			this->Reserve(list.size());
+			for (const auto& item : list) Insert(item);
+		}
+
+		/* 返回是否插入了新元素 */
+		bool Insert(const Key& key) {
+			return this->M_FindOrEmplace(key, key).second;
+		}
+		bool Insert(Key&& key) {
+			return this->M_FindOrEmplace(key, std::move(key)).second;
+		}
+
+		[[nodiscard]] Core::Optional<const Key&> Find(const key_type& key) const {
+			return M_KeyAt(this->M_FindIndex(key));
+		}
+		template <typename Key2> requires M_IsTransparentVal
+		[[nodiscard]] Core::Optional<const Key&> Find(const Key2& key) const {
+			return M_KeyAt(this->M_FindIndex(key));
+		}
+
+	private:
+		[[nodiscard]] Core::Optional<const Key&> M_KeyAt(const size_type index) const noexcept {
+			if (index == M_NotFound) return Core::nullopt;
+			return this->M_Storage().slots[index];
+		}
+	};
+}
+
+#endif // HASHMAP_HPP
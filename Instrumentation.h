@@ -0,0 +1,227 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+/**
+ * @brief: Potato 容器的内存统计, 默认关闭
+ * @note: 两个互相独立的开关:
+ * 		1. CountingAllocator<T, Tag>: 包装任意分配器, 统计 allocate / deallocate 的次数与字节数,
+ * 		   以及同时存活的最大字节数. 用法: Potato::Array<int, Potato::Instrumentation::CountingAllocator<int>>
+ * 		2. 编译期开关 POTATO_ENABLE_INSTRUMENTATION: Array 在每次扩容 (M_Relocate / M_InsertHoles /
+ * 		   M_AppendRange / Reserve) 时记录扩容次数, 搬运的元素数, 最大容量以及扩容之后的空闲槽位 (Slack).
+ * 		   未定义时这些钩子展开为空语句.
+ * 		统计按 Tag 归类 (默认是元素类型), 所有记录挂在一个全局的无锁链表上, TakeSnapshot() 可以在任意时刻读取.
+ * 		计数器都是 relaxed 原子操作, 快照中各字段之间不保证一致.
+ */
+namespace Potato::Instrumentation {
+	struct Snapshot {
+		const char* name;
+		std::uint64_t allocations;
+		std::uint64_t deallocations;
+		std::uint64_t allocated_bytes;
+		std::uint64_t deallocated_bytes;
+		std::uint64_t live_bytes;
+		std::uint64_t peak_live_bytes;
+		std::uint64_t growth_events;
+		std::uint64_t moved_elements;
+		std::uint64_t peak_capacity;
+		std::uint64_t growth_slack;   // 每次扩容之后 capacity - size 的累计值, 除以 growth_events 即平均空闲槽位
+	};
+
+	struct Record {
+		explicit Record(const char* name) noexcept;
+		Record(const Record&) = delete;
+		Record& operator=(const Record&) = delete;
+
+		[[nodiscard]] Snapshot Load() const noexcept {
+			constexpr auto relaxed = std::memory_order_relaxed;
+			return Snapshot{
+				name,
+				allocations.load(relaxed),
+				deallocations.load(relaxed),
+				allocated_bytes.load(relaxed),
+				deallocated_bytes.load(relaxed),
+				live_bytes.load(relaxed),
+				peak_live_bytes.load(relaxed),
+				growth_events.load(relaxed),
+				moved_elements.load(relaxed),
+				peak_capacity.load(relaxed),
+				growth_slack.load(relaxed),
+			};
+		}
+
+		/**
+		 * @brief: 清零累计计数器
+		 * @note: live_bytes 是仍然存活的内存, 不能清零: 否则 Reset 之前分配的内存释放时会减成负数.
+		 *     峰值从当前存活的字节数重新开始统计
+		 */
+		void Reset() noexcept {
+			constexpr auto relaxed = std::memory_order_relaxed;
+			for (auto* counter : { &allocations, &deallocations, &allocated_bytes, &deallocated_bytes,
+				&growth_events, &moved_elements, &peak_capacity, &growth_slack }) {
+				counter->store(0, relaxed);
+			}
+			peak_live_bytes.store(live_bytes.load(relaxed), relaxed);
+		}
+
+		const char* name;
+		std::atomic<std::uint64_t> allocations{ 0 };
+		std::atomic<std::uint64_t> deallocations{ 0 };
+		std::atomic<std::uint64_t> allocated_bytes{ 0 };
+		std::atomic<std::uint64_t> deallocated_bytes{ 0 };
+		std::atomic<std::uint64_t> live_bytes{ 0 };
+		std::atomic<std::uint64_t> peak_live_bytes{ 0 };
+		std::atomic<std::uint64_t> growth_events{ 0 };
+		std::atomic<std::uint64_t> moved_elements{ 0 };
+		std::atomic<std::uint64_t> peak_capacity{ 0 };
+		std::atomic<std::uint64_t> growth_slack{ 0 };
+		Record* next{ nullptr };
+	};
+
+	/* 全局记录链表的表头, 记录只会被插入, 不会被删除 */
+	inline std::atomic<Record*>& RecordHead() noexcept {
+		static std::atomic<Record*> head{ nullptr };
+		return head;
+	}
+
+	inline Record::Record(const char* name) noexcept : name(name) {
+		auto& head = RecordHead();
+		next = head.load(std::memory_order_relaxed);
+		while (!head.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed)) {}
+	}
+
+	/* 每个 Tag 一条记录, 第一次使用时注册 */
+	template <typename Tag>
+	Record& RecordOf() noexcept {
+		static Record record(typeid(Tag).name());
+		return record;
+	}
+
+	inline void AtomicMax(std::atomic<std::uint64_t>& target, const std::uint64_t value) noexcept {
+		std::uint64_t current = target.load(std::memory_order_relaxed);
+		while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+	}
+
+	inline void RecordAllocate(Record& record, const std::uint64_t bytes) noexcept {
+		constexpr auto relaxed = std::memory_order_relaxed;
+		record.allocations.fetch_add(1, relaxed);
+		record.allocated_bytes.fetch_add(bytes, relaxed);
+		const std::uint64_t live = record.live_bytes.fetch_add(bytes, relaxed) + bytes;
+		AtomicMax(record.peak_live_bytes, live);
+	}
+
+	inline void RecordDeallocate(Record& record, const std::uint64_t bytes) noexcept {
+		constexpr auto relaxed = std::memory_order_relaxed;
+		record.deallocations.fetch_add(1, relaxed);
+		record.deallocated_bytes.fetch_add(bytes, relaxed);
+		record.live_bytes.fetch_sub(bytes, relaxed);
+	}
+
+	template <typename Tag>
+	void RecordGrowth(const std::size_t new_capacity, const std::size_t new_size, const std::size_t moved) noexcept {
+		constexpr auto relaxed = std::memory_order_relaxed;
+		Record& record = RecordOf<Tag>();
+		record.growth_events.fetch_add(1, relaxed);
+		record.moved_elements.fetch_add(moved, relaxed);
+		record.growth_slack.fetch_add(new_capacity > new_size ? new_capacity - new_size : 0, relaxed);
+		AtomicMax(record.peak_capacity, new_capacity);
+	}
+
+	/* 容器记录扩容事件时使用的 Tag: 分配器声明了 InstrumentationTag 就用它, 否则用元素类型 */
+	template <typename Alloc, typename = void>
+	struct AllocatorTag {
+		using Type = typename Alloc::value_type;
+	};
+	template <typename Alloc>
+	struct AllocatorTag<Alloc, std::void_t<typename Alloc::InstrumentationTag>> {
+		using Type = typename Alloc::InstrumentationTag;
+	};
+	template <typename Alloc>
+	using AllocatorTagTp = typename AllocatorTag<Alloc>::Type;
+
+	/* 所有已注册记录的快照, 顺序与注册顺序相反 */
+	[[nodiscard]] inline std::vector<Snapshot> TakeSnapshot() {
+		std::vector<Snapshot> result;
+		for (Record* record = RecordHead().load(std::memory_order_acquire); record; record = record->next) {
+			result.push_back(record->Load());
+		}
+		return result;
+	}
+
+	inline void ResetAll() noexcept {
+		for (Record* record = RecordHead().load(std::memory_order_acquire); record; record = record->next) {
+			record->Reset();
+		}
+	}
+
+	/**
+	 * @brief: 统计分配行为的分配器, 真正的分配交给 BaseAllocator
+	 * @note: 没有 construct / destroy 成员, Array 对平凡类型的 memcpy / memset 批量路径不受影响;
+	 *     rebind 之后 Tag 不变, 所以 Array 内部的各种 rebind 都计入同一条记录
+	 */
+	template <typename Ty, typename Tag = Ty, typename BaseAllocator = std::allocator<Ty>>
+	class CountingAllocator {
+		using M_BaseTp = typename std::allocator_traits<BaseAllocator>::template rebind_alloc<Ty>;
+		using M_BaseTraits = std::allocator_traits<M_BaseTp>;
+
+		template <typename, typename, typename>
+		friend class CountingAllocator;
+	public:
+		using value_type = Ty;
+		using InstrumentationTag = Tag;
+		using size_type = typename M_BaseTraits::size_type;
+		using difference_type = typename M_BaseTraits::difference_type;
+		using propagate_on_container_copy_assignment = typename M_BaseTraits::propagate_on_container_copy_assignment;
+		using propagate_on_container_move_assignment = typename M_BaseTraits::propagate_on_container_move_assignment;
+		using propagate_on_container_swap = typename M_BaseTraits::propagate_on_container_swap;
+		using is_always_equal = typename M_BaseTraits::is_always_equal;
+
+		template <typename Uty>
+		struct rebind {
+			using other = CountingAllocator<Uty, Tag, BaseAllocator>;
+		};
+
+		CountingAllocator() = default;
+		explicit CountingAllocator(const M_BaseTp& base) noexcept : m_Base(base) {}
+		template <typename Uty>
+		CountingAllocator(const CountingAllocator<Uty, Tag, BaseAllocator>& other) noexcept : m_Base(other.m_Base) {}
+
+		[[nodiscard]] Ty* allocate(const size_type count) {
+			Ty* result = M_BaseTraits::allocate(m_Base, count);
+			RecordAllocate(RecordOf<Tag>(), static_cast<std::uint64_t>(count) * sizeof(Ty));
+			return result;
+		}
+
+		void deallocate(Ty* pointer, const size_type count) noexcept {
+			RecordDeallocate(RecordOf<Tag>(), static_cast<std::uint64_t>(count) * sizeof(Ty));
+			M_BaseTraits::deallocate(m_Base, pointer, count);
+		}
+
+		[[nodiscard]] size_type max_size() const noexcept {
+			return M_BaseTraits::max_size(m_Base);
+		}
+
+		template <typename Uty>
+		[[nodiscard]] bool operator==(const CountingAllocator<Uty, Tag, BaseAllocator>& other) const noexcept {
+			return m_Base == other.m_Base;
+		}
+
+	private:
+		[[no_unique_address]] M_BaseTp m_Base;
+	};
+}
+
+#if defined(POTATO_ENABLE_INSTRUMENTATION)
+#  define POTATO_RECORD_GROWTH(Ty, new_capacity, new_size, moved) \
+	::Potato::Instrumentation::RecordGrowth<Ty>((new_capacity), (new_size), (moved))
+#else
+#  define POTATO_RECORD_GROWTH(Ty, new_capacity, new_size, moved) ((void)0)
+#endif
+
+#endif // INSTRUMENTATION_HPP
@@ -1,10 +1,14 @@
 #pragma once
 #include <algorithm>
+#include <bit>
 #include <compare>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <memory>
 #include <optional>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include "TraitsTools.hpp"
@@ -21,8 +25,8 @@ struct ConstructFromInvokeResultTag{
 struct NulloptTp{
 	/* 防止直接从 {} 就能构造出 NulloptTp */
 	explicit NulloptTp() = default;
-	friend bool operator==(NulloptTp, std::nullopt_t) { return true; }
-    friend bool operator==(std::nullopt_t, NulloptTp) { return true; }
+	friend constexpr bool operator==(NulloptTp, std::nullopt_t) noexcept { return true; }
+	friend constexpr bool operator==(std::nullopt_t, NulloptTp) noexcept { return true; }
 };
 
 inline constexpr NulloptTp nullopt{};
@@ -32,9 +36,107 @@ struct NonTrivialDummyTp {
 	constexpr NonTrivialDummyTp() noexcept{} 
 };
 
-template <typename Ty, bool = std::is_trivially_destructible_v<Ty>>
+/*
+ * @function: Optional 的 niche (哨兵值) 定制点
+ * @note: 如果类型 Ty 存在一个正常使用中不会出现的值 (哨兵), Optional<Ty> 就可以用这个值表示 "空",
+ *     从而省掉额外的 bHasValue 标志位, 使 sizeof(Optional<Ty>) == sizeof(Ty).
+ *     特化需要提供:
+ *         static constexpr bool HasNiche = true;
+ *         static constexpr Ty EmptyValue() noexcept;           // 构造哨兵值
+ *         static constexpr bool IsEmpty(const Ty&) noexcept;   // 判断是否为哨兵值
+ * @note: 1. 空的 Optional 内部始终存活着一个哨兵对象, 所以哨兵的析构必须没有副作用 (比如空的智能指针)
+ *        2. 向 Optional 中放入哨兵值本身等价于放入 nullopt, 例如 Optional<std::unique_ptr<T>>{ nullptr } 为空
+ *        3. 可选的 static constexpr bool IsReservedNiche = true 声明哨兵不是 Ty 的合法值 (默认 false).
+ *           Expected / Variant 只对这样的类型使用 niche, 否则哨兵本身 (空智能指针, NaN) 会被当成错误或另一个候选
+ */
+template <typename Ty>
+struct OptionalTraits {
+	static constexpr bool HasNiche = false;
+};
+
+/*
+ * @function: 用一个编译期常量作为哨兵, 适用于枚举和整数:
+ *     enum class Color : std::uint8_t { Red, Green, Blue, Invalid = 0xFF };
+ *     template <> struct Core::OptionalTraits<Color> : Core::OptionalSentinelTraits<Color, Color::Invalid, true> {};
+ * @note: 哨兵永远不会作为值出现时 bReserved 传 true, Expected / Variant 也会使用这个 niche
+ */
+template <typename Ty, Ty Sentinel, bool bReserved = false>
+struct OptionalSentinelTraits {
+	static constexpr bool HasNiche = true;
+	static constexpr bool IsReservedNiche = bReserved;
+	static constexpr Ty EmptyValue() noexcept {
+		return Sentinel;
+	}
+	static constexpr bool IsEmpty(const Ty& value) noexcept {
+		return value == Sentinel;
+	}
+};
+
+/*
+ * @function: 浮点数使用一个特定 payload 的 quiet NaN 作为哨兵
+ * @note: 按位比较, 运算产生的 NaN (payload 为 0) 仍然是合法的值, 只有这个特定的 bit pattern 表示空
+ */
+template <typename Ty, typename BitsTp, BitsTp Payload>
+struct OptionalNaNTraits {
+	static_assert(sizeof(Ty) == sizeof(BitsTp));
+	static constexpr bool HasNiche = true;
+	static constexpr Ty EmptyValue() noexcept {
+		return std::bit_cast<Ty>(Payload);
+	}
+	static constexpr bool IsEmpty(const Ty& value) noexcept {
+		return std::bit_cast<BitsTp>(value) == Payload;
+	}
+};
+
+template <>
+struct OptionalTraits<float> : OptionalNaNTraits<float, std::uint32_t, 0x7FC0'DEADu> {};
+template <>
+struct OptionalTraits<double> : OptionalNaNTraits<double, std::uint64_t, 0x7FF8'0000'0000'DEADull> {};
+
+template <typename Ty, typename Deleter>
+struct OptionalTraits<std::unique_ptr<Ty, Deleter>> {
+	static constexpr bool HasNiche = std::is_empty_v<Deleter> && std::is_nothrow_default_constructible_v<Deleter>;
+	static constexpr std::unique_ptr<Ty, Deleter> EmptyValue() noexcept {
+		return std::unique_ptr<Ty, Deleter>{};
+	}
+	static constexpr bool IsEmpty(const std::unique_ptr<Ty, Deleter>& value) noexcept {
+		return value == nullptr;
+	}
+};
+
+template <typename Ty>
+struct OptionalTraits<std::shared_ptr<Ty>> {
+	static constexpr bool HasNiche = true;
+	static std::shared_ptr<Ty> EmptyValue() noexcept {
+		return std::shared_ptr<Ty>{};
+	}
+	/* aliasing 构造出来的 "空指针但持有控制块" 的 shared_ptr 仍然是一个值, 否则会泄漏控制块 */
+	static bool IsEmpty(const std::shared_ptr<Ty>& value) noexcept {
+		return value == nullptr && value.use_count() == 0;
+	}
+};
+
+template <typename Ty>
+constexpr bool HasOptionalNicheVal = OptionalTraits<std::remove_cv_t<Ty>>::HasNiche;
+
+/* 哨兵不是 Ty 的合法值, 不只 Optional, 任何 "T 或者别的状态" 的类型都可以借用这个 niche */
+template <typename Ty>
+constexpr bool HasReservedNicheVal = [] {
+	using TraitsTp = OptionalTraits<std::remove_cv_t<Ty>>;
+	if constexpr (requires { TraitsTp::IsReservedNiche; }) {
+		return TraitsTp::HasNiche && TraitsTp::IsReservedNiche;
+	} else {
+		return false;
+	}
+}();
+
+template <
+	typename Ty, 
+	bool = std::is_trivially_destructible_v<Ty>, 
+	bool = HasOptionalNicheVal<Ty>
+>
 struct OptionDestruct {
-	static_assert(!IsPointerVal<Ty>, "The type Ty should not be a pointer, pls use smart ptr");
+	static_assert(!std::is_pointer_v<Ty>, "The type Ty should not be a pointer, pls use smart ptr");
 	union {
 		/* 如果你用 char 会触发零初始化机制, 导致最后多生成一条指令 */
 		NonTrivialDummyTp dummy;
@@ -74,17 +176,20 @@ struct OptionDestruct {
 	*/
 	
 	
-	void __Cleanup() noexcept {
+	constexpr void __Cleanup() noexcept {
 		bHasValue = false;
 	}
 	
-	bool HasValue() const noexcept {
+	constexpr bool HasValue() const noexcept {
 		return bHasValue;
 	}
-	void SetValue(bool bHasValue) noexcept {
+	constexpr void SetValue(bool bHasValue) noexcept {
 		this->bHasValue = bHasValue;
 	}
 private:
+	template <typename>
+	friend struct OptionalLayout;
+
 	bool bHasValue;
 };
 
@@ -93,8 +198,8 @@ private:
  */
 
 template <typename Ty>
-struct OptionDestruct<Ty, false>{
-	static_assert(!IsPointerVal<Ty>, "The type Ty should not be a pointer, pls use smart ptr");
+struct OptionDestruct<Ty, false, false>{
+	static_assert(!std::is_pointer_v<Ty>, "The type Ty should not be a pointer, pls use smart ptr");
 	union {
 		/* 如果你用 char 会触发零初始化机制, 导致最后多生成一条指令 */
 		NonTrivialDummyTp dummy;
@@ -171,23 +276,80 @@ struct OptionDestruct<Ty, false>{
     //     }
     //     return *this;
     // }
-	void __Cleanup() noexcept{
+	constexpr void __Cleanup() noexcept{
 		if (bHasValue) {
 			value.~Ty();
 		}	
 		bHasValue = false;
 	}
 
-	bool HasValue() const noexcept {
+	constexpr bool HasValue() const noexcept {
 		return bHasValue;
 	}
-	void SetValue(bool bHasValue) noexcept {
+	constexpr void SetValue(bool bHasValue) noexcept {
 		this->bHasValue = bHasValue;
 	}
 private:
 	bool bHasValue;
 };
 
+/*
+ * @function: 存在 niche 的类型, 是否有值编码在 value 自身里, 没有 bHasValue
+ * @note: 空的时候 value 中存放的是 OptionalTraits<Ty>::EmptyValue(), 所以 value 始终是存活的对象;
+ *     平凡析构的类型不声明析构函数, 保持 OptionDestruct 的平凡性, 交给 AutoControlSMF 决定其余的 SMF
+ */
+template <typename Ty, bool bTrivialDestructible>
+struct OptionDestruct<Ty, bTrivialDestructible, true> {
+	static_assert(!std::is_pointer_v<Ty>, "The type Ty should not be a pointer, pls use smart ptr");
+	using NicheTraitsTp = OptionalTraits<std::remove_cv_t<Ty>>;
+	union {
+		NonTrivialDummyTp dummy;
+		std::remove_cv_t<Ty> value;
+	};
+
+	constexpr OptionDestruct() noexcept : value(NicheTraitsTp::EmptyValue()) {}
+
+	template <typename Fn, typename Uty>
+	constexpr OptionDestruct(ConstructFromInvokeResultTag, Fn&& fn, Uty&& arg)
+		noexcept(
+			noexcept(
+				static_cast<Ty>(std::invoke(std::forward<Fn>(fn),  std::forward<Uty>(arg)))
+			)
+		)
+		: value(std::invoke(std::forward<Fn>(fn), std::forward<Uty>(arg))) {}
+
+	template <typename... Types>
+	constexpr explicit OptionDestruct(std::in_place_t, Types&&... Args)
+		noexcept(std::is_nothrow_constructible_v<Ty, Types...>)
+		: value(std::forward<Types>(Args)...) {}
+
+	/* C++20: 用 requires 区分平凡/非平凡析构, 平凡的情况下析构函数仍然是平凡的 */
+	~OptionDestruct() requires bTrivialDestructible = default;
+	constexpr ~OptionDestruct() requires (!bTrivialDestructible) {
+		value.~Ty();
+	}
+	OptionDestruct(const OptionDestruct& other) = default;
+	OptionDestruct& operator=(const OptionDestruct& other) = default;
+	OptionDestruct(OptionDestruct&& other) = default;
+	OptionDestruct& operator=(OptionDestruct&& other) = default;
+
+	/* 把 value 重置为哨兵 */
+	constexpr void __Cleanup() noexcept {
+		if constexpr (bTrivialDestructible) {
+			std::construct_at(&value, NicheTraitsTp::EmptyValue());
+		} else if (HasValue()) {
+			value.~Ty();
+			std::construct_at(&value, NicheTraitsTp::EmptyValue());
+		}
+	}
+
+	constexpr bool HasValue() const noexcept {
+		return !NicheTraitsTp::IsEmpty(value);
+	}
+	/* 是否有值由 value 自身决定, __Construct 之后无需额外记录 */
+	constexpr void SetValue(bool) noexcept {}
+};
+
 
 template <typename Ty>
 struct OptionConstruct : OptionDestruct<Ty> {
@@ -260,6 +422,9 @@ struct OptionConstruct : OptionDestruct<Ty> {
 		return std::move(this->value);
 	}
 };
+template <typename Source, typename... Stages>
+class OptionalChain;
+
 // 暂时取消继承: private Traits::AutoControlSMF<OptionConstruct<Ty>, Ty>;
 // using MyBaseClassTp = Traits::AutoControlSMF<OptionConstruct<Ty>, Ty>;
 // 意义好像不大
@@ -280,6 +445,8 @@ public:
 	static_assert(std::is_object_v<Ty> && std::is_destructible_v<Ty> && !std::is_array_v<Ty>, "Optional types must be object, destructible and not array");
 
 	using ValueType = Ty;
+	/* 负载可重定位时 Optional 也可重定位, Array 扩容时直接 memcpy */
+	using TriviallyRelocatableTp = Traits::TriviallyRelocatableIfTp<Ty>;
 
 	constexpr Optional() noexcept {}
 	constexpr Optional(NulloptTp)  noexcept {}
@@ -407,7 +574,7 @@ public:
 			int
 		> = 0
 	>
-	CONSTEXPR20 explicit(!std::is_convertible_v<const Ty2&, Ty>) Optional (const Optional<Ty2>& that)
+	constexpr explicit(!std::is_convertible_v<const Ty2&, Ty>) Optional (const Optional<Ty2>& that)
 		noexcept(std::is_nothrow_constructible_v<Ty, const Ty2&>) 
 	{
 		if (that){
@@ -426,7 +593,7 @@ public:
 			int
 		> = 0
 	>
-	CONSTEXPR20 explicit(!std::is_convertible_v<const Ty2&, Ty>) Optional (Optional<Ty2>&& that)
+	constexpr explicit(!std::is_convertible_v<const Ty2&, Ty>) Optional (Optional<Ty2>&& that)
 		noexcept(std::is_nothrow_constructible_v<Ty, Ty2>) 
 	{
 		if (that){
@@ -434,12 +601,12 @@ public:
 		}
 	}
 
-	CONSTEXPR20 Optional& operator=(NulloptTp) noexcept {
+	constexpr Optional& operator=(NulloptTp) noexcept {
 		this->__Cleanup();
 		return *this;
 	}
 
-	CONSTEXPR20 Optional& operator=(std::nullopt_t) noexcept {
+	constexpr Optional& operator=(std::nullopt_t) noexcept {
 		this->__Cleanup();
 		return *this;
 	}
@@ -464,7 +631,7 @@ public:
 			int
 		> = 0
 	>
-	CONSTEXPR20 Optional& operator=(Ty2&& right)
+	constexpr Optional& operator=(Ty2&& right)
 		noexcept(
 			std::is_nothrow_assignable_v<Ty&, Ty2> && 
 			std::is_nothrow_constructible_v<Ty, Ty2>
@@ -496,20 +663,20 @@ public:
 			int
 		> = 0
 	>
-	CONSTEXPR20 Optional& operator=(const Optional<Ty2>& that)
+	constexpr Optional& operator=(const Optional<Ty2>& that)
 		noexcept(std::is_nothrow_assignable_v<Ty&, const Ty2&>) 
 	{
 		if (that){
 			this->__Assign(*that);
 		}
 		else{
-			__Cleanup();
+			this->__Cleanup();
 		}
 		return *this;
 	}
 public:
 	template <typename ...Types>
-	CONSTEXPR20 Ty& Some(Types&&... args)
+	constexpr Ty& Some(Types&&... args)
 		noexcept(std::is_nothrow_constructible_v<Ty, Types...>)
 	{
 		this->__Cleanup();
@@ -528,7 +695,7 @@ public:
 			int 
 		> = 0
 	>
-	CONSTEXPR20 Ty& Some(
+	constexpr Ty& Some(
 		std::initializer_list<Elem> list,  
 		Types&&... args
 	) noexcept (
@@ -542,7 +709,11 @@ public:
 		return this->__Construct(list, std::forward<Types>(args)...);
 	}
 
-	CONSTEXPR20 void Swap(Optional& that) 
+	constexpr void Reset() noexcept {
+		this->__Cleanup();
+	}
+
+	constexpr void Swap(Optional& that) 
 		noexcept(
 			std::is_nothrow_move_constructible_v<Ty> && 
 			std::is_nothrow_swappable_v<Ty>
@@ -553,7 +724,8 @@ public:
 				"Optional<T>::Swap requires Ty to be swappable"
 			);
 		}else{
-			static_assert(false,
+			/* GCC 12 之前 static_assert(false) 在未实例化的分支里也会触发, 需要依赖模板参数 */
+			static_assert(!std::is_same_v<Ty, Ty>,
 				"Optional<T>::Swap requires Ty to be move constructible"
 			);
 		}
@@ -562,9 +734,11 @@ public:
 			std::swap(static_cast<TrivialBaseTp&>(*this), static_cast<TrivialBaseTp&>(that));
 		}else{
 			const bool Engaged = this->HasValue();
-			if (Engaged){
-				using std::swap;
-				swap(**this, *that);
+			if (Engaged == that.HasValue()){
+				if (Engaged) {
+					using std::swap;
+					swap(**this, *that);
+				}
 			}else{
 				Optional& source = Engaged ? *this : that;
 				Optional& target = Engaged ? that : *this;
@@ -620,7 +794,7 @@ public:
 	}
 public:
 	template <typename Ty2 = std::remove_cv_t<Ty>>
-	[[nodiscard]] constexpr Ty&& ValueOr(Ty2&& that) && {
+	[[nodiscard]] constexpr std::remove_cv_t<Ty> ValueOr(Ty2&& that) && {
 		static_assert(std::is_convertible_v<const Ty&, std::remove_cv_t<Ty>>,
             "The const overload of Optioanal::ValueOr requires const T& to be convertible to remove_cv_t<Ty> "
         );
@@ -633,7 +807,7 @@ public:
 		return static_cast<std::remove_cv_t<Ty>>(std::forward<Ty2>(that));
 	}
 	template <typename Ty2 = std::remove_cv_t<Ty>>
-	[[nodiscard]] constexpr Ty&& ValueOr(Ty2&& that) const & {
+	[[nodiscard]] constexpr std::remove_cv_t<Ty> ValueOr(Ty2&& that) const & {
 		static_assert(std::is_convertible_v<const Ty&, std::remove_cv_t<Ty>>,
             "The const overload of Optioanal::ValueOr requires const T& to be convertible to remove_cv_t<Ty> "
         );
@@ -698,10 +872,10 @@ public:
 	template <typename Fn>
 	constexpr auto Map(Fn&& fn) & {
 		using Utp = std::remove_cv_t<std::invoke_result_t<Fn, Ty&>>;
-		static_assert(IsAnyValOf<Utp, std::nullopt_t, std::in_place_t>, 
+		static_assert(!IsAnyValOf<Utp, std::nullopt_t, std::in_place_t>, 
 			"Optional<T>::Map(Fn) requires the return type of Fn to be neither std:: nor std::in_place_t"
 		);
-		static_assert(IsAnyValOf<Utp, NulloptTp, std::in_place_t>, 
+		static_assert(!IsAnyValOf<Utp, NulloptTp, std::in_place_t>, 
 			"Optional<T>::Map(Fn) requires the return type of Fn to be neither NulloptTp nor std::in_place_t"
 		);
 		static_assert(std::is_object_v<Utp> && !std::is_array_v<Utp>, 
@@ -721,10 +895,10 @@ public:
 	template <typename Fn>
 	constexpr auto Map(Fn&& fn) const & {
 		using Utp = std::remove_cv_t<std::invoke_result_t<Fn, const Ty&>>;
-		static_assert(IsAnyValOf<Utp, std::nullopt_t, std::in_place_t>, 
+		static_assert(!IsAnyValOf<Utp, std::nullopt_t, std::in_place_t>, 
 			"Optional<T>::Map(Fn) requires the return type of Fn to be neither std::nullopt_t nor std::in_place_t"
 		);
-		static_assert(IsAnyValOf<Utp, NulloptTp, std::in_place_t>, 
+		static_assert(!IsAnyValOf<Utp, NulloptTp, std::in_place_t>, 
 			"Optional<T>::Map(Fn) requires the return type of Fn to be neither NulloptTp nor std::in_place_t"
 		);
 		static_assert(std::is_object_v<Utp>  && !std::is_array_v<Utp>, 
@@ -745,10 +919,10 @@ public:
 	template <typename Fn>
 	constexpr auto Map(Fn&& fn) && {
 		using Utp = std::remove_cv_t<std::invoke_result_t<Fn, Ty>>;
-		static_assert(IsAnyValOf<Utp, std::nullopt_t, std::in_place_t>, 
+		static_assert(!IsAnyValOf<Utp, std::nullopt_t, std::in_place_t>, 
 			"Optional<T>::Map(Fn) requires the return type of Fn to be neither std::nullopt_t nor std::in_place_t"
 		);
-		static_assert(IsAnyValOf<Utp, NulloptTp, std::in_place_t>, 
+		static_assert(!IsAnyValOf<Utp, NulloptTp, std::in_place_t>, 
 			"Optional<T>::Map(Fn) requires the return type of Fn to be neither NulloptTp nor std::in_place_t"
 		);
 		static_assert(std::is_object_v<Utp>  && !std::is_array_v<Utp>, 
@@ -769,10 +943,10 @@ public:
 	template <typename Fn>
 	constexpr auto Map(Fn&& fn) const && {
 		using Utp = std::remove_cv_t<std::invoke_result_t<Fn, Ty>>;
-		static_assert(IsAnyValOf<Utp, std::nullopt_t, std::in_place_t>, 
+		static_assert(!IsAnyValOf<Utp, std::nullopt_t, std::in_place_t>, 
 			"Optional<T>::Map(Fn) requires the return type of Fn to be neither std::nullopt_t nor std::in_place_t"
 		);
-		static_assert(IsAnyValOf<Utp, NulloptTp, std::in_place_t>, 
+		static_assert(!IsAnyValOf<Utp, NulloptTp, std::in_place_t>, 
 			"Optional<T>::Map(Fn) requires the return type of Fn to be neither NulloptTp nor std::in_place_t"
 		);
 		static_assert(std::is_object_v<Utp>  && !std::is_array_v<Utp>, 
@@ -794,7 +968,7 @@ public:
 	template <typename Fn,
 		typename = std::enable_if_t<
 			std::is_copy_constructible_v<Ty> &&
-			std::is_invocable_v<Fn, Ty>
+			std::is_invocable_v<Fn>
 		>
 	>
 	constexpr auto OrElse(Fn&& fn) & {
@@ -819,7 +993,7 @@ public:
 	template <typename Fn,
 		typename = std::enable_if_t<
 			std::is_move_constructible_v<Ty> &&
-			std::is_invocable_v<Fn, Ty>
+			std::is_invocable_v<Fn>
 		>
 	>
 	constexpr auto OrElse(Fn&& fn) && {
@@ -851,14 +1025,13 @@ public:
 			int
 		> = 0
 	>
-	CONSTEXPR20 auto OrElse (const Optional<Ty2>& that)
+	constexpr auto OrElse (const Optional<Ty2>& that)
 		noexcept(std::is_nothrow_constructible_v<Ty, const Ty2&>) 
 	{
-		if (this->HasValue()){
+		if (this->HasValue() || !that.HasValue()){
 			return *this;
-		} else {
-			this->__Construct(*that);
 		}
+		return Optional{ std::in_place, *that };
 	}
 
 	template <
@@ -906,11 +1079,363 @@ public:
 		}
 	}
 
+	/*
+	 * @function: 惰性的链式调用, 见 OptionalChain
+	 *     auto result = opt.Lazy().Map(f).AndThen(g).Map(h).Collect();
+	 */
+	[[nodiscard]] constexpr OptionalChain<Optional&> Lazy() & noexcept {
+		return OptionalChain<Optional&>{ *this };
+	}
+	[[nodiscard]] constexpr OptionalChain<const Optional&> Lazy() const & noexcept {
+		return OptionalChain<const Optional&>{ *this };
+	}
+	[[nodiscard]] constexpr OptionalChain<Optional> Lazy() && 
+		noexcept(std::is_nothrow_move_constructible_v<Optional>)
+	{
+		return OptionalChain<Optional>{ std::move(*this) };
+	}
+
 	constexpr auto Filter(){}
 
 	constexpr auto ToList(){}
 };
 
+/*
+ * @function: 平凡可拷贝且没有 niche 的 Optional<Ty> 的内存布局: [value][bHasValue][padding]
+ * @note: 供批量算法 (Array<Optional<T>>::CountPresent 等) 直接读取标志字节, 避免逐个调用 HasValue() 产生分支;
+ *     bHasValue 紧跟在 union 之后, union 的大小等于 sizeof(Ty), 且 bool 的对齐为 1
+ */
+template <typename Ty>
+struct OptionalLayout {
+	static constexpr bool HasFlagByte =
+		std::is_object_v<Ty> &&
+		!HasOptionalNicheVal<Ty> &&
+		std::is_trivially_copyable_v<Ty> &&
+		std::is_trivially_copyable_v<Optional<Ty>>;
+	static constexpr std::size_t ValueOffset = 0;
+	static constexpr std::size_t FlagOffset = sizeof(Ty);
+	static constexpr std::size_t Stride = sizeof(Optional<Ty>);
+
+private:
+	/* 批量算法按上面的偏移直接读取字节, 布局一旦变化必须在编译期报错, 而不是静默地数错 */
+	static constexpr bool M_IsLayoutAsDescribed() noexcept {
+		if constexpr (HasFlagByte) {
+			using StorageTp = OptionDestruct<std::remove_cv_t<Ty>>;
+			/* Optional 的基类链上没有其他数据成员, 存储层位于偏移 0 */
+			if constexpr (sizeof(Optional<Ty>) != sizeof(StorageTp) || alignof(Optional<Ty>) != alignof(Ty)) {
+				return false;
+			} else {
+#if defined(__GNUC__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+				/* StorageTp 不是标准布局 (成员的访问控制不同), 但没有虚函数与虚基类, 主流编译器都支持 offsetof */
+				return Stride > FlagOffset && offsetof(StorageTp, bHasValue) == FlagOffset;
+#if defined(__GNUC__)
+#  pragma GCC diagnostic pop
+#endif
+			}
+		}
+		return true;
+	}
+	static_assert(M_IsLayoutAsDescribed(), "OptionalLayout: Optional<T> no longer stores its flag byte at offset sizeof(T)");
+};
+
+/*
+ * @function: 引用特化, 内部只保存一个指针, sizeof(Optional<T&>) == sizeof(T*)
+ * @note: 1. 赋值语义是 "重新绑定" (与指针相同), 不会对所引用的对象赋值; 修改对象请用 *opt = value
+ *        2. 不能绑定到临时对象 (禁止 T&& 构造), 避免悬垂引用
+ *        3. Map 的返回值如果是左值引用, 结果仍然是 Optional<R&>, 否则是 Optional<R>
+ */
+template <typename Ty>
+class Optional<Ty&> {
+	template <class>
+	friend class Optional;
+public:
+	using ValueType = Ty&;
+
+	constexpr Optional() noexcept : m_Ptr(nullptr) {}
+	constexpr Optional(NulloptTp) noexcept : m_Ptr(nullptr) {}
+	constexpr Optional(std::nullopt_t) noexcept : m_Ptr(nullptr) {}
+
+	template <
+		typename Ty2,
+		std::enable_if_t<std::is_convertible_v<Ty2*, Ty*>, int> = 0
+	>
+	constexpr Optional(Ty2& that) noexcept : m_Ptr(std::addressof(that)) {}
+
+	template <
+		typename Ty2,
+		std::enable_if_t<std::is_convertible_v<Ty2*, Ty*>, int> = 0
+	>
+	Optional(const Ty2&&) = delete;
+
+	template <
+		typename Ty2,
+		std::enable_if_t<std::is_convertible_v<Ty2*, Ty*>, int> = 0
+	>
+	constexpr Optional(const Optional<Ty2&>& that) noexcept : m_Ptr(that.m_Ptr) {}
+
+	template <typename Fn, typename Uty>
+	constexpr Optional(ConstructFromInvokeResultTag, Fn&& fn, Uty&& arg)
+		noexcept(noexcept(std::invoke(std::forward<Fn>(fn), std::forward<Uty>(arg))))
+		: m_Ptr(std::addressof(static_cast<Ty&>(std::invoke(std::forward<Fn>(fn), std::forward<Uty>(arg))))) {}
+
+	constexpr Optional(const Optional&) noexcept = default;
+	constexpr Optional& operator=(const Optional&) noexcept = default;
+
+	constexpr Optional& operator=(NulloptTp) noexcept {
+		m_Ptr = nullptr;
+		return *this;
+	}
+	constexpr Optional& operator=(std::nullopt_t) noexcept {
+		m_Ptr = nullptr;
+		return *this;
+	}
+
+public:
+	/* 重新绑定到 that */
+	template <
+		typename Ty2,
+		std::enable_if_t<std::is_convertible_v<Ty2*, Ty*>, int> = 0
+	>
+	constexpr Ty& Some(Ty2& that) noexcept {
+		m_Ptr = std::addressof(that);
+		return *m_Ptr;
+	}
+
+	constexpr void Reset() noexcept {
+		m_Ptr = nullptr;
+	}
+
+	constexpr void Swap(Optional& that) noexcept {
+		std::swap(m_Ptr, that.m_Ptr);
+	}
+
+	[[nodiscard]] constexpr Ty& operator*() const noexcept {
+		return *m_Ptr;
+	}
+	[[nodiscard]] constexpr Ty* operator->() const noexcept {
+		return m_Ptr;
+	}
+	[[nodiscard]] constexpr bool HasValue() const noexcept {
+		return m_Ptr != nullptr;
+	}
+	[[nodiscard]] constexpr explicit operator bool() const noexcept {
+		return m_Ptr != nullptr;
+	}
+	[[nodiscard]] constexpr Ty& Value() const {
+		if (m_Ptr == nullptr) {
+			throw std::bad_optional_access();
+		}
+		return *m_Ptr;
+	}
+
+	/* 返回值而不是引用: that 可能是临时对象 */
+	template <typename Ty2 = std::remove_cv_t<Ty>>
+	[[nodiscard]] constexpr std::remove_cv_t<Ty> ValueOr(Ty2&& that) const {
+		static_assert(std::is_convertible_v<Ty2, std::remove_cv_t<Ty>>,
+			"Optioanal<T&>::ValueOr(U) requires U to be convertible to remove_cv_t<Ty> "
+		);
+		if (m_Ptr != nullptr) {
+			return *m_Ptr;
+		}
+		return static_cast<std::remove_cv_t<Ty>>(std::forward<Ty2>(that));
+	}
+
+	/* 拷贝出一个独立的 Optional<T> */
+	[[nodiscard]] constexpr Optional<std::remove_cv_t<Ty>> Copied() const {
+		if (m_Ptr == nullptr) {
+			return Optional<std::remove_cv_t<Ty>>{};
+		}
+		return Optional<std::remove_cv_t<Ty>>{ std::in_place, *m_Ptr };
+	}
+
+	template <typename Fn>
+	constexpr auto AndThen(Fn&& fn) const {
+		using Utp = std::invoke_result_t<Fn, Ty&>;
+		static_assert(IsSpecializationValOf<std::remove_cvref_t<Utp>, Optional>,
+			"Optional<T&>::AndThen(Fn) requires the return type of Fn to be a specialization of optional"
+		);
+		if (m_Ptr != nullptr) {
+			return std::invoke(std::forward<Fn>(fn), *m_Ptr);
+		}
+		return std::remove_cvref_t<Utp>{};
+	}
+
+	template <typename Fn>
+	constexpr auto Map(Fn&& fn) const {
+		using Rtp = std::invoke_result_t<Fn, Ty&>;
+		using Utp = std::conditional_t<
+			std::is_lvalue_reference_v<Rtp>, 
+			Rtp, 
+			std::remove_cv_t<std::remove_reference_t<Rtp>>
+		>;
+		static_assert(!IsAnyValOf<std::remove_cvref_t<Utp>, std::nullopt_t, NulloptTp, std::in_place_t>, 
+			"Optional<T&>::Map(Fn) requires the return type of Fn to be neither nullopt nor std::in_place_t"
+		);
+		static_assert(!std::is_array_v<std::remove_reference_t<Utp>>, 
+			"Optional<T&>::Map(Fn) requires the return type of Fn a non-array type"
+		);
+		if (m_Ptr != nullptr) {
+			return Optional<Utp>{ ConstructFromInvokeResultTag{}, std::forward<Fn>(fn), *m_Ptr };
+		}
+		return Optional<Utp>{};
+	}
+
+	template <typename Fn>
+	constexpr Optional OrElse(Fn&& fn) const {
+		static_assert(
+			std::is_same_v<std::remove_cvref_t<std::invoke_result_t<Fn>>, Optional>, 
+			"Optional<T&>::OrElse(Fn) requires Fn to return an Optional<T&>"
+		);
+		if (m_Ptr != nullptr) {
+			return *this;
+		}
+		return std::forward<Fn>(fn)();
+	}
+
+	[[nodiscard]] constexpr OptionalChain<Optional> Lazy() const noexcept {
+		return OptionalChain<Optional>{ *this };
+	}
+
+private:
+	Ty* m_Ptr;
+};
+
+/*
+ * @function: OptionalChain 中记录的阶段, 只保存可调用对象
+ */
+template <typename Fn>
+struct OptionalMapStage {
+	Fn fn;
+};
+template <typename Fn>
+struct OptionalAndThenStage {
+	Fn fn;
+};
+
+/*
+ * @function: 计算一条链的最终类型, Arg 是传入当前阶段的实参类型
+ * @note: Map 阶段把 fn 的返回值 (prvalue) 直接传给下一阶段; AndThen 阶段把 *std::move(opt) 传给下一阶段
+ */
+template <typename Arg, typename... Stages>
+struct OptionalChainResult;
+
+template <typename Arg, typename Fn>
+struct OptionalChainResult<Arg, OptionalMapStage<Fn>> {
+	using ResultTp = std::invoke_result_t<Fn&, Arg>;
+	using Type = Optional<
+		std::conditional_t<
+			std::is_lvalue_reference_v<ResultTp>,
+			ResultTp,
+			std::remove_cv_t<std::remove_reference_t<ResultTp>>
+		>
+	>;
+};
+template <typename Arg, typename Fn>
+struct OptionalChainResult<Arg, OptionalAndThenStage<Fn>> {
+	using Type = std::remove_cvref_t<std::invoke_result_t<Fn&, Arg>>;
+	static_assert(IsSpecializationValOf<Type, Optional>,
+		"OptionalChain::AndThen(Fn) requires the return type of Fn to be a specialization of optional"
+	);
+};
+template <typename Arg, typename Fn, typename Next, typename... Rest>
+struct OptionalChainResult<Arg, OptionalMapStage<Fn>, Next, Rest...>
+	: OptionalChainResult<std::invoke_result_t<Fn&, Arg>, Next, Rest...> {};
+
+template <typename Arg, typename Fn, typename Next, typename... Rest>
+struct OptionalChainResult<Arg, OptionalAndThenStage<Fn>, Next, Rest...>
+	: OptionalChainResult<
+		decltype(*std::declval<std::remove_cvref_t<std::invoke_result_t<Fn&, Arg>>>()), 
+		Next, 
+		Rest...
+	> {};
+
+/*
+ * @function: Optional 的惰性链式调用 (表达式模板)
+ *     opt.Map(f).AndThen(g).Map(h) 在每一步都会构造一个中间的 Optional, 对 string/Array 这类大对象
+ *     意味着每一步一次移动和一次析构. OptionalChain 只在编译期记录各个阶段, Collect() 时:
+ *         1. 只检查一次源 Optional 是否有值
+ *         2. 相邻的 Map 阶段直接把上一阶段的返回值 (prvalue) 作为下一阶段的实参, 不包装成 Optional
+ *         3. 最后一个 Map 阶段通过 ConstructFromInvokeResultTag 在结果 Optional 内原地构造
+ *     AndThen 阶段的 fn 本身就返回 Optional, 只能在这里检查一次是否有值.
+ * @note: Source 为 Optional& / const Optional& 时链只引用源对象, 不能比源对象活得更久;
+ *     对右值调用 Lazy() 时源对象被移动到链中.
+ */
+template <typename Source, typename... Stages>
+class OptionalChain {
+	template <typename, typename...>
+	friend class OptionalChain;
+
+	using SourceTp = std::remove_cvref_t<Source>;
+	using SourceArgTp = std::conditional_t<
+		std::is_lvalue_reference_v<Source>, 
+		decltype(*std::declval<Source>()), 
+		decltype(*std::declval<SourceTp&&>())
+	>;
+public:
+	constexpr explicit OptionalChain(Source source) 
+		: m_Source(std::forward<Source>(source)) {}
+
+	template <typename Fn>
+	[[nodiscard]] constexpr auto Map(Fn&& fn) && {
+		return OptionalChain<Source, Stages..., OptionalMapStage<std::decay_t<Fn>>>{
+			std::forward<Source>(m_Source), 
+			std::tuple_cat(std::move(m_Stages), std::make_tuple(OptionalMapStage<std::decay_t<Fn>>{ std::forward<Fn>(fn) }))
+		};
+	}
+
+	template <typename Fn>
+	[[nodiscard]] constexpr auto AndThen(Fn&& fn) && {
+		return OptionalChain<Source, Stages..., OptionalAndThenStage<std::decay_t<Fn>>>{
+			std::forward<Source>(m_Source), 
+			std::tuple_cat(std::move(m_Stages), std::make_tuple(OptionalAndThenStage<std::decay_t<Fn>>{ std::forward<Fn>(fn) }))
+		};
+	}
+
+	/* 执行整条链, 只构造最终的 Optional */
+	[[nodiscard]] constexpr auto Collect() && {
+		static_assert(sizeof...(Stages) > 0, "OptionalChain::Collect() requires at least one Map/AndThen stage");
+		using ResultTp = typename OptionalChainResult<SourceArgTp, Stages...>::Type;
+		if (!m_Source.HasValue()) {
+			return ResultTp{};
+		}
+		return M_Run<0, ResultTp>(static_cast<SourceArgTp>(*m_Source));
+	}
+
+private:
+	constexpr OptionalChain(Source source, std::tuple<Stages...>&& stages)
+		: m_Source(std::forward<Source>(source)), m_Stages(std::move(stages)) {}
+
+	template <std::size_t Index, typename ResultTp, typename Arg>
+	constexpr ResultTp M_Run(Arg&& arg) {
+		auto& stage = std::get<Index>(m_Stages);
+		constexpr bool bLast = Index + 1 == sizeof...(Stages);
+		if constexpr (IsSpecializationValOf<std::remove_cvref_t<decltype(stage)>, OptionalMapStage>) {
+			if constexpr (bLast) {
+				return ResultTp{ ConstructFromInvokeResultTag{}, stage.fn, std::forward<Arg>(arg) };
+			} else {
+				return M_Run<Index + 1, ResultTp>(std::invoke(stage.fn, std::forward<Arg>(arg)));
+			}
+		} else {
+			if constexpr (bLast) {
+				return std::invoke(stage.fn, std::forward<Arg>(arg));
+			} else {
+				auto next = std::invoke(stage.fn, std::forward<Arg>(arg));
+				if (!next.HasValue()) {
+					return ResultTp{};
+				}
+				return M_Run<Index + 1, ResultTp>(*std::move(next));
+			}
+		}
+	}
+
+private:
+	Source m_Source;
+	std::tuple<Stages...> m_Stages;
+};
+
 template <typename Ty1, typename Ty2>
 [[nodiscard]] constexpr bool operator==(const Optional<Ty1>& left, const Optional<Ty2>& right)
 	noexcept(
@@ -1029,16 +1554,16 @@ operator<=>(const Optional<Ty1>& left, const Optional<Ty2>& right){
 
 template <class Ty>
 [[nodiscard]] constexpr bool operator==(NulloptTp, const Optional<Ty>& right) noexcept {
-    return !right.has_value();
+    return !right.HasValue();
 }
 
 template <class Ty>
 [[nodiscard]] constexpr bool operator!=(const Optional<Ty>& left, NulloptTp) noexcept {
-    return left.has_value();
+    return left.HasValue();
 }
 template <class Ty>
 [[nodiscard]] constexpr bool operator!=(NulloptTp, const Optional<Ty>& right) noexcept {
-    return right.has_value();
+    return right.HasValue();
 }
 
 template <class Ty>
@@ -1047,12 +1572,12 @@ template <class Ty>
 }
 template <class Ty>
 [[nodiscard]] constexpr bool operator<(NulloptTp, const Optional<Ty>& right) noexcept {
-    return right.has_value();
+    return right.HasValue();
 }
 
 template <class Ty>
 [[nodiscard]] constexpr bool operator>(const Optional<Ty>& left, NulloptTp) noexcept {
-    return left.has_value();
+    return left.HasValue();
 }
 template <class Ty>
 [[nodiscard]] constexpr bool operator>(NulloptTp, const Optional<Ty>&) noexcept {
@@ -1061,7 +1586,7 @@ template <class Ty>
 
 template <class Ty>
 [[nodiscard]] constexpr bool operator<=(const Optional<Ty>& left, NulloptTp) noexcept {
-    return !left.has_value();
+    return !left.HasValue();
 }
 template <class Ty>
 [[nodiscard]] constexpr bool operator<=(NulloptTp, const Optional<Ty>&) noexcept {
@@ -1074,20 +1599,20 @@ template <class Ty>
 }
 template <class Ty>
 [[nodiscard]] constexpr bool operator>=(NulloptTp, const Optional<Ty>& right) noexcept {
-    return !right.has_value();
+    return !right.HasValue();
 }
 template <class Ty>
 [[nodiscard]] constexpr bool operator==(std::nullopt_t, const Optional<Ty>& right) noexcept {
-    return !right.has_value();
+    return !right.HasValue();
 }
 
 template <class Ty>
 [[nodiscard]] constexpr bool operator!=(const Optional<Ty>& left, std::nullopt_t) noexcept {
-    return left.has_value();
+    return left.HasValue();
 }
 template <class Ty>
 [[nodiscard]] constexpr bool operator!=(std::nullopt_t, const Optional<Ty>& right) noexcept {
-    return right.has_value();
+    return right.HasValue();
 }
 
 template <class Ty>
@@ -1096,12 +1621,12 @@ template <class Ty>
 }
 template <class Ty>
 [[nodiscard]] constexpr bool operator<(std::nullopt_t, const Optional<Ty>& right) noexcept {
-    return right.has_value();
+    return right.HasValue();
 }
 
 template <class Ty>
 [[nodiscard]] constexpr bool operator>(const Optional<Ty>& left, std::nullopt_t) noexcept {
-    return left.has_value();
+    return left.HasValue();
 }
 template <class Ty>
 [[nodiscard]] constexpr bool operator>(std::nullopt_t, const Optional<Ty>&) noexcept {
@@ -1110,7 +1635,7 @@ template <class Ty>
 
 template <class Ty>
 [[nodiscard]] constexpr bool operator<=(const Optional<Ty>& left, std::nullopt_t) noexcept {
-    return !left.has_value();
+    return !left.HasValue();
 }
 template <class Ty>
 [[nodiscard]] constexpr bool operator<=(std::nullopt_t, const Optional<Ty>&) noexcept {
@@ -1123,7 +1648,7 @@ template <class Ty>
 }
 template <class Ty>
 [[nodiscard]] constexpr bool operator>=(std::nullopt_t, const Optional<Ty>& right) noexcept {
-    return !right.has_value();
+    return !right.HasValue();
 }
 
 template <typename Ty>
@@ -1298,6 +1823,20 @@ constexpr auto Flatten(){}
 template <typename Ty>
 constexpr auto Fold(){}
 
+template <typename Ty>
+[[nodiscard]] constexpr Optional<std::decay_t<Ty>> MakeOptional(Ty&& value)
+	noexcept(std::is_nothrow_constructible_v<std::decay_t<Ty>, Ty>)
+{
+	return Optional<std::decay_t<Ty>>{ std::in_place, std::forward<Ty>(value) };
+}
+
+template <typename Ty, typename... Types, std::enable_if_t<std::is_constructible_v<Ty, Types...>, int> = 0>
+[[nodiscard]] constexpr Optional<Ty> MakeOptional(Types&&... args)
+	noexcept(std::is_nothrow_constructible_v<Ty, Types...>)
+{
+	return Optional<Ty>{ std::in_place, std::forward<Types>(args)... };
+}
+
 template <typename Ty, typename Elem, typename... Types,
 	std::enable_if_t<
 		std::is_constructible_v<
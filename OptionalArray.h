@@ -0,0 +1,420 @@
+#ifndef OPTIONAL_ARRAY_HPP
+#define OPTIONAL_ARRAY_HPP
+
+#include <bit>
+#include <cstdint>
+#include "Array.h"
+#include "Optional.hpp"
+
+namespace Potato {
+	/**
+	 * @brief: 列式存储的可空数组 (Arrow 风格)
+	 *     Array<Core::Optional<T>> 中每个元素后面都跟着一个 bHasValue 字节, 对齐后可能浪费一半内存,
+	 *     而且值之间不连续, 编译器无法向量化. OptionalArray<T> 把数据拆成两列:
+	 *
+	 *         values:   [ v0 | v1 | v2 | v3 | ... ]    稠密的 T 缓冲区, 空槽位存放值初始化的 T
+	 *         validity: [ 0b...1011 | ... ]             每个槽位 1 bit, 1 表示有值
+	 *
+	 * @note: validity 中超出 Size() 的高位始终为 0, 所以 CountPresent 可以直接逐字 popcount.
+	 * @note: Map / AndThen 逐 64 位字处理: 整字有值时走稠密循环 (可向量化), 整字为空时跳过,
+	 *     只有混合的字才逐位判断.
+	 * @note: operator[] 返回 Reference 代理, 用法与 Core::Optional<T&> 相同:
+	 *         if (column[i]) { *column[i] += 1; }
+	 *         column[i] = Core::nullopt;
+	 */
+	template <typename ElementType, class AllocatorType=std::allocator<ElementType>>
+	class OptionalArray {
+	public:
+		using ArrayType       = Array<ElementType, AllocatorType>;
+		using value_type      = ElementType;
+		using size_type       = typename ArrayType::size_type;
+		using difference_type = typename ArrayType::difference_type;
+		using WordType        = std::uint64_t;
+		using BitmapType      = Array<
+			WordType,
+			typename std::allocator_traits<AllocatorType>::template rebind_alloc<WordType>
+		>;
+		/* ToRows 的结果类型, 与本列属于同一分配器族 */
+		using RowsType        = Array<
+			Core::Optional<ElementType>,
+			typename std::allocator_traits<AllocatorType>::template rebind_alloc<Core::Optional<ElementType>>
+		>;
+
+		static_assert(std::is_default_constructible_v<ElementType>,
+			"OptionalArray<T> requires T to be default constructible, empty slots hold T{}");
+
+		class Reference;
+		class ConstReference;
+
+	private:
+		static constexpr size_type M_WordBits = 64;
+
+	public:
+		OptionalArray() = default;
+
+		/* 值列与 validity 都从 allocator (rebind 之后) 分配 */
+		explicit OptionalArray(const AllocatorType& allocator)
+			: m_Values(allocator)
+			, m_Validity(typename BitmapType::allocator_type(allocator)) {}
+
+		OptionalArray(std::initializer_list<Core::Optional<value_type>> list, const AllocatorType& allocator = AllocatorType())
+			: OptionalArray(allocator)
+		{
+			Reserve(list.size());
+			for (const auto& item : list) {
+				M_AppendOptional(item);
+			}
+		}
+
+		/* 没有显式给出分配器时, rows 的分配器与本列属于同一分配器族则沿用它 */
+		template <typename Alloc>
+		explicit OptionalArray(const Array<Core::Optional<value_type>, Alloc>& rows)
+			: OptionalArray(rows, M_AllocatorFrom(rows.GetAllocator())) {}
+
+		template <typename Alloc>
+		OptionalArray(const Array<Core::Optional<value_type>, Alloc>& rows, const AllocatorType& allocator)
+			: OptionalArray(allocator)
+		{
+			Reserve(rows.Size());
+			for (const auto& item : rows) {
+				M_AppendOptional(item);
+			}
+		}
+
+	public:
+		[[nodiscard]] size_type Size() const noexcept { return m_Values.Size(); }
+		[[nodiscard]] bool IsEmpty() const noexcept { return m_Values.IsEmpty(); }
+
+		/* 稠密的值缓冲区, 空槽位的内容为 T{} */
+		[[nodiscard]] const ArrayType& Values() const noexcept { return m_Values; }
+		/* validity bitmap, 第 i 个槽位对应 word[i / 64] 的第 (i % 64) 位 */
+		[[nodiscard]] const BitmapType& Validity() const noexcept { return m_Validity; }
+
+		[[nodiscard]] AllocatorType GetAllocator() const noexcept { return m_Values.GetAllocator(); }
+
+		[[nodiscard]] bool HasValue(const size_type index) const noexcept {
+			return (m_Validity[index / M_WordBits] >> (index % M_WordBits)) & 1u;
+		}
+
+		[[nodiscard]] Reference operator[](const size_type index) noexcept {
+			return Reference{ this, index };
+		}
+		[[nodiscard]] ConstReference operator[](const size_type index) const noexcept {
+			return ConstReference{ this, index };
+		}
+
+		/* 取出一个独立的 Optional 副本 */
+		[[nodiscard]] Core::Optional<value_type> Get(const size_type index) const {
+			if (!HasValue(index)) {
+				return Core::Optional<value_type>{};
+			}
+			return Core::Optional<value_type>{ std::in_place, m_Values[index] };
+		}
+
+		/**
+		 * @brief: 有值的槽位数量, 逐字 popcount
+		 */
+		[[nodiscard]] size_type CountPresent() const noexcept {
+			size_type count = 0;
+			for (const WordType word : m_Validity) {
+				count += static_cast<size_type>(std::popcount(word));
+			}
+			return count;
+		}
+		[[nodiscard]] size_type CountNull() const noexcept {
+			return Size() - CountPresent();
+		}
+
+	public:
+		template <typename ... Args>
+		OptionalArray& Append(Args&& ... args) {
+			m_Values.EmplaceBack(std::forward<Args>(args)...);
+			M_PushBit(true);
+			return *this;
+		}
+		OptionalArray& AppendNull() {
+			m_Values.EmplaceBack();
+			M_PushBit(false);
+			return *this;
+		}
+
+		void Set(const size_type index, const value_type& value) {
+			m_Values[index] = value;
+			M_SetBit(index);
+		}
+		void Set(const size_type index, value_type&& value) {
+			m_Values[index] = std::move(value);
+			M_SetBit(index);
+		}
+		void SetNull(const size_type index) {
+			m_Values[index] = value_type{};
+			M_ClearBit(index);
+		}
+
+		void Pop() {
+			M_ClearBit(Size() - 1);
+			m_Values.Pop();
+			if (Size() % M_WordBits == 0) {
+				m_Validity.Pop();
+			}
+		}
+
+		void Reserve(const size_type capacity) {
+			m_Values.Reserve(capacity);
+			m_Validity.Reserve(M_WordCount(capacity));
+		}
+
+		void Clear() noexcept {
+			m_Values.Clear();
+			m_Validity.Clear();
+		}
+
+	public:
+		/**
+		 * @brief: 逐列应用 fn: U fn(const T&), 空槽位在结果中仍为空
+		 * @note: validity 原样复制; 整字有值的 64 个元素走无分支的稠密循环
+		 */
+		template <typename FnTransform>
+		[[nodiscard]] auto Map(FnTransform func) const {
+			using ResultType = std::remove_cvref_t<std::invoke_result_t<FnTransform&, const value_type&>>;
+			M_RebindTp<ResultType> result{ M_AllocateValues<ResultType>(), m_Validity };
+			M_ForEachMasked([&](const size_type index) {
+				result.m_Values[index] = std::invoke(func, m_Values[index]);
+			});
+			return result;
+		}
+
+		/**
+		 * @brief: 逐列应用 fn: Core::Optional<U> fn(const T&), fn 返回空时结果槽位也为空
+		 */
+		template <typename FnTransform>
+		[[nodiscard]] auto AndThen(FnTransform func) const {
+			using OptionalType = std::remove_cvref_t<std::invoke_result_t<FnTransform&, const value_type&>>;
+			static_assert(IsSpecializationValOf<OptionalType, Core::Optional>,
+				"OptionalArray<T>::AndThen(Fn) requires Fn to return a Core::Optional");
+			using ResultType = typename OptionalType::ValueType;
+			M_RebindTp<ResultType> result{ M_AllocateValues<ResultType>(), m_Validity };
+			M_ForEachMasked([&](const size_type index) {
+				OptionalType mapped = std::invoke(func, m_Values[index]);
+				if (mapped.HasValue()) {
+					result.m_Values[index] = std::move(*mapped);
+				} else {
+					result.M_ClearBit(index);
+				}
+			});
+			return result;
+		}
+
+		/**
+		 * @brief: 保留 pred(ConstReference) 为 true 的槽位, 值和 validity 一起压缩
+		 * @note: pred 接收的是槽位代理, 可以自行决定是否保留空槽位:
+		 *         column.Filter([](auto slot) { return slot && *slot > 0; });
+		 */
+		template <typename Predicate>
+		[[nodiscard]] OptionalArray Filter(Predicate pred) const {
+			OptionalArray result{ m_Values.GetAllocator() };
+			for (size_type index = 0; index < Size(); ++index) {
+				if (std::invoke(pred, (*this)[index])) {
+					result.m_Values.Append(m_Values[index]);
+					result.M_PushBit(HasValue(index));
+				}
+			}
+			return result;
+		}
+
+		/* 转换回行式存储 */
+		[[nodiscard]] RowsType ToRows() const {
+			RowsType rows{ typename RowsType::allocator_type(m_Values.GetAllocator()) };
+			rows.Reserve(Size());
+			for (size_type index = 0; index < Size(); ++index) {
+				rows.Append(Get(index));
+			}
+			return rows;
+		}
+
+	private:
+		template <typename, class>
+		friend class OptionalArray;
+
+		/* Map / AndThen 的结果沿用同一分配器族, 元素类型不同时 BitmapType 也可能不同, 按区间复制 validity */
+		template <typename Ty>
+		using M_RebindTp = OptionalArray<Ty, typename std::allocator_traits<AllocatorType>::template rebind_alloc<Ty>>;
+
+		template <class BitmapAllocator>
+		OptionalArray(ArrayType&& values, const Array<WordType, BitmapAllocator>& validity)
+			: m_Values(std::move(values))
+			, m_Validity(validity.begin(), validity.end(), typename BitmapType::allocator_type(m_Values.GetAllocator())) {}
+
+		/**
+		 * @brief: 为 Map / AndThen 的结果分配 Size() 个值初始化的槽位, 沿用本列的分配器
+		 * @note: 不用 ArrayType(count) 构造, 它不接收本列的分配器; 与 HashTable::M_Rehash 一样先传分配器再 Resize
+		 */
+		template <typename Ty>
+		[[nodiscard]] typename M_RebindTp<Ty>::ArrayType M_AllocateValues() const {
+			using ResultArrayTp = typename M_RebindTp<Ty>::ArrayType;
+			ResultArrayTp values{ typename ResultArrayTp::allocator_type(m_Values.GetAllocator()) };
+			values.Resize(Size());
+			return values;
+		}
+
+		template <typename Alloc>
+		[[nodiscard]] static AllocatorType M_AllocatorFrom(const Alloc& allocator) {
+			if constexpr (std::is_constructible_v<AllocatorType, const Alloc&>) {
+				return AllocatorType(allocator);
+			} else {
+				return AllocatorType();
+			}
+		}
+
+		[[nodiscard]] static constexpr size_type M_WordCount(const size_type count) noexcept {
+			return (count + M_WordBits - 1) / M_WordBits;
+		}
+
+		template <typename Optional>
+		void M_AppendOptional(const Optional& item) {
+			if (item.HasValue()) {
+				Append(*item);
+			} else {
+				AppendNull();
+			}
+		}
+
+		/* 调用前 m_Values 已经追加了新元素 */
+		void M_PushBit(const bool bHasValue) {
+			const size_type index = Size() - 1;
+			if (index % M_WordBits == 0) {
+				m_Validity.Append(WordType{ 0 });
+			}
+			if (bHasValue) {
+				M_SetBit(index);
+			}
+		}
+		void M_SetBit(const size_type index) noexcept {
+			m_Validity[index / M_WordBits] |= WordType{ 1 } << (index % M_WordBits);
+		}
+		void M_ClearBit(const size_type index) noexcept {
+			m_Validity[index / M_WordBits] &= ~(WordType{ 1 } << (index % M_WordBits));
+		}
+
+		/**
+		 * @brief: 对每个有值的槽位调用 kernel(index)
+		 * @note: 全 1 的字展开为 64 次连续调用, 编译器可以对其中的 kernel 向量化;
+		 *     混合的字用 countr_zero 逐个取出置位的 bit
+		 */
+		template <typename Kernel>
+		void M_ForEachMasked(Kernel&& kernel) const {
+			const size_type words = m_Validity.Size();
+			for (size_type word_index = 0; word_index < words; ++word_index) {
+				WordType word = m_Validity[word_index];
+				const size_type base = word_index * M_WordBits;
+				if (word == ~WordType{ 0 }) {
+					for (size_type bit = 0; bit < M_WordBits; ++bit) {
+						kernel(base + bit);
+					}
+					continue;
+				}
+				while (word != 0) {
+					kernel(base + static_cast<size_type>(std::countr_zero(word)));
+					word &= word - 1;
+				}
+			}
+		}
+
+	private:
+		ArrayType m_Values;
+		BitmapType m_Validity;
+	};
+
+	/**
+	 * @brief: OptionalArray 槽位的只读代理, 接口与 Core::Optional<const T&> 一致
+	 */
+	template <typename ElementType, class AllocatorType>
+	class OptionalArray<ElementType, AllocatorType>::ConstReference {
+	public:
+		ConstReference(const OptionalArray* owner, const size_type index) noexcept
+			: m_Owner(owner), m_Index(index) {}
+
+		[[nodiscard]] bool HasValue() const noexcept { return m_Owner->HasValue(m_Index); }
+		[[nodiscard]] explicit operator bool() const noexcept { return HasValue(); }
+
+		[[nodiscard]] const value_type& operator*() const noexcept { return m_Owner->m_Values[m_Index]; }
+		[[nodiscard]] const value_type* operator->() const noexcept { return std::addressof(**this); }
+
+		[[nodiscard]] const value_type& Value() const {
+			if (!HasValue()) {
+				throw std::bad_optional_access();
+			}
+			return **this;
+		}
+		template <typename Ty2>
+		[[nodiscard]] value_type ValueOr(Ty2&& that) const {
+			return HasValue() ? **this : static_cast<value_type>(std::forward<Ty2>(that));
+		}
+
+	private:
+		const OptionalArray* m_Owner;
+		size_type m_Index;
+	};
+
+	/**
+	 * @brief: OptionalArray 槽位的可写代理, 赋值 T 置为有值, 赋值 nullopt 置为空
+	 */
+	template <typename ElementType, class AllocatorType>
+	class OptionalArray<ElementType, AllocatorType>::Reference {
+	public:
+		Reference(OptionalArray* owner, const size_type index) noexcept
+			: m_Owner(owner), m_Index(index) {}
+		Reference(const Reference&) noexcept = default;
+
+		/* column[i] = column[j] 复制的是槽位的内容, 而不是让代理改指另一个槽位 */
+		Reference& operator=(const Reference& other) {
+			if (other.HasValue()) {
+				m_Owner->Set(m_Index, *other);
+			} else {
+				m_Owner->SetNull(m_Index);
+			}
+			return *this;
+		}
+		Reference& operator=(const value_type& value) {
+			m_Owner->Set(m_Index, value);
+			return *this;
+		}
+		Reference& operator=(value_type&& value) {
+			m_Owner->Set(m_Index, std::move(value));
+			return *this;
+		}
+		Reference& operator=(Core::NulloptTp) {
+			m_Owner->SetNull(m_Index);
+			return *this;
+		}
+		Reference& operator=(std::nullopt_t) {
+			m_Owner->SetNull(m_Index);
+			return *this;
+		}
+
+		[[nodiscard]] bool HasValue() const noexcept { return m_Owner->HasValue(m_Index); }
+		[[nodiscard]] explicit operator bool() const noexcept { return HasValue(); }
+
+		[[nodiscard]] value_type& operator*() const noexcept { return m_Owner->m_Values[m_Index]; }
+		[[nodiscard]] value_type* operator->() const noexcept { return std::addressof(**this); }
+
+		[[nodiscard]] value_type& Value() const {
+			if (!HasValue()) {
+				throw std::bad_optional_access();
+			}
+			return **this;
+		}
+		template <typename Ty2>
+		[[nodiscard]] value_type ValueOr(Ty2&& that) const {
+			return HasValue() ? **this : static_cast<value_type>(std::forward<Ty2>(that));
+		}
+
+		operator ConstReference() const noexcept { return ConstReference{ m_Owner, m_Index }; }
+
+	private:
+		OptionalArray* m_Owner;
+		size_type m_Index;
+	};
+}
+
+#endif // OPTIONAL_ARRAY_HPP
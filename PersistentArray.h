@@ -0,0 +1,502 @@
+#ifndef PERSISTENT_ARRAY_HPP
+#define PERSISTENT_ARRAY_HPP
+
+#include <atomic>
+#include <cstdint>
+#include "Array.h"
+
+namespace Potato {
+	/**
+	 * @brief: 持久化 (不可变, 结构共享) 数组, 32 叉 Trie 实现
+	 *     每一次修改 (Append / Set / Slice / Concat) 都返回一个新版本, 旧版本保持不变.
+	 *     新旧版本之间只复制从根到被修改叶子的路径 (最多 log32(n) 个节点), 其余节点共享,
+	 *     所以保存 100 个版本的大表时内存约等于 1 份数据加上每个版本的修改量.
+	 *
+	 *             root (shift = 5)
+	 *         /      |       \
+	 *      leaf0   leaf1 ... leaf31      每个叶子是一个最多 32 个元素的 Array
+	 *
+	 * @note: 节点使用原子引用计数, 可以在线程间共享版本.
+	 * @note: 批量修改请使用 Transient(): 事务期间独占的节点直接原地修改,
+	 *     只有仍被其他版本共享的节点才会被复制, 结束时用 Persistent() 转回不可变版本.
+	 * @note: Slice 通过调整逻辑起点 (origin) 实现, 不复制元素; 若切片落在根的某一个子树内,
+	 *     会下降到该子树以释放两侧不再需要的节点.
+	 *     Concat 按叶子块把右侧数据追加到左侧的新版本上, 复杂度是 O(右侧长度).
+	 */
+	template <typename ElementType, class AllocatorType=std::allocator<ElementType>>
+	class PersistentArray {
+	public:
+		using ArrayType       = Array<ElementType, AllocatorType>;
+		using value_type      = ElementType;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference       = const value_type&;
+		using const_reference = const value_type&;
+
+		class TransientType;
+		class ConstIterator;
+		using const_iterator = ConstIterator;
+		using iterator       = ConstIterator;
+
+	private:
+		static constexpr size_type M_BranchBits = 5;
+		static constexpr size_type M_BranchSize = size_type{ 1 } << M_BranchBits;
+		static constexpr size_type M_BranchMask = M_BranchSize - 1;
+
+		struct Node {
+			using ChildrenType = Array<
+				Node*,
+				typename std::allocator_traits<AllocatorType>::template rebind_alloc<Node*>
+			>;
+
+			explicit Node(const AllocatorType& allocator)
+				: values(allocator), children(typename ChildrenType::allocator_type(allocator)) {}
+			Node(const ArrayType& values, const ChildrenType& children)
+				: values(values), children(children) {}
+
+			std::atomic<std::uint32_t> refs{ 1 };
+			ArrayType values;         // 叶子节点: 最多 32 个元素
+			ChildrenType children;    // 内部节点: 最多 32 个子节点
+		};
+
+		using M_NodeAllocatorType =
+			typename std::allocator_traits<AllocatorType>::template rebind_alloc<Node>;
+		using M_NodeAllocatorTraits = std::allocator_traits<M_NodeAllocatorType>;
+
+		struct TrieData {
+			Node* root { nullptr };
+			size_type size { 0 };     // 逻辑长度
+			size_type origin { 0 };   // 逻辑下标 0 对应的物理下标
+			size_type shift { 0 };    // 根节点的位移, 叶子为 0
+		};
+
+		using M_RealValueType = MemoryTools::CompressedPair<M_NodeAllocatorType, TrieData>;
+
+	public:
+		PersistentArray() noexcept
+			: m_Data(MemoryTools::ZeroConstructCompressedTag{}) {}
+
+		explicit PersistentArray(const AllocatorType& allocator)
+			: m_Data(MemoryTools::OneConstructCompressedTag{}, M_NodeAllocatorType(allocator)) {}
+
+		PersistentArray(std::initializer_list<value_type> list, const AllocatorType& allocator=AllocatorType())
+			: m_Data(MemoryTools::OneConstructCompressedTag{}, M_NodeAllocatorType(allocator)) {
+			M_AppendChunk(list.begin(), list.size());
+		}
+
+		/* O(n), 按 32 个元素一块批量拷贝, 沿用 array 的分配器 */
+		explicit PersistentArray(const ArrayType& array)
+			: m_Data(MemoryTools::OneConstructCompressedTag{}, M_NodeAllocatorType(array.GetAllocator())) {
+			M_AppendChunk(array.Data(), array.Size());
+		}
+
+		PersistentArray(const PersistentArray& other) noexcept
+			: m_Data(MemoryTools::OneConstructCompressedTag{}, other.m_Data.GetFirst(), other.m_Data.data) {
+			if (m_Data.data.root) {
+				M_Retain(m_Data.data.root);
+			}
+		}
+
+		PersistentArray(PersistentArray&& other) noexcept
+			: m_Data(MemoryTools::OneConstructCompressedTag{}, std::move(other.m_Data.GetFirst()), other.m_Data.data) {
+			other.m_Data.data = TrieData{};
+		}
+
+		PersistentArray& operator=(const PersistentArray& other) noexcept {
+			if (this != &other) {
+				PersistentArray temp(other);
+				Swap(temp);
+			}
+			return *this;
+		}
+
+		PersistentArray& operator=(PersistentArray&& other) noexcept {
+			if (this != &other) {
+				PersistentArray temp(std::move(other));
+				Swap(temp);
+			}
+			return *this;
+		}
+
+		~PersistentArray() noexcept {
+			M_Release(m_Data.data.root);
+		}
+
+	public:
+		[[nodiscard]] bool IsEmpty() const noexcept { return m_Data.data.size == 0; }
+		[[nodiscard]] size_type Size() const noexcept { return m_Data.data.size; }
+
+		[[nodiscard]] const_reference operator[](const size_type index) const noexcept {
+			const size_type phys = m_Data.data.origin + index;
+			return M_LeafFor(phys)->values[phys & M_BranchMask];
+		}
+		[[nodiscard]] const_reference At(const size_type index) const {
+			if (index >= Size()) {
+				throw std::out_of_range("PersistentArray::At: Index out of range");
+			}
+			return (*this)[index];
+		}
+		[[nodiscard]] const_reference Front() const { return (*this)[0]; }
+		[[nodiscard]] const_reference Back() const { return (*this)[Size() - 1]; }
+
+		/**
+		 * @brief: 修改 API, 均返回新版本, *this 保持不变
+		 */
+		[[nodiscard]] PersistentArray Append(const value_type& value) const {
+			PersistentArray result(*this);
+			result.M_AppendOne(value);
+			return result;
+		}
+		[[nodiscard]] PersistentArray Append(value_type&& value) const {
+			PersistentArray result(*this);
+			result.M_AppendOne(std::move(value));
+			return result;
+		}
+		[[nodiscard]] PersistentArray Set(const size_type index, const value_type& value) const {
+			PersistentArray result(*this);
+			result.M_Assign(index, value);
+			return result;
+		}
+		[[nodiscard]] PersistentArray Set(const size_type index, value_type&& value) const {
+			PersistentArray result(*this);
+			result.M_Assign(index, std::move(value));
+			return result;
+		}
+		/* 返回 [first, last) 的切片, 与 *this 共享全部节点 */
+		[[nodiscard]] PersistentArray Slice(const size_type first, const size_type last) const {
+			assert(first <= last && last <= Size() && "PersistentArray::Slice: invalid range");
+			if (first == last) {
+				return PersistentArray(M_GetAllocator());
+			}
+			PersistentArray result(*this);
+			result.m_Data.data.origin += first;
+			result.m_Data.data.size = last - first;
+			result.M_Narrow();
+			return result;
+		}
+		[[nodiscard]] PersistentArray Concat(const PersistentArray& other) const {
+			PersistentArray result(*this);
+			other.ForEachChunk([&result](const value_type* chunk, size_type count) {
+				result.M_AppendChunk(chunk, count);
+			});
+			return result;
+		}
+
+		/* O(n), 按叶子块批量拷贝 */
+		[[nodiscard]] ArrayType ToArray() const {
+			ArrayType result(M_GetAllocator());
+			result.Reserve(Size());
+			ForEachChunk([&result](const value_type* chunk, size_type count) {
+				result.Append(chunk, count);
+			});
+			return result;
+		}
+
+		[[nodiscard]] TransientType Transient() const & {
+			return TransientType(*this);
+		}
+		[[nodiscard]] TransientType Transient() && {
+			return TransientType(std::move(*this));
+		}
+
+		/**
+		 * @brief: 按叶子顺序访问连续的元素块: fn(const value_type* chunk, size_type count)
+		 */
+		template <typename Fn>
+		void ForEachChunk(Fn&& fn) const {
+			const auto& data = m_Data.data;
+			for (size_type index = 0; index < data.size; ) {
+				const size_type phys   = data.origin + index;
+				const size_type offset = phys & M_BranchMask;
+				const size_type count  = std::min(M_BranchSize - offset, data.size - index);
+				fn(M_LeafFor(phys)->values.Data() + offset, count);
+				index += count;
+			}
+		}
+
+		void Swap(PersistentArray& other) noexcept {
+			using std::swap;
+			swap(m_Data.data, other.m_Data.data);
+			if constexpr (M_NodeAllocatorTraits::propagate_on_container_swap::value) {
+				swap(m_Data.GetFirst(), other.m_Data.GetFirst());
+			}
+		}
+
+		[[nodiscard]] const_iterator begin() const noexcept { return const_iterator(this, 0); }
+		[[nodiscard]] const_iterator end() const noexcept { return const_iterator(this, Size()); }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+	public:
+		/**
+		 * @brief: 只读前向迭代器, 缓存当前叶子, 只在跨越叶子时重新查找
+		 */
+		class ConstIterator {
+		public:
+			using iterator_concept  = std::forward_iterator_tag;
+			using iterator_category = std::forward_iterator_tag;
+			using value_type        = ElementType;
+			using difference_type   = std::ptrdiff_t;
+			using pointer           = const ElementType*;
+			using reference         = const ElementType&;
+
+			ConstIterator() noexcept = default;
+
+			[[nodiscard]] reference operator*() const noexcept { return *m_Cursor; }
+			[[nodiscard]] pointer operator->() const noexcept { return m_Cursor; }
+
+			ConstIterator& operator++() noexcept {
+				++m_Index;
+				if (++m_Cursor == m_LeafEnd) {
+					M_Seek();
+				}
+				return *this;
+			}
+			ConstIterator operator++(int) noexcept {
+				ConstIterator temp = *this;
+				++*this;
+				return temp;
+			}
+
+			[[nodiscard]] bool operator==(const ConstIterator& other) const noexcept {
+				return m_Index == other.m_Index;
+			}
+
+		private:
+			friend class PersistentArray;
+			ConstIterator(const PersistentArray* owner, size_type index) noexcept
+				: m_Owner(owner), m_Index(index) {
+				M_Seek();
+			}
+
+			void M_Seek() noexcept {
+				const auto& data = m_Owner->m_Data.data;
+				if (m_Index >= data.size) {
+					m_Cursor = m_LeafEnd = nullptr;
+					return;
+				}
+				const size_type phys   = data.origin + m_Index;
+				const size_type offset = phys & M_BranchMask;
+				m_Cursor  = m_Owner->M_LeafFor(phys)->values.Data() + offset;
+				m_LeafEnd = m_Cursor + std::min(M_BranchSize - offset, data.size - m_Index);
+			}
+
+			const PersistentArray* m_Owner { nullptr };
+			size_type m_Index { 0 };
+			const ElementType* m_Cursor { nullptr };
+			const ElementType* m_LeafEnd { nullptr };
+		};
+
+	private:
+		/* 元素类型的分配器, 由节点分配器转换而来 */
+		[[nodiscard]] AllocatorType M_GetAllocator() const noexcept {
+			return AllocatorType(m_Data.GetFirst());
+		}
+
+		/* 新节点的 values / children 沿用容器的分配器 */
+		[[nodiscard]] Node* M_CreateNode() {
+			auto& allocator = m_Data.GetFirst();
+			Node* node = MemoryTools::Unfancy(M_NodeAllocatorTraits::allocate(allocator, 1));
+			M_NodeAllocatorTraits::construct(allocator, node, M_GetAllocator());
+			return node;
+		}
+
+		/* 复制节点, 子节点被新节点共享, 所以引用计数 +1 */
+		[[nodiscard]] Node* M_CloneNode(const Node* node) {
+			auto& allocator = m_Data.GetFirst();
+			Node* clone = MemoryTools::Unfancy(M_NodeAllocatorTraits::allocate(allocator, 1));
+			try {
+				M_NodeAllocatorTraits::construct(allocator, clone, node->values, node->children);
+			} catch (...) {
+				M_NodeAllocatorTraits::deallocate(allocator, clone, 1);
+				throw;
+			}
+			for (Node* child : clone->children) {
+				M_Retain(child);
+			}
+			return clone;
+		}
+
+		static void M_Retain(Node* node) noexcept {
+			node->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void M_Release(Node* node) noexcept {
+			if (node && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				for (Node* child : node->children) {
+					M_Release(child);
+				}
+				auto& allocator = m_Data.GetFirst();
+				M_NodeAllocatorTraits::destroy(allocator, node);
+				M_NodeAllocatorTraits::deallocate(allocator, node, 1);
+			}
+		}
+
+		/**
+		 * @brief: 保证 slot 指向的节点只被当前版本持有, 否则复制一份并放弃对旧节点的引用
+		 * @note: 调用者必须保证 slot 所在的父节点 (或根指针) 本身已经是独占的
+		 */
+		void M_MakeUnique(Node*& slot) {
+			if (slot->refs.load(std::memory_order_acquire) != 1) {
+				Node* clone = M_CloneNode(slot);
+				M_Release(slot);
+				slot = clone;
+			}
+		}
+
+		[[nodiscard]] const Node* M_LeafFor(const size_type phys) const noexcept {
+			const Node* node = m_Data.data.root;
+			for (size_type level = m_Data.data.shift; level > 0; level -= M_BranchBits) {
+				node = node->children[(phys >> level) & M_BranchMask];
+			}
+			return node;
+		}
+
+		/**
+		 * @brief: 沿 phys 的路径复制 (或创建) 节点, 返回独占的叶子
+		 */
+		[[nodiscard]] Node* M_UniqueLeafFor(const size_type phys) {
+			Node** slot = &m_Data.data.root;
+			for (size_type level = m_Data.data.shift; ; level -= M_BranchBits) {
+				if (*slot == nullptr) {
+					*slot = M_CreateNode();
+				} else {
+					M_MakeUnique(*slot);
+				}
+				Node* node = *slot;
+				if (level == 0) {
+					return node;
+				}
+				const size_type index = (phys >> level) & M_BranchMask;
+				if (index == node->children.Size()) {
+					node->children.Append(nullptr);
+				}
+				slot = &node->children[index];
+			}
+		}
+
+		/* 根节点已满时向上加一层 */
+		void M_GrowRootIfFull() {
+			auto& data = m_Data.data;
+			if (data.root && data.origin + data.size >= (M_BranchSize << data.shift)) {
+				Node* root = M_CreateNode();
+				root->children.Append(data.root);
+				data.root = root;
+				data.shift += M_BranchBits;
+			}
+		}
+
+		/**
+		 * @brief: 返回可以追加元素的独占叶子, 并丢弃叶子中超出逻辑末尾的旧元素 (Slice 遗留)
+		 */
+		[[nodiscard]] Node* M_LeafForAppend() {
+			M_GrowRootIfFull();
+			const size_type phys = m_Data.data.origin + m_Data.data.size;
+			Node* leaf = M_UniqueLeafFor(phys);
+			const size_type offset = phys & M_BranchMask;
+			if (leaf->values.Size() > offset) {
+				leaf->values.Erase(leaf->values.cbegin() + static_cast<difference_type>(offset), leaf->values.cend());
+			}
+			return leaf;
+		}
+
+		template <typename Ty2>
+		void M_AppendOne(Ty2&& value) {
+			M_LeafForAppend()->values.Append(std::forward<Ty2>(value));
+			++m_Data.data.size;
+		}
+
+		void M_AppendChunk(const value_type* values, size_type count) {
+			while (count > 0) {
+				Node* leaf = M_LeafForAppend();
+				const size_type room = M_BranchSize - ((m_Data.data.origin + m_Data.data.size) & M_BranchMask);
+				const size_type batch = std::min(room, count);
+				leaf->values.Append(values, batch);
+				m_Data.data.size += batch;
+				values += batch;
+				count -= batch;
+			}
+		}
+
+		template <typename Ty2>
+		void M_Assign(const size_type index, Ty2&& value) {
+			assert(index < Size() && "PersistentArray::Set: Index out of range");
+			const size_type phys = m_Data.data.origin + index;
+			M_UniqueLeafFor(phys)->values[phys & M_BranchMask] = std::forward<Ty2>(value);
+		}
+
+		/* 切片完全落在根的某个子树内时, 把该子树提升为根 */
+		void M_Narrow() noexcept {
+			auto& data = m_Data.data;
+			while (data.shift > 0) {
+				const size_type first_child = data.origin >> data.shift;
+				const size_type last_child  = (data.origin + data.size - 1) >> data.shift;
+				if (first_child != last_child) {
+					break;
+				}
+				Node* child = data.root->children[first_child];
+				M_Retain(child);
+				M_Release(data.root);
+				data.root = child;
+				data.origin -= first_child << data.shift;
+				data.shift -= M_BranchBits;
+			}
+		}
+
+	private:
+		M_RealValueType m_Data;
+	};
+
+	/**
+	 * @brief: 批量修改模式
+	 *     Transient 独占的节点直接原地修改, 连续 Append 时每个叶子只会被复制一次.
+	 */
+	template <typename ElementType, class AllocatorType>
+	class PersistentArray<ElementType, AllocatorType>::TransientType {
+	public:
+		TransientType() = default;
+
+		TransientType& Append(const value_type& value) {
+			m_Array.M_AppendOne(value);
+			return *this;
+		}
+		TransientType& Append(value_type&& value) {
+			m_Array.M_AppendOne(std::move(value));
+			return *this;
+		}
+		TransientType& Append(const value_type* values, size_type count) {
+			m_Array.M_AppendChunk(values, count);
+			return *this;
+		}
+		TransientType& Append(const ArrayType& array) {
+			m_Array.M_AppendChunk(array.Data(), array.Size());
+			return *this;
+		}
+		TransientType& Set(const size_type index, const value_type& value) {
+			m_Array.M_Assign(index, value);
+			return *this;
+		}
+		TransientType& Set(const size_type index, value_type&& value) {
+			m_Array.M_Assign(index, std::move(value));
+			return *this;
+		}
+
+		[[nodiscard]] size_type Size() const noexcept { return m_Array.Size(); }
+		[[nodiscard]] bool IsEmpty() const noexcept { return m_Array.IsEmpty(); }
+		[[nodiscard]] const_reference operator[](const size_type index) const noexcept { return m_Array[index]; }
+
+		/* 结束批量修改, 之后 Transient 为空 */
+		[[nodiscard]] PersistentArray Persistent() {
+			return std::move(m_Array);
+		}
+
+	private:
+		friend class PersistentArray<ElementType, AllocatorType>;
+		explicit TransientType(const PersistentArray& origin) : m_Array(origin) {}
+		explicit TransientType(PersistentArray&& origin) noexcept : m_Array(std::move(origin)) {}
+
+		PersistentArray m_Array;
+	};
+}
+
+#endif // PERSISTENT_ARRAY_HPP
@@ -0,0 +1,309 @@
+#ifndef STRINGARRAY_HPP
+#define STRINGARRAY_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "Array.h"
+
+/**
+ * @brief: 紧凑的字符串数组 Potato::StringArray: 所有字符连续保存在一块字节区中, 另有一个结束偏移数组
+ * @note: 1. 第 i 个字符串是 [m_Ends[i - 1], m_Ends[i]) 区间的字节 (i == 0 时从 0 开始),
+ *           每个元素只额外占用 4 字节, 而 std::string 本身就是 32 字节, 超出 SSO 时还有一次堆分配.
+ *        2. 元素访问返回 std::string_view, 指向内部的字节区; 任何追加或删除都可能使其失效 (与 Array 的引用相同).
+ *        3. 偏移是 std::uint32_t, 字节区总大小不能超过 4 GiB, 超出时抛出 std::length_error.
+ *        4. Find / Count / FindPrefix 先比较长度 (只读偏移数组), 长度满足时再用 SSE2 一次比较 16 字节的前缀,
+ *           前缀相同且更长时才 memcmp 剩余部分; 候选串之间是连续的, 不需要追逐指针.
+ *        5. 字符串不做驻留 (去重), 相同的字符串会各自保存一份.
+ */
+namespace Potato {
+	namespace StringTools {
+		inline constexpr std::size_t PrefixWidth = 16;
+
+		/**
+		 * @brief: 把 needle 的前 PrefixWidth 个字节预先装入寄存器, 之后与每个候选串比较前缀
+		 */
+		class PrefixMatcher {
+		public:
+			explicit PrefixMatcher(const std::string_view needle) noexcept : m_Needle(needle) {
+				const std::size_t prefix = needle.size() < PrefixWidth ? needle.size() : PrefixWidth;
+				m_PrefixMask = (std::uint32_t{ 1 } << prefix) - 1;
+#if defined(POTATO_HAVE_SSE2)
+				alignas(16) char buffer[PrefixWidth]{};
+				if (prefix != 0) std::memcpy(buffer, needle.data(), prefix); // 空的 string_view 的 data() 可以是 nullptr
+				m_Prefix = _mm_load_si128(reinterpret_cast<const __m128i*>(buffer));
+#endif
+			}
+
+			/**
+			 * @brief: candidate 的前 needle.size() 个字节是否与 needle 相同
+			 * @param: readable 为从 candidate 开始可以安全读取的字节数, 不足 PrefixWidth 时退回 memcmp
+			 */
+			[[nodiscard]] bool MatchPrefix(const char* candidate, const std::size_t readable) const noexcept {
+#if defined(POTATO_HAVE_SSE2)
+				if (readable >= PrefixWidth) [[likely]] {
+					const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(candidate));
+					const auto equal = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, m_Prefix)));
+					if ((equal & m_PrefixMask) != m_PrefixMask) return false;
+					return m_Needle.size() <= PrefixWidth
+						|| std::memcmp(candidate + PrefixWidth, m_Needle.data() + PrefixWidth, m_Needle.size() - PrefixWidth) == 0;
+				}
+#endif
+				(void)readable;
+				return std::memcmp(candidate, m_Needle.data(), m_Needle.size()) == 0;
+			}
+
+			[[nodiscard]] std::size_t Size() const noexcept { return m_Needle.size(); }
+
+		private:
+			std::string_view m_Needle;
+			std::uint32_t m_PrefixMask;
+#if defined(POTATO_HAVE_SSE2)
+			__m128i m_Prefix;
+#endif
+		};
+	}
+
+	class StringArray {
+	public:
+		using size_type   = std::size_t;
+		using offset_type = std::uint32_t;
+		using value_type  = std::string_view;
+		static constexpr size_type npos = static_cast<size_type>(-1);
+
+		class ConstIterator {
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using difference_type   = std::ptrdiff_t;
+			using value_type        = std::string_view;
+			using reference         = std::string_view;
+
+			ConstIterator() = default;
+			ConstIterator(const StringArray* array, const size_type index) noexcept : m_Array(array), m_Index(index) {}
+
+			[[nodiscard]] reference operator*() const noexcept { return (*m_Array)[m_Index]; }
+			[[nodiscard]] reference operator[](const difference_type offset) const noexcept { return (*m_Array)[m_Index + offset]; }
+
+			ConstIterator& operator++() noexcept { ++m_Index; return *this; }
+			ConstIterator operator++(int) noexcept { ConstIterator temp = *this; ++m_Index; return temp; }
+			ConstIterator& operator--() noexcept { --m_Index; return *this; }
+			ConstIterator operator--(int) noexcept { ConstIterator temp = *this; --m_Index; return temp; }
+			ConstIterator& operator+=(const difference_type offset) noexcept { m_Index += offset; return *this; }
+			ConstIterator& operator-=(const difference_type offset) noexcept { m_Index -= offset; return *this; }
+			[[nodiscard]] ConstIterator operator+(const difference_type offset) const noexcept { return ConstIterator(m_Array, m_Index + offset); }
+			[[nodiscard]] ConstIterator operator-(const difference_type offset) const noexcept { return ConstIterator(m_Array, m_Index - offset); }
+			[[nodiscard]] friend ConstIterator operator+(const difference_type offset, const ConstIterator& it) noexcept { return it + offset; }
+			[[nodiscard]] difference_type operator-(const ConstIterator& other) const noexcept {
+				return static_cast<difference_type>(m_Index) - static_cast<difference_type>(other.m_Index);
+			}
+			[[nodiscard]] bool operator==(const ConstIterator& other) const noexcept { return m_Index == other.m_Index; }
+			[[nodiscard]] auto operator<=>(const ConstIterator& other) const noexcept { return m_Index <=> other.m_Index; }
+
+			[[nodiscard]] size_type Index() const noexcept { return m_Index; }
+
+		private:
+			const StringArray* m_Array{ nullptr };
+			size_type m_Index{ 0 };
+		};
+		using const_iterator = ConstIterator;
+		using iterator       = ConstIterator;
+
+		StringArray() = default;
+		StringArray(std::initializer_list<std::string_view> list) {
+			Append(list.begin(), list.end());
+		}
+		template <typename InputIterator>
+			requires std::convertible_to<std::iter_reference_t<InputIterator>, std::string_view>
+		StringArray(InputIterator first, InputIterator last) {
+			Append(first, last);
+		}
+
+	public:
+		[[nodiscard]] size_type Size() const noexcept { return m_Ends.Size(); }
+		[[nodiscard]] bool IsEmpty() const noexcept { return m_Ends.IsEmpty(); }
+		/* 所有字符串的总字节数 */
+		[[nodiscard]] size_type ByteSize() const noexcept { return m_Bytes.Size(); }
+		/* 实际占用的堆内存 (字节区与偏移数组的容量) */
+		[[nodiscard]] size_type MemoryUsage() const noexcept {
+			return m_Bytes.Capacity() + m_Ends.Capacity() * sizeof(offset_type);
+		}
+		/* 连续的字节区, 不以 '\0' 结尾 */
+		[[nodiscard]] const char* Data() const noexcept { return m_Bytes.Data(); }
+
+		/* count 个字符串, 共 bytes 个字节 */
+		void Reserve(const size_type count, const size_type bytes = 0) {
+			m_Ends.Reserve(count);
+			m_Bytes.Reserve(bytes);
+		}
+		void ShrinkToFit() {
+			m_Ends.ShrinkToFit();
+			m_Bytes.ShrinkToFit();
+		}
+		void Clear() noexcept {
+			m_Ends.Clear();
+			m_Bytes.Clear();
+		}
+		void Swap(StringArray& other) noexcept {
+			m_Ends.Swap(other.m_Ends);
+			m_Bytes.Swap(other.m_Bytes);
+		}
+
+		[[nodiscard]] const_iterator begin() const noexcept { return const_iterator(this, 0); }
+		[[nodiscard]] const_iterator end() const noexcept { return const_iterator(this, Size()); }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+		// @brief: 元素访问 API, 返回指向内部字节区的 std::string_view
+		[[nodiscard]] std::string_view operator[](const size_type index) const noexcept {
+			const offset_type first = M_Begin(index);
+			return std::string_view(m_Bytes.Data() + first, m_Ends.Data()[index] - first);
+		}
+		[[nodiscard]] std::string_view At(const size_type index) const {
+			if (index >= Size()) {
+				throw std::out_of_range("StringArray::At: Index out of range");
+			}
+			return (*this)[index];
+		}
+		[[nodiscard]] std::string_view Front() const noexcept { return (*this)[0]; }
+		[[nodiscard]] std::string_view Back() const noexcept { return (*this)[Size() - 1]; }
+		/* 第 index 个字符串的长度, 不访问字节区 */
+		[[nodiscard]] size_type LengthOf(const size_type index) const noexcept {
+			return m_Ends.Data()[index] - M_Begin(index);
+		}
+
+		// @brief: 修改 API
+		StringArray& Append(const std::string_view value) {
+			const size_type new_size = m_Bytes.Size() + value.size();
+			if (new_size > std::numeric_limits<offset_type>::max()) [[unlikely]] {
+				throw std::length_error("StringArray: total size exceeds 4 GiB");
+			}
+			/* value 可以指向自身的字节区 (例如 Append((*this)[0])), Array::Append 会先构造再搬运旧数据 */
+			m_Bytes.Append(value.data(), value.size());
+			try {
+				m_Ends.Append(static_cast<offset_type>(new_size));
+			} catch (...) {
+				m_Bytes.Resize(new_size - value.size());
+				throw;
+			}
+			return *this;
+		}
+		template <typename InputIterator>
+			requires std::convertible_to<std::iter_reference_t<InputIterator>, std::string_view>
+		StringArray& Append(InputIterator first, InputIterator last) {
+			if constexpr (std::forward_iterator<InputIterator>) {
+				size_type bytes = 0;
+				size_type count = 0;
+				for (auto it = first; it != last; ++it, ++count) {
+					bytes += std::string_view(*it).size();
+				}
+				Reserve(Size() + count, ByteSize() + bytes);
+			}
+			for (; first != last; ++first) {
+				Append(std::string_view(*first));
+			}
+			return *this;
+		}
+		void Pop() noexcept {
+			m_Ends.Pop();
+			m_Bytes.Resize(IsEmpty() ? 0 : m_Ends.Back());
+		}
+
+		/**
+		 * @brief: 删除所有满足 pred 的字符串, 返回删除的个数
+		 * @note: 一次遍历在原地压缩字节区与偏移数组, O(总字节数)
+		 */
+		template <typename Predicate>
+		size_type EraseIf(Predicate pred) {
+			static_assert(std::is_invocable_r_v<bool, Predicate, std::string_view>,
+				"EraseIf: Predicate must be callable with std::string_view and return bool");
+			char* bytes        = m_Bytes.Data();
+			offset_type* ends  = m_Ends.Data();
+			offset_type write  = 0;
+			size_type kept     = 0;
+			offset_type first  = 0;
+			for (size_type i = 0; i < Size(); ++i) {
+				const offset_type last = ends[i];
+				if (!pred(std::string_view(bytes + first, last - first))) {
+					/* 空串不搬运: 全是空串时 bytes 为 nullptr; 位置未变时也不必搬运 */
+					if (last != first && write != first) std::memmove(bytes + write, bytes + first, last - first);
+					write += last - first;
+					ends[kept++] = write;
+				}
+				first = last;
+			}
+			const size_type erased = Size() - kept;
+			m_Ends.Resize(kept);
+			m_Bytes.Resize(write);
+			return erased;
+		}
+
+		// @brief: 查找与统计 API
+		/* 从 start 开始第一个等于 value 的下标, 找不到时返回 npos (与 Array::Find 相同) */
+		[[nodiscard]] size_type Find(const std::string_view value, const size_type start = 0) const noexcept {
+			const StringTools::PrefixMatcher matcher(value);
+			return M_Scan(matcher, start, [](const size_type length, const size_type needle) { return length == needle; });
+		}
+		[[nodiscard]] Core::Optional<size_type> FindFirst(const std::string_view value) const noexcept {
+			return M_ToIndex(Find(value));
+		}
+		/* 从 start 开始第一个以 prefix 开头的下标 */
+		[[nodiscard]] size_type FindPrefix(const std::string_view prefix, const size_type start = 0) const noexcept {
+			const StringTools::PrefixMatcher matcher(prefix);
+			return M_Scan(matcher, start, [](const size_type length, const size_type needle) { return length >= needle; });
+		}
+		[[nodiscard]] bool IsContain(const std::string_view value) const noexcept {
+			return Find(value) != npos;
+		}
+		[[nodiscard]] size_type Count(const std::string_view value) const noexcept {
+			size_type count = 0;
+			for (size_type index = Find(value); index != npos; index = Find(value, index + 1)) {
+				++count;
+			}
+			return count;
+		}
+
+		[[nodiscard]] friend bool operator==(const StringArray& lhs, const StringArray& rhs) noexcept {
+			return lhs.m_Ends == rhs.m_Ends && lhs.m_Bytes == rhs.m_Bytes;
+		}
+
+	private:
+		[[nodiscard]] offset_type M_Begin(const size_type index) const noexcept {
+			return index == 0 ? 0 : m_Ends.Data()[index - 1];
+		}
+		[[nodiscard]] static Core::Optional<size_type> M_ToIndex(const size_type index) noexcept {
+			if (index == npos) return Core::nullopt;
+			return index;
+		}
+		/* 只有长度满足 accept 的候选才比较字节, 前缀比较最多读取到字节区末尾 */
+		template <typename LengthFilter>
+		[[nodiscard]] size_type M_Scan(const StringTools::PrefixMatcher& matcher, const size_type start, LengthFilter accept) const noexcept {
+			const char* bytes        = m_Bytes.Data();
+			const offset_type* ends  = m_Ends.Data();
+			const size_type total    = m_Bytes.Size();
+			const size_type needle   = matcher.Size();
+			if (start >= Size()) return npos;
+			offset_type first        = M_Begin(start);
+			for (size_type i = start; i < Size(); ++i) {
+				const offset_type last = ends[i];
+				if (accept(last - first, needle) && (needle == 0 || matcher.MatchPrefix(bytes + first, total - first))) {
+					return i;
+				}
+				first = last;
+			}
+			return npos;
+		}
+
+		Array<char> m_Bytes;
+		Array<offset_type> m_Ends;
+	};
+}
+
+#endif // STRINGARRAY_HPP
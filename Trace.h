@@ -0,0 +1,282 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#  define POTATO_TRACE_HAS_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#  include <intrin.h>
+#  define POTATO_TRACE_HAS_TSC 1
+#else
+#  define POTATO_TRACE_HAS_TSC 0
+#endif
+
+/* 每个线程的环形缓冲区能保存的事件数, 必须是 2 的幂, 写满之后覆盖最旧的事件 */
+#ifndef POTATO_TRACE_BUFFER_SIZE
+#  define POTATO_TRACE_BUFFER_SIZE 4096
+#endif
+
+/**
+ * @brief: Potato 容器热路径的追踪钩子, 默认关闭
+ * @note: 定义 POTATO_ENABLE_TRACE 之后, Array 在扩容 (Reallocate), 批量插入 (BulkInsert: M_InsertHoles /
+ * 		M_AppendRange) 与删除 (BulkErase: M_EraseElement) 前后各读一次时间戳, 记录元素数量与搬运的字节数.
+ * 		事件写入当前线程私有的环形缓冲区: 只有所属线程写, 不需要加锁; 每个槽位带一个序号,
+ * 		导出时读到正在被覆盖的槽位会直接丢弃.
+ * 		WriteChromeTrace() 输出 chrome://tracing / Perfetto 可以打开的 JSON.
+ * 		未定义 POTATO_ENABLE_TRACE 时 POTATO_TRACE_SCOPE 展开为空语句, 不读时间戳也不访问 thread_local.
+ */
+namespace Potato::Trace {
+	enum class EventKind : std::uint8_t {
+		Reallocate,
+		BulkInsert,
+		BulkErase,
+	};
+
+	[[nodiscard]] constexpr const char* EventKindName(const EventKind kind) noexcept {
+		switch (kind) {
+		case EventKind::Reallocate: return "Reallocate";
+		case EventKind::BulkInsert: return "BulkInsert";
+		case EventKind::BulkErase:  return "BulkErase";
+		}
+		return "Unknown";
+	}
+
+	struct Event {
+		std::uint64_t begin;    // 时间戳 (TSC 或纳秒), 用 ToMicroseconds 换算
+		std::uint64_t end;
+		std::uint64_t count;    // 插入 / 删除 / 搬运的元素数量
+		std::uint64_t bytes;    // 搬运的字节数
+		const char* type;       // 元素类型的 typeid 名字
+		EventKind kind;
+		std::uint32_t thread;   // 线程在注册顺序中的编号, 从 1 开始
+	};
+
+	/* 有 TSC 的平台读 TSC, 否则退化为 steady_clock 的纳秒数 */
+	[[nodiscard]] inline std::uint64_t ReadTimestamp() noexcept {
+#if POTATO_TRACE_HAS_TSC
+		return __rdtsc();
+#else
+		return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+	}
+
+	[[nodiscard]] inline std::uint64_t ReadNanoseconds() noexcept {
+		return static_cast<std::uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	/**
+	 * @brief: 时间戳与纳秒之间的换算
+	 * @note: 程序开始追踪时记下 (timestamp, ns) 作为原点, 导出时再取一次, 两点之间线性换算.
+	 *     要求 TSC 是 invariant TSC (近十年的 x86 都是), 否则跨核的时间戳不可比
+	 */
+	struct Clock {
+		std::uint64_t timestamp;
+		std::uint64_t nanoseconds;
+
+		[[nodiscard]] static Clock Now() noexcept {
+			return Clock{ ReadTimestamp(), ReadNanoseconds() };
+		}
+	};
+
+	inline const Clock& Origin() noexcept {
+		static const Clock origin = Clock::Now();
+		return origin;
+	}
+
+	static_assert(POTATO_TRACE_BUFFER_SIZE > 0 && (POTATO_TRACE_BUFFER_SIZE & (POTATO_TRACE_BUFFER_SIZE - 1)) == 0,
+		"POTATO_TRACE_BUFFER_SIZE must be a power of two");
+
+	class ThreadBuffer {
+	public:
+		static constexpr std::size_t Capacity = POTATO_TRACE_BUFFER_SIZE;
+
+		explicit ThreadBuffer(const std::uint32_t thread) noexcept : m_Thread(thread) {}
+		ThreadBuffer(const ThreadBuffer&) = delete;
+		ThreadBuffer& operator=(const ThreadBuffer&) = delete;
+
+		/* 只能由所属线程调用 */
+		void Push(const EventKind kind, const char* type, const std::uint64_t begin, const std::uint64_t end,
+			const std::uint64_t count, const std::uint64_t bytes) noexcept {
+			const std::uint64_t index = m_Head.load(std::memory_order_relaxed);
+			Slot& slot = m_Slots[index & (Capacity - 1)];
+			slot.sequence.store(0, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			slot.begin.store(begin, std::memory_order_relaxed);
+			slot.end.store(end, std::memory_order_relaxed);
+			slot.count.store(count, std::memory_order_relaxed);
+			slot.bytes.store(bytes, std::memory_order_relaxed);
+			slot.type.store(type, std::memory_order_relaxed);
+			slot.kind.store(kind, std::memory_order_relaxed);
+			slot.sequence.store(index + 1, std::memory_order_release);
+			m_Head.store(index + 1, std::memory_order_release);
+		}
+
+		/* 可以由任意线程调用; 与写入并发时只保证拿到的每个事件都是完整的 */
+		void Collect(std::vector<Event>& out) const {
+			const std::uint64_t head = m_Head.load(std::memory_order_acquire);
+			const std::uint64_t first = head > Capacity ? head - Capacity : 0;
+			for (std::uint64_t index = first; index < head; ++index) {
+				const Slot& slot = m_Slots[index & (Capacity - 1)];
+				if (slot.sequence.load(std::memory_order_acquire) != index + 1) continue;
+				const Event event{
+					slot.begin.load(std::memory_order_relaxed),
+					slot.end.load(std::memory_order_relaxed),
+					slot.count.load(std::memory_order_relaxed),
+					slot.bytes.load(std::memory_order_relaxed),
+					slot.type.load(std::memory_order_relaxed),
+					slot.kind.load(std::memory_order_relaxed),
+					m_Thread
+				};
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (slot.sequence.load(std::memory_order_relaxed) != index + 1) continue;
+				out.push_back(event);
+			}
+		}
+
+		void Clear() noexcept {
+			m_Head.store(0, std::memory_order_release);
+			for (Slot& slot : m_Slots) slot.sequence.store(0, std::memory_order_relaxed);
+		}
+
+		ThreadBuffer* next{ nullptr };
+
+	private:
+		/* 序号锁 (seqlock): 读者可能与所属线程的覆盖写并发, 所以每个字段都是 relaxed 原子变量, 由序号判断是否完整 */
+		struct Slot {
+			std::atomic<std::uint64_t> sequence{ 0 };
+			std::atomic<std::uint64_t> begin{ 0 };
+			std::atomic<std::uint64_t> end{ 0 };
+			std::atomic<std::uint64_t> count{ 0 };
+			std::atomic<std::uint64_t> bytes{ 0 };
+			std::atomic<const char*> type{ nullptr };
+			std::atomic<EventKind> kind{ EventKind::Reallocate };
+		};
+
+		std::atomic<std::uint64_t> m_Head{ 0 };
+		std::uint32_t m_Thread;
+		Slot m_Slots[Capacity];
+	};
+
+	/* 所有线程缓冲区组成的全局链表, 线程退出之后缓冲区仍然保留, 以便导出 */
+	inline std::atomic<ThreadBuffer*>& BufferHead() noexcept {
+		static std::atomic<ThreadBuffer*> head{ nullptr };
+		return head;
+	}
+
+	/* 当前线程的缓冲区, 第一次使用时分配并注册; 分配失败返回 nullptr, 之后的事件直接丢弃 */
+	inline ThreadBuffer* LocalBuffer() noexcept {
+		thread_local ThreadBuffer* buffer = [] {
+			static std::atomic<std::uint32_t> next_thread{ 1 };
+			(void)Origin();
+			auto* created = new (std::nothrow) ThreadBuffer(next_thread.fetch_add(1, std::memory_order_relaxed));
+			if (!created) return created;
+			auto& head = BufferHead();
+			created->next = head.load(std::memory_order_relaxed);
+			while (!head.compare_exchange_weak(created->next, created, std::memory_order_release, std::memory_order_relaxed)) {}
+			return created;
+		}();
+		return buffer;
+	}
+
+	/**
+	 * @brief: RAII 的追踪区间, 构造时读开始时间戳, 析构时写入当前线程的缓冲区
+	 * @note: 析构在异常展开时同样执行, 所以抛异常的扩容也会留下记录
+	 */
+	class Scope {
+	public:
+		Scope(const EventKind kind, const char* type, const std::uint64_t count, const std::uint64_t bytes) noexcept
+			: m_Begin(ReadTimestamp()), m_Count(count), m_Bytes(bytes), m_Type(type), m_Kind(kind) {}
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		~Scope() {
+			const std::uint64_t end = ReadTimestamp();
+			if (ThreadBuffer* buffer = LocalBuffer()) {
+				buffer->Push(m_Kind, m_Type, m_Begin, end, m_Count, m_Bytes);
+			}
+		}
+
+	private:
+		std::uint64_t m_Begin;
+		std::uint64_t m_Count;
+		std::uint64_t m_Bytes;
+		const char* m_Type;
+		EventKind m_Kind;
+	};
+
+	/* 所有线程缓冲区中的事件, 按线程分组, 每个线程内部按时间顺序 */
+	[[nodiscard]] inline std::vector<Event> Collect() {
+		std::vector<Event> result;
+		for (ThreadBuffer* buffer = BufferHead().load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+			buffer->Collect(result);
+		}
+		return result;
+	}
+
+	/* 只应在没有线程正在写入时调用 */
+	inline void Clear() noexcept {
+		for (ThreadBuffer* buffer = BufferHead().load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+			buffer->Clear();
+		}
+	}
+
+	/**
+	 * @brief: 把 Origin() 之后的时间戳换算为微秒
+	 * @param now: 用于和 Origin() 做两点标定的时刻, 两者相距越远换算越准
+	 */
+	[[nodiscard]] inline double ToMicroseconds(const std::uint64_t timestamp, const Clock& now) noexcept {
+		const Clock& origin = Origin();
+		const double ticks = static_cast<double>(now.timestamp - origin.timestamp);
+		const double nanoseconds = static_cast<double>(now.nanoseconds - origin.nanoseconds);
+		const double ns_per_tick = ticks > 0 ? nanoseconds / ticks : 1.0;
+		return static_cast<double>(static_cast<std::int64_t>(timestamp - origin.timestamp)) * ns_per_tick / 1000.0;
+	}
+
+	/**
+	 * @brief: 以 Chrome Trace Event Format 输出所有事件 (ph = "X", 完整区间)
+	 * @note: 在 chrome://tracing 或 https://ui.perfetto.dev 中打开;
+	 *     嵌套的区间 (例如 BulkInsert 内部的 Reallocate) 会显示为父子关系
+	 */
+	inline void WriteChromeTrace(std::ostream& out) {
+		const std::vector<Event> events = Collect();
+		const Clock now = Clock::Now();
+		out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		bool first = true;
+		for (const Event& event : events) {
+			const double begin = ToMicroseconds(event.begin, now);
+			const double end = ToMicroseconds(event.end, now);
+			out << (first ? "\n" : ",\n")
+				<< "{\"name\":\"" << EventKindName(event.kind) << "\",\"cat\":\"Potato.Array\",\"ph\":\"X\""
+				<< ",\"ts\":" << begin << ",\"dur\":" << (end > begin ? end - begin : 0.0)
+				<< ",\"pid\":1,\"tid\":" << event.thread
+				<< ",\"args\":{\"type\":\"" << event.type << "\",\"count\":" << event.count
+				<< ",\"bytes\":" << event.bytes << "}}";
+			first = false;
+		}
+		out << "\n]}\n";
+	}
+}
+
+#define POTATO_TRACE_CONCAT_IMPL(a, b) a##b
+#define POTATO_TRACE_CONCAT(a, b) POTATO_TRACE_CONCAT_IMPL(a, b)
+
+#if defined(POTATO_ENABLE_TRACE)
+#  define POTATO_TRACE_SCOPE(kind, Ty, count, bytes)                                      \
+	const ::Potato::Trace::Scope POTATO_TRACE_CONCAT(potato_trace_scope_, __LINE__) {     \
+		::Potato::Trace::EventKind::kind, typeid(Ty).name(),                              \
+		static_cast<std::uint64_t>(count), static_cast<std::uint64_t>(bytes) }
+#else
+#  define POTATO_TRACE_SCOPE(kind, Ty, count, bytes) ((void)0)
+#endif
+
+#endif // TRACE_HPP
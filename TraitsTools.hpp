@@ -1,6 +1,46 @@
 #pragma once
 #include <type_traits>
+#include <memory>
+#include <utility>
+#include <vector>
 namespace Core::Traits {
+/*
+ * @function: 平凡可重定位 (trivially relocatable): "移动构造到新地址 + 析构旧对象" 等价于 memcpy 之后直接丢弃旧内存
+ * @note: 1. 平凡可拷贝的类型总是可重定位的
+ *        2. 类型可以通过 using TriviallyRelocatableTp = std::true_type; 声明自己可重定位,
+ *           基于 AutoControlSMF 的包装器 (Optional, Expected, Variant ...) 用 TriviallyRelocatableIfTp<Types...> 从负载继承
+ *        3. 第三方类型通过特化 TriviallyRelocatable<T> 声明
+ *        4. 指向自身内部的类型 (libstdc++ 的 std::string 的 SSO, std::list 的哨兵节点) 不能声明为可重定位
+ */
+template <typename Ty, typename = void>
+struct TriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<Ty>> {};
+
+template <typename Ty>
+struct TriviallyRelocatable<Ty, std::void_t<typename Ty::TriviallyRelocatableTp>>
+	: std::bool_constant<std::is_trivially_copyable_v<Ty> || Ty::TriviallyRelocatableTp::value> {};
+
+template <typename Ty>
+constexpr bool IsTriviallyRelocatableVal = TriviallyRelocatable<std::remove_cv_t<Ty>>::value;
+
+template <typename... Types>
+using TriviallyRelocatableIfTp = std::bool_constant<(IsTriviallyRelocatableVal<Types> && ...)>;
+
+/* 标准库中无状态或只保存指针 (且不指向自身) 的类型 */
+template <typename Ty>
+struct TriviallyRelocatable<std::allocator<Ty>> : std::true_type {};
+template <typename Ty, typename Deleter>
+struct TriviallyRelocatable<std::unique_ptr<Ty, Deleter>> : std::bool_constant<IsTriviallyRelocatableVal<Deleter>> {};
+template <typename Ty>
+struct TriviallyRelocatable<std::shared_ptr<Ty>> : std::true_type {};
+template <typename Ty>
+struct TriviallyRelocatable<std::weak_ptr<Ty>> : std::true_type {};
+template <typename Ty>
+struct TriviallyRelocatable<std::vector<Ty, std::allocator<Ty>>> : std::true_type {};
+/* std::pair 有自定义的赋值运算符, 不是平凡可拷贝的, 但两个成员都可重定位时整体也可重定位 */
+template <typename First, typename Second>
+struct TriviallyRelocatable<std::pair<First, Second>>
+	: std::bool_constant<IsTriviallyRelocatableVal<First> && IsTriviallyRelocatableVal<Second>> {};
+
 /*
  * @function: 非平台拷贝构造的代理
  * @note: 基类需要自己实现 __ConstructFrom(const BaseClass&) 这个方法
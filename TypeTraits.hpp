@@ -1,10 +1,20 @@
 #pragma once
+#include <version>
 #include <type_traits>
 #include <string>
 #include <memory>
 #include <iterator>
 #include <utility>
+#if __has_include("../Proj.hpp")
 #include "../Proj.hpp"
+#endif
+/* 独立使用本仓库 (没有上层工程的 Proj.hpp) 时的默认值 */
+#ifndef CONSTEXPR20
+#define CONSTEXPR20 constexpr
+#endif
+#ifndef INLINE
+#define INLINE inline
+#endif
 #include "TypeTraitsImpl.hpp"
 
 
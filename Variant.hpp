@@ -0,0 +1,537 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include "TraitsTools.hpp"
+#include "TypeTraits.hpp"
+#include "Optional.hpp"
+
+namespace Core {
+
+inline constexpr std::size_t VariantNpos = static_cast<std::size_t>(-1);
+
+template <std::size_t Index, typename... Types>
+using VariantAlternativeTp = std::tuple_element_t<Index, std::tuple<Types...>>;
+
+/* 能容纳 [0, Count] 的最小无符号整数, Count 本身用作 "无值" 的下标 */
+template <std::size_t Count>
+using VariantIndexTp = std::conditional_t<
+	(Count < std::numeric_limits<std::uint8_t>::max()),
+	std::uint8_t,
+	std::conditional_t<(Count < std::numeric_limits<std::uint16_t>::max()), std::uint16_t, std::uint32_t>
+>;
+
+/* Ty 在 Types... 中出现的次数与第一次出现的下标 */
+template <typename Ty, typename... Types>
+constexpr std::size_t VariantCountOf = (std::size_t{ std::is_same_v<Ty, Types> } + ... + 0);
+
+template <typename Ty, typename... Types>
+constexpr std::size_t VariantIndexOf = [] {
+	constexpr bool Matches[] = { std::is_same_v<Ty, Types>... };
+	for (std::size_t index = 0; index < sizeof...(Types); ++index) {
+		if (Matches[index]) {
+			return index;
+		}
+	}
+	return VariantNpos;
+}();
+
+/*
+ * @function: 按运行期下标分发到 fn(std::integral_constant<std::size_t, I>{})
+ * @note: 不超过 16 个分支时生成一个 switch, 编译器会把它编译成跳转表且可以内联每个分支;
+ *     超过 16 个时使用 constexpr 的函数指针表. 调用者保证 index < Count.
+ */
+template <std::size_t Index, typename ResultTp, typename Fn>
+constexpr ResultTp VariantDispatchAt(Fn& fn) {
+	return fn(std::integral_constant<std::size_t, Index>{});
+}
+
+template <typename ResultTp, typename Fn, std::size_t... Indices>
+constexpr ResultTp VariantDispatchTable(const std::size_t index, Fn& fn, std::index_sequence<Indices...>) {
+	constexpr std::array<ResultTp (*)(Fn&), sizeof...(Indices)> Table = {
+		&VariantDispatchAt<Indices, ResultTp, Fn>...
+	};
+	return Table[index](fn);
+}
+
+template <
+	std::size_t Count,
+	typename Fn,
+	typename ResultTp = std::invoke_result_t<Fn&, std::integral_constant<std::size_t, 0>>
+>
+constexpr ResultTp VariantDispatch(const std::size_t index, Fn&& fn) {
+	if constexpr (Count <= 16) {
+#define POTATO_VARIANT_CASE(N)                                                          \
+		case N:                                                                         \
+			if constexpr (N < Count) {                                                  \
+				return fn(std::integral_constant<std::size_t, N>{});                    \
+			} else {                                                                    \
+				std::unreachable();                                                     \
+			}
+		switch (index) {
+			POTATO_VARIANT_CASE(0)  POTATO_VARIANT_CASE(1)  POTATO_VARIANT_CASE(2)  POTATO_VARIANT_CASE(3)
+			POTATO_VARIANT_CASE(4)  POTATO_VARIANT_CASE(5)  POTATO_VARIANT_CASE(6)  POTATO_VARIANT_CASE(7)
+			POTATO_VARIANT_CASE(8)  POTATO_VARIANT_CASE(9)  POTATO_VARIANT_CASE(10) POTATO_VARIANT_CASE(11)
+			POTATO_VARIANT_CASE(12) POTATO_VARIANT_CASE(13) POTATO_VARIANT_CASE(14) POTATO_VARIANT_CASE(15)
+			default:
+				std::unreachable();
+		}
+#undef POTATO_VARIANT_CASE
+	} else {
+		return VariantDispatchTable<ResultTp>(index, fn, std::make_index_sequence<Count>{});
+	}
+}
+
+/*
+ * @function: 两个候选类型, 其中一个是空类型, 另一个存在保留的 OptionalTraits niche (IsReservedNiche) 时,
+ *     空类型的状态直接用另一个类型的哨兵值表示, 不需要存储下标
+ * @note: 空智能指针与 NaN 是合法的值, 不能借用, 否则 Variant<Empty, std::unique_ptr<T>>{ nullptr } 会变成 Empty
+ */
+template <typename... Types>
+struct VariantNicheInfo {
+	static constexpr bool HasNiche = false;
+};
+
+template <typename Ty0, typename Ty1>
+struct VariantNicheInfo<Ty0, Ty1> {
+	template <typename EmptyTp, typename ValueTp>
+	static constexpr bool M_Fits =
+		std::is_empty_v<EmptyTp> &&
+		std::is_nothrow_default_constructible_v<EmptyTp> &&
+		HasReservedNicheVal<ValueTp>;
+
+	static constexpr bool HasNiche = !std::is_same_v<Ty0, Ty1> && (M_Fits<Ty0, Ty1> || M_Fits<Ty1, Ty0>);
+	static constexpr std::size_t EmptyIndex = M_Fits<Ty0, Ty1> ? 0 : 1;
+	static constexpr std::size_t ValueIndex = 1 - EmptyIndex;
+};
+
+/*
+ * @function: Variant 的存储层, 对齐的字节缓冲区加上最小的下标类型
+ * @note: 平凡析构时不声明析构函数, 由 AutoControlSMF 决定其余 SMF, 所以全部候选都平凡可拷贝时
+ *     Variant 也是平凡可拷贝的. 默认构造的状态是 "无值" (下标为 Count), 只在 AutoControlSMF
+ *     的拷贝/移动构造中短暂出现.
+ */
+template <
+	bool bTrivialDestructible,
+	bool bNiche,
+	typename... Types
+>
+struct VariantStorage {
+	static constexpr std::size_t M_Count = sizeof...(Types);
+	using IndexTp = VariantIndexTp<M_Count>;
+
+	constexpr VariantStorage() noexcept : m_Index(static_cast<IndexTp>(M_Count)) {}
+
+	template <std::size_t Index, typename... Args>
+	constexpr explicit VariantStorage(std::in_place_index_t<Index>, Args&&... args)
+		noexcept(std::is_nothrow_constructible_v<VariantAlternativeTp<Index, Types...>, Args...>)
+		: m_Index(static_cast<IndexTp>(M_Count))
+	{
+		__Construct<Index>(std::forward<Args>(args)...);
+	}
+
+	~VariantStorage() requires bTrivialDestructible = default;
+	constexpr ~VariantStorage() requires (!bTrivialDestructible) {
+		__Cleanup();
+	}
+	VariantStorage(const VariantStorage&) = default;
+	VariantStorage& operator=(const VariantStorage&) = default;
+	VariantStorage(VariantStorage&&) = default;
+	VariantStorage& operator=(VariantStorage&&) = default;
+
+	[[nodiscard]] constexpr std::size_t Index() const noexcept {
+		return m_Index == static_cast<IndexTp>(M_Count) ? VariantNpos : static_cast<std::size_t>(m_Index);
+	}
+
+	template <std::size_t Index>
+	[[nodiscard]] VariantAlternativeTp<Index, Types...>* __Get() noexcept {
+		return std::launder(reinterpret_cast<VariantAlternativeTp<Index, Types...>*>(m_Storage));
+	}
+	template <std::size_t Index>
+	[[nodiscard]] const VariantAlternativeTp<Index, Types...>* __Get() const noexcept {
+		return std::launder(reinterpret_cast<const VariantAlternativeTp<Index, Types...>*>(m_Storage));
+	}
+
+	/* 调用前必须处于无值状态 */
+	template <std::size_t Index, typename... Args>
+	void __Construct(Args&&... args)
+		noexcept(std::is_nothrow_constructible_v<VariantAlternativeTp<Index, Types...>, Args...>)
+	{
+		::new (static_cast<void*>(m_Storage)) VariantAlternativeTp<Index, Types...>(std::forward<Args>(args)...);
+		m_Index = static_cast<IndexTp>(Index);
+	}
+
+	constexpr void __Cleanup() noexcept {
+		if constexpr (!bTrivialDestructible) {
+			if (m_Index != static_cast<IndexTp>(M_Count)) {
+				VariantDispatch<M_Count>(m_Index, [this](auto index) {
+					std::destroy_at(this->template __Get<decltype(index)::value>());
+				});
+			}
+		}
+		m_Index = static_cast<IndexTp>(M_Count);
+	}
+
+private:
+	alignas(Types...) unsigned char m_Storage[std::max({ sizeof(Types)... })];
+	IndexTp m_Index;
+};
+
+template <bool bTrivialDestructible, typename... Types>
+struct VariantStorage<bTrivialDestructible, true, Types...> {
+	static constexpr std::size_t M_Count = sizeof...(Types);
+	using NicheInfoTp = VariantNicheInfo<Types...>;
+	using EmptyTp = VariantAlternativeTp<NicheInfoTp::EmptyIndex, Types...>;
+	using ValueTp = VariantAlternativeTp<NicheInfoTp::ValueIndex, Types...>;
+	using NicheTraitsTp = OptionalTraits<ValueTp>;
+
+	/* 默认状态即空类型的那个候选, niche 存储没有无值状态 */
+	constexpr VariantStorage() noexcept : value(NicheTraitsTp::EmptyValue()) {}
+
+	template <std::size_t Index, typename... Args>
+	constexpr explicit VariantStorage(std::in_place_index_t<Index>, Args&&... args)
+		noexcept(std::is_nothrow_constructible_v<VariantAlternativeTp<Index, Types...>, Args...>)
+		: value(NicheTraitsTp::EmptyValue())
+	{
+		__Construct<Index>(std::forward<Args>(args)...);
+	}
+
+	~VariantStorage() requires bTrivialDestructible = default;
+	constexpr ~VariantStorage() requires (!bTrivialDestructible) {
+		value.~ValueTp();
+	}
+	VariantStorage(const VariantStorage&) = default;
+	VariantStorage& operator=(const VariantStorage&) = default;
+	VariantStorage(VariantStorage&&) = default;
+	VariantStorage& operator=(VariantStorage&&) = default;
+
+	[[nodiscard]] constexpr std::size_t Index() const noexcept {
+		return NicheTraitsTp::IsEmpty(value) ? NicheInfoTp::EmptyIndex : NicheInfoTp::ValueIndex;
+	}
+
+	template <std::size_t Index>
+	[[nodiscard]] constexpr auto* __Get() noexcept {
+		if constexpr (Index == NicheInfoTp::ValueIndex) {
+			return std::addressof(value);
+		} else {
+			return std::addressof(empty);
+		}
+	}
+	template <std::size_t Index>
+	[[nodiscard]] constexpr const auto* __Get() const noexcept {
+		if constexpr (Index == NicheInfoTp::ValueIndex) {
+			return std::addressof(value);
+		} else {
+			return std::addressof(empty);
+		}
+	}
+
+	template <std::size_t Index, typename... Args>
+	constexpr void __Construct(Args&&... args)
+		noexcept(std::is_nothrow_constructible_v<VariantAlternativeTp<Index, Types...>, Args...>)
+	{
+		if constexpr (Index == NicheInfoTp::ValueIndex) {
+			std::construct_at(&value, std::forward<Args>(args)...);
+		} else {
+			__Cleanup();
+		}
+	}
+
+	/* 重置为哨兵, 即空类型的候选 */
+	constexpr void __Cleanup() noexcept {
+		if constexpr (bTrivialDestructible) {
+			std::construct_at(&value, NicheTraitsTp::EmptyValue());
+		} else if (!NicheTraitsTp::IsEmpty(value)) {
+			value.~ValueTp();
+			std::construct_at(&value, NicheTraitsTp::EmptyValue());
+		}
+	}
+
+private:
+	union {
+		NonTrivialDummyTp dummy;
+		ValueTp value;
+	};
+	[[no_unique_address]] EmptyTp empty;
+};
+
+/*
+ * @function: 为 AutoControlSMF 提供 __ConstructFrom / __AssignFrom
+ */
+template <typename... Types>
+struct VariantConstruct : VariantStorage<
+	std::conjunction_v<std::is_trivially_destructible<Types>...>,
+	VariantNicheInfo<Types...>::HasNiche,
+	Types...
+> {
+	using MyBaseClassTp = VariantStorage<
+		std::conjunction_v<std::is_trivially_destructible<Types>...>,
+		VariantNicheInfo<Types...>::HasNiche,
+		Types...
+	>;
+	using MyBaseClassTp::MyBaseClassTp;
+
+	template <typename Self>
+	constexpr void __ConstructFrom(Self&& right)
+		noexcept(
+			std::conjunction_v<
+				std::conditional_t<
+					std::is_lvalue_reference_v<Self>,
+					std::is_nothrow_copy_constructible<Types>,
+					std::is_nothrow_move_constructible<Types>
+				>...
+			>
+		)
+	{
+		const std::size_t index = right.Index();
+		if (index == VariantNpos) {
+			return;
+		}
+		VariantDispatch<sizeof...(Types)>(index, [&](auto alternative) {
+			constexpr std::size_t Index = decltype(alternative)::value;
+			using AlternativeTp = VariantAlternativeTp<Index, Types...>;
+			using SourceTp = std::conditional_t<std::is_lvalue_reference_v<Self>, const AlternativeTp&, AlternativeTp&&>;
+			this->template __Construct<Index>(static_cast<SourceTp>(*right.template __Get<Index>()));
+		});
+	}
+
+	/* 下标相同时直接赋值, 否则先销毁再构造; 构造抛出异常时变为无值 (基本异常安全) */
+	template <typename Self>
+	constexpr void __AssignFrom(Self&& right) {
+		const std::size_t index = right.Index();
+		if (index == this->Index() && index != VariantNpos) {
+			VariantDispatch<sizeof...(Types)>(index, [&](auto alternative) {
+				constexpr std::size_t Index = decltype(alternative)::value;
+				using AlternativeTp = VariantAlternativeTp<Index, Types...>;
+				using SourceTp = std::conditional_t<std::is_lvalue_reference_v<Self>, const AlternativeTp&, AlternativeTp&&>;
+				*this->template __Get<Index>() = static_cast<SourceTp>(*right.template __Get<Index>());
+			});
+			return;
+		}
+		this->__Cleanup();
+		__ConstructFrom(std::forward<Self>(right));
+	}
+};
+
+/*
+ * @function: 和类型 (tagged union), 替代消息分发路径上的 std::variant
+ * @note: 1. 建立在 AutoControlSMF<..., Types...> 之上: 所有候选平凡可拷贝时 Variant 平凡可拷贝
+ *        2. 下标使用能容纳候选数量的最小无符号整数 (通常是 1 字节)
+ *        3. Variant<Empty, T> 且 T 存在保留的 OptionalTraits niche 时不存储下标, sizeof == sizeof(T)
+ *        4. Visit 对不超过 16 个候选的情况生成 switch, 更多时使用函数指针表
+ *        5. 转换构造只接受与某个候选完全相同的类型 (去掉 cv 与引用之后), 避免 std::variant 的隐式转换歧义;
+ *           其他情况请使用 std::in_place_type / std::in_place_index
+ */
+template <typename... Types>
+class Variant : private Traits::AutoControlSMF<VariantConstruct<Types...>, Types...> {
+	using MyBaseClassTp = Traits::AutoControlSMF<VariantConstruct<Types...>, Types...>;
+	using MyBaseClassTp::MyBaseClassTp;
+
+	template <typename Ty>
+	static constexpr bool M_IsAlternative = VariantCountOf<Ty, Types...> == 1;
+
+public:
+	static_assert(sizeof...(Types) > 0, "Variant requires at least one alternative");
+	static_assert(((std::is_object_v<Types> && !std::is_array_v<Types> && std::is_destructible_v<Types>) && ...),
+		"Variant alternatives must be destructible, non-array object types");
+	static_assert(sizeof...(Types) < std::numeric_limits<std::uint32_t>::max(), "Too many alternatives");
+
+	static constexpr std::size_t AlternativeCount = sizeof...(Types);
+	using TriviallyRelocatableTp = Traits::TriviallyRelocatableIfTp<Types...>;
+
+	/* 非模板, 否则会输给继承来的默认构造 (无值状态) */
+	constexpr Variant() noexcept(std::is_nothrow_default_constructible_v<VariantAlternativeTp<0, Types...>>)
+		requires std::is_default_constructible_v<VariantAlternativeTp<0, Types...>>
+		: MyBaseClassTp(std::in_place_index<0>) {}
+
+	template <
+		typename Ty,
+		std::enable_if_t<M_IsAlternative<std::remove_cvref_t<Ty>>, int> = 0
+	>
+	constexpr Variant(Ty&& value)
+		noexcept(std::is_nothrow_constructible_v<std::remove_cvref_t<Ty>, Ty>)
+		: MyBaseClassTp(std::in_place_index<VariantIndexOf<std::remove_cvref_t<Ty>, Types...>>, std::forward<Ty>(value)) {}
+
+	template <std::size_t Index, typename... Args>
+	constexpr explicit Variant(std::in_place_index_t<Index> tag, Args&&... args)
+		: MyBaseClassTp(tag, std::forward<Args>(args)...) {}
+
+	template <
+		typename Ty,
+		typename... Args,
+		std::enable_if_t<M_IsAlternative<Ty>, int> = 0
+	>
+	constexpr explicit Variant(std::in_place_type_t<Ty>, Args&&... args)
+		: MyBaseClassTp(std::in_place_index<VariantIndexOf<Ty, Types...>>, std::forward<Args>(args)...) {}
+
+	template <
+		typename Ty,
+		std::enable_if_t<M_IsAlternative<std::remove_cvref_t<Ty>>, int> = 0
+	>
+	constexpr Variant& operator=(Ty&& value) {
+		constexpr std::size_t Index = VariantIndexOf<std::remove_cvref_t<Ty>, Types...>;
+		if (this->Index() == Index) {
+			*this->template __Get<Index>() = std::forward<Ty>(value);
+		} else {
+			Emplace<Index>(std::forward<Ty>(value));
+		}
+		return *this;
+	}
+
+public:
+	[[nodiscard]] constexpr std::size_t Index() const noexcept {
+		return MyBaseClassTp::Index();
+	}
+	/* 只有在切换候选时构造抛出异常才会进入无值状态 */
+	[[nodiscard]] constexpr bool IsValueless() const noexcept {
+		return Index() == VariantNpos;
+	}
+	template <typename Ty>
+	[[nodiscard]] constexpr bool Is() const noexcept {
+		static_assert(M_IsAlternative<Ty>, "Variant::Is<T>() requires T to be exactly one of the alternatives");
+		return Index() == VariantIndexOf<Ty, Types...>;
+	}
+
+	template <std::size_t Index, typename... Args>
+	constexpr VariantAlternativeTp<Index, Types...>& Emplace(Args&&... args) {
+		this->__Cleanup();
+		this->template __Construct<Index>(std::forward<Args>(args)...);
+		return *this->template __Get<Index>();
+	}
+	template <typename Ty, typename... Args, std::enable_if_t<M_IsAlternative<Ty>, int> = 0>
+	constexpr Ty& Emplace(Args&&... args) {
+		return Emplace<VariantIndexOf<Ty, Types...>>(std::forward<Args>(args)...);
+	}
+
+	template <std::size_t Index>
+	[[nodiscard]] constexpr VariantAlternativeTp<Index, Types...>& Get() & {
+		M_Check(Index);
+		return *this->template __Get<Index>();
+	}
+	template <std::size_t Index>
+	[[nodiscard]] constexpr const VariantAlternativeTp<Index, Types...>& Get() const & {
+		M_Check(Index);
+		return *this->template __Get<Index>();
+	}
+	template <std::size_t Index>
+	[[nodiscard]] constexpr VariantAlternativeTp<Index, Types...>&& Get() && {
+		M_Check(Index);
+		return std::move(*this->template __Get<Index>());
+	}
+	template <typename Ty, std::enable_if_t<M_IsAlternative<Ty>, int> = 0>
+	[[nodiscard]] constexpr Ty& Get() & { return Get<VariantIndexOf<Ty, Types...>>(); }
+	template <typename Ty, std::enable_if_t<M_IsAlternative<Ty>, int> = 0>
+	[[nodiscard]] constexpr const Ty& Get() const & { return Get<VariantIndexOf<Ty, Types...>>(); }
+	template <typename Ty, std::enable_if_t<M_IsAlternative<Ty>, int> = 0>
+	[[nodiscard]] constexpr Ty&& Get() && { return std::move(*this).template Get<VariantIndexOf<Ty, Types...>>(); }
+
+	/* 不抛异常的访问, 返回 Optional<T&> */
+	template <typename Ty, std::enable_if_t<M_IsAlternative<Ty>, int> = 0>
+	[[nodiscard]] constexpr Optional<Ty&> GetIf() noexcept {
+		constexpr std::size_t Index = VariantIndexOf<Ty, Types...>;
+		if (this->Index() != Index) return nullopt;
+		return *this->template __Get<Index>();
+	}
+	template <typename Ty, std::enable_if_t<M_IsAlternative<Ty>, int> = 0>
+	[[nodiscard]] constexpr Optional<const Ty&> GetIf() const noexcept {
+		constexpr std::size_t Index = VariantIndexOf<Ty, Types...>;
+		if (this->Index() != Index) return nullopt;
+		return *this->template __Get<Index>();
+	}
+
+	/*
+	 * @function: 以当前候选调用 visitor, 所有候选的返回类型必须相同
+	 */
+	template <typename Visitor> constexpr decltype(auto) Visit(Visitor&& visitor) & { return M_Visit(*this, std::forward<Visitor>(visitor)); }
+	template <typename Visitor> constexpr decltype(auto) Visit(Visitor&& visitor) const & { return M_Visit(*this, std::forward<Visitor>(visitor)); }
+	template <typename Visitor> constexpr decltype(auto) Visit(Visitor&& visitor) && { return M_Visit(std::move(*this), std::forward<Visitor>(visitor)); }
+
+	constexpr void Swap(Variant& that) {
+		Variant temp(std::move(that));
+		that = std::move(*this);
+		*this = std::move(temp);
+	}
+
+private:
+	constexpr void M_Check(const std::size_t index) const {
+		if (Index() != index) {
+			throw std::bad_variant_access();
+		}
+	}
+
+	template <typename Self, typename Visitor>
+	static constexpr decltype(auto) M_Visit(Self&& self, Visitor&& visitor) {
+		using FirstTp = decltype(*std::forward<Self>(self).template __Get<0>());
+		using ArgTp0 = std::conditional_t<
+			std::is_lvalue_reference_v<Self>,
+			FirstTp,
+			std::remove_reference_t<FirstTp>&&
+		>;
+		using ResultTp = std::invoke_result_t<Visitor, ArgTp0>;
+		const std::size_t index = self.Index();
+		if (index == VariantNpos) {
+			throw std::bad_variant_access();
+		}
+		return VariantDispatch<sizeof...(Types)>(index, [&](auto alternative) -> ResultTp {
+			constexpr std::size_t Index = decltype(alternative)::value;
+			using AlternativeTp = decltype(*self.template __Get<Index>());
+			using ArgTp = std::conditional_t<
+				std::is_lvalue_reference_v<Self>,
+				AlternativeTp,
+				std::remove_reference_t<AlternativeTp>&&
+			>;
+			static_assert(std::is_same_v<std::invoke_result_t<Visitor, ArgTp>, ResultTp>,
+				"Variant::Visit requires the visitor to return the same type for every alternative");
+			return std::invoke(std::forward<Visitor>(visitor), static_cast<ArgTp>(*self.template __Get<Index>()));
+		});
+	}
+};
+
+template <typename Visitor, typename... Types>
+constexpr decltype(auto) Visit(Visitor&& visitor, Variant<Types...>& variant) {
+	return variant.Visit(std::forward<Visitor>(visitor));
+}
+template <typename Visitor, typename... Types>
+constexpr decltype(auto) Visit(Visitor&& visitor, const Variant<Types...>& variant) {
+	return variant.Visit(std::forward<Visitor>(visitor));
+}
+template <typename Visitor, typename... Types>
+constexpr decltype(auto) Visit(Visitor&& visitor, Variant<Types...>&& variant) {
+	return std::move(variant).Visit(std::forward<Visitor>(visitor));
+}
+
+/* 组合多个 lambda 作为 visitor */
+template <typename... Fns>
+struct Overloaded : Fns... {
+	using Fns::operator()...;
+};
+template <typename... Fns>
+Overloaded(Fns...) -> Overloaded<Fns...>;
+
+template <typename... Types>
+[[nodiscard]] constexpr bool operator==(const Variant<Types...>& left, const Variant<Types...>& right) {
+	const std::size_t index = left.Index();
+	if (index != right.Index()) {
+		return false;
+	}
+	if (index == VariantNpos) {
+		return true;
+	}
+	return VariantDispatch<sizeof...(Types)>(index, [&](auto alternative) -> bool {
+		constexpr std::size_t Index = decltype(alternative)::value;
+		return left.template Get<Index>() == right.template Get<Index>();
+	});
+}
+
+}
+
+/* 与 TypeTraits.hpp 中的 is_variant 保持一致 */
+template <typename... Types>
+struct is_variant<Core::Variant<Types...>> : std::true_type {};
@@ -0,0 +1,361 @@
+// Potato::Array 与 std::vector 的对比基准测试
+//
+// 自带的最小 harness (不依赖 Google Benchmark): 每个用例先预热一次, 再重复 Repeats 次取最短时间,
+// 输出 Array / std::vector 的耗时 (ns) 与比值. 用法:
+//     ArrayBenchmark [max_size]      默认 max_size = 100000, 测试 1000, 10000, ... 直到 max_size
+#include "Array.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int Repeats = 5;
+
+/* 阻止编译器把结果优化掉 */
+template <typename Ty>
+inline void DoNotOptimize(const Ty& value) {
+#if defined(__GNUC__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+struct Tracked {
+	int value{ 0 };
+	inline static std::size_t copies = 0;
+	inline static std::size_t moves = 0;
+
+	Tracked() noexcept = default;
+	explicit Tracked(int v) noexcept : value(v) {}
+	Tracked(const Tracked& other) noexcept : value(other.value) { ++copies; }
+	Tracked(Tracked&& other) noexcept : value(other.value) { ++moves; }
+	Tracked& operator=(const Tracked& other) noexcept { value = other.value; ++copies; return *this; }
+	Tracked& operator=(Tracked&& other) noexcept { value = other.value; ++moves; return *this; }
+	~Tracked() noexcept {}
+	bool operator==(const Tracked& other) const noexcept { return value == other.value; }
+};
+
+template <typename Ty> Ty MakeValue(std::size_t index);
+template <> int MakeValue<int>(std::size_t index) { return static_cast<int>(index); }
+/* 超过 SSO 长度, 拷贝需要分配 */
+template <> std::string MakeValue<std::string>(std::size_t index) { return "potato-array-benchmark-" + std::to_string(index); }
+template <> Tracked MakeValue<Tracked>(std::size_t index) { return Tracked(static_cast<int>(index)); }
+
+template <typename Ty> const char* TypeName();
+template <> const char* TypeName<int>() { return "int"; }
+template <> const char* TypeName<std::string>() { return "string"; }
+template <> const char* TypeName<Tracked>() { return "Tracked"; }
+
+template <typename Ty> bool IsEven(const Ty& value);
+template <> bool IsEven<int>(const int& value) { return value % 2 == 0; }
+template <> bool IsEven<std::string>(const std::string& value) { return (value.back() - '0') % 2 == 0; }
+template <> bool IsEven<Tracked>(const Tracked& value) { return value.value % 2 == 0; }
+
+/* 两种容器的统一接口 */
+template <typename Ty> void PushBack(Potato::Array<Ty>& c, const Ty& v) { c.Append(v); }
+template <typename Ty> void PushBack(std::vector<Ty>& c, const Ty& v) { c.push_back(v); }
+template <typename Ty> void EmplaceBack(Potato::Array<Ty>& c, std::size_t i) { c.EmplaceBack(MakeValue<Ty>(i)); }
+template <typename Ty> void EmplaceBack(std::vector<Ty>& c, std::size_t i) { c.emplace_back(MakeValue<Ty>(i)); }
+template <typename Ty> void InsertAt(Potato::Array<Ty>& c, std::size_t pos, const Ty& v) { c.Insert(c.cbegin() + pos, v); }
+template <typename Ty> void InsertAt(std::vector<Ty>& c, std::size_t pos, const Ty& v) { c.insert(c.cbegin() + pos, v); }
+template <typename Ty> std::size_t Count(const Potato::Array<Ty>& c) { return c.Size(); }
+template <typename Ty> std::size_t Count(const std::vector<Ty>& c) { return c.size(); }
+template <typename Ty, typename Pred> void EraseIf(Potato::Array<Ty>& c, Pred pred) { c.EraseIf(pred); }
+template <typename Ty, typename Pred> void EraseIf(std::vector<Ty>& c, Pred pred) { std::erase_if(c, pred); }
+template <typename Ty> void Reserve(Potato::Array<Ty>& c, std::size_t n) { c.Reserve(n); }
+template <typename Ty> void Reserve(std::vector<Ty>& c, std::size_t n) { c.reserve(n); }
+template <typename Ty> void ShrinkToFit(Potato::Array<Ty>& c) { c.ShrinkToFit(); }
+template <typename Ty> void ShrinkToFit(std::vector<Ty>& c) { c.shrink_to_fit(); }
+template <typename Ty> std::size_t FindIndex(const Potato::Array<Ty>& c, const Ty& v) { return c.Find(v); }
+template <typename Ty> std::size_t FindIndex(const std::vector<Ty>& c, const Ty& v) { return static_cast<std::size_t>(std::find(c.begin(), c.end(), v) - c.begin()); }
+template <typename Ty> std::size_t CountOf(const Potato::Array<Ty>& c, const Ty& v) { return c.Count(v); }
+template <typename Ty> std::size_t CountOf(const std::vector<Ty>& c, const Ty& v) { return static_cast<std::size_t>(std::count(c.begin(), c.end(), v)); }
+template <typename Ty> bool Contains(const Potato::Array<Ty>& c, const Ty& v) { return c.IsContain(v); }
+template <typename Ty> bool Contains(const std::vector<Ty>& c, const Ty& v) { return std::find(c.begin(), c.end(), v) != c.end(); }
+template <typename Ty, typename Pred> auto Filter(const Potato::Array<Ty>& c, Pred pred) { return c.Filter(pred); }
+template <typename Ty, typename Pred> auto Filter(const std::vector<Ty>& c, Pred pred) {
+	std::vector<Ty> result;
+	std::copy_if(c.begin(), c.end(), std::back_inserter(result), pred);
+	return result;
+}
+template <typename Ty, typename Fn> auto Transform(const Potato::Array<Ty>& c, Fn fn) { return c.Transform(fn); }
+template <typename Ty, typename Fn> auto Transform(const std::vector<Ty>& c, Fn fn) {
+	std::vector<std::invoke_result_t<Fn, const Ty&>> result;
+	result.reserve(c.size());
+	std::transform(c.begin(), c.end(), std::back_inserter(result), fn);
+	return result;
+}
+
+template <typename Container>
+Container MakeFilled(std::size_t size) {
+	using Ty = typename Container::value_type;
+	Container c;
+	for (std::size_t i = 0; i < size; ++i) PushBack(c, MakeValue<Ty>(i));
+	return c;
+}
+
+/* setup 的耗时不计入; body 接收 setup 的结果 */
+template <typename Setup, typename Body>
+double MeasureNs(Setup setup, Body body) {
+	double best = 0;
+	for (int run = 0; run <= Repeats; ++run) {
+		auto state = setup();
+		const auto t0 = Clock::now();
+		body(state);
+		const auto t1 = Clock::now();
+		DoNotOptimize(state);
+		const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+		/* 第 0 次是预热 */
+		if (run == 1 || (run > 1 && ns < best)) best = ns;
+	}
+	return best;
+}
+
+struct NoState {};
+
+/* 每个用例对两种容器各跑一次, Case 是以容器类型为参数的模板 */
+template <template <typename> class Case, typename Ty>
+void Run(std::size_t size) {
+	const double array_ns = Case<Potato::Array<Ty>>::Measure(size);
+	const double vector_ns = Case<std::vector<Ty>>::Measure(size);
+	std::printf("%-14s %-8s %9zu %14.0f %14.0f %8.2f\n",
+		Case<std::vector<Ty>>::Name, TypeName<Ty>(), size, array_ns, vector_ns, array_ns / vector_ns);
+}
+
+template <typename Container>
+struct AppendCase {
+	static constexpr const char* Name = "Append";
+	static double Measure(std::size_t size) {
+		using Ty = typename Container::value_type;
+		std::vector<Ty> values;
+		for (std::size_t i = 0; i < size; ++i) values.push_back(MakeValue<Ty>(i));
+		return MeasureNs([] { return Container{}; }, [&](Container& c) {
+			for (const auto& v : values) PushBack(c, v);
+		});
+	}
+};
+
+template <typename Container>
+struct EmplaceBackCase {
+	static constexpr const char* Name = "EmplaceBack";
+	static double Measure(std::size_t size) {
+		return MeasureNs([] { return Container{}; }, [&](Container& c) {
+			for (std::size_t i = 0; i < size; ++i) EmplaceBack(c, i);
+		});
+	}
+};
+
+/* 插入次数限制在 1000 次以内, 否则大尺寸下是 O(n^2) */
+template <typename Container>
+struct InsertFrontCase {
+	static constexpr const char* Name = "InsertFront";
+	static double Measure(std::size_t size) {
+		using Ty = typename Container::value_type;
+		const std::size_t inserts = std::min<std::size_t>(size, 1000);
+		const Ty value = MakeValue<Ty>(size);
+		return MeasureNs([&] { return MakeFilled<Container>(size); }, [&](Container& c) {
+			for (std::size_t i = 0; i < inserts; ++i) InsertAt(c, 0, value);
+		});
+	}
+};
+
+template <typename Container>
+struct InsertMiddleCase {
+	static constexpr const char* Name = "InsertMiddle";
+	static double Measure(std::size_t size) {
+		using Ty = typename Container::value_type;
+		const std::size_t inserts = std::min<std::size_t>(size, 1000);
+		const Ty value = MakeValue<Ty>(size);
+		return MeasureNs([&] { return MakeFilled<Container>(size); }, [&](Container& c) {
+			for (std::size_t i = 0; i < inserts; ++i) InsertAt(c, Count(c) / 2, value);
+		});
+	}
+};
+
+template <typename Container>
+struct EraseIfCase {
+	static constexpr const char* Name = "EraseIf";
+	static double Measure(std::size_t size) {
+		using Ty = typename Container::value_type;
+		return MeasureNs([&] { return MakeFilled<Container>(size); }, [](Container& c) {
+			EraseIf(c, [](const Ty& v) { return IsEven(v); });
+		});
+	}
+};
+
+template <typename Container>
+struct ReserveShrinkCase {
+	static constexpr const char* Name = "Reserve+Shrink";
+	static double Measure(std::size_t size) {
+		using Ty = typename Container::value_type;
+		const Ty value = MakeValue<Ty>(size);
+		return MeasureNs([] { return Container{}; }, [&](Container& c) {
+			Reserve(c, size * 2);
+			for (std::size_t i = 0; i < size; ++i) PushBack(c, value);
+			ShrinkToFit(c);
+		});
+	}
+};
+
+template <typename Container>
+struct CopyCase {
+	static constexpr const char* Name = "Copy";
+	static double Measure(std::size_t size) {
+		const Container source = MakeFilled<Container>(size);
+		return MeasureNs([] { return NoState{}; }, [&](NoState&) {
+			Container copy(source);
+			DoNotOptimize(copy);
+		});
+	}
+};
+
+template <typename Container>
+struct MoveCase {
+	static constexpr const char* Name = "Move";
+	static double Measure(std::size_t size) {
+		return MeasureNs([&] { return MakeFilled<Container>(size); }, [](Container& c) {
+			Container moved(std::move(c));
+			DoNotOptimize(moved);
+		});
+	}
+};
+
+/* 查找最后一个元素, 即完整扫描一遍 */
+template <typename Container>
+struct FindCase {
+	static constexpr const char* Name = "Find";
+	static double Measure(std::size_t size) {
+		using Ty = typename Container::value_type;
+		const Container c = MakeFilled<Container>(size);
+		const Ty target = MakeValue<Ty>(size - 1);
+		return MeasureNs([] { return NoState{}; }, [&](NoState&) { DoNotOptimize(FindIndex(c, target)); });
+	}
+};
+
+template <typename Container>
+struct CountCase {
+	static constexpr const char* Name = "Count";
+	static double Measure(std::size_t size) {
+		using Ty = typename Container::value_type;
+		const Container c = MakeFilled<Container>(size);
+		const Ty target = MakeValue<Ty>(size / 2);
+		return MeasureNs([] { return NoState{}; }, [&](NoState&) { DoNotOptimize(CountOf(c, target)); });
+	}
+};
+
+template <typename Container>
+struct IsContainCase {
+	static constexpr const char* Name = "IsContain";
+	static double Measure(std::size_t size) {
+		using Ty = typename Container::value_type;
+		const Container c = MakeFilled<Container>(size);
+		const Ty target = MakeValue<Ty>(size);
+		return MeasureNs([] { return NoState{}; }, [&](NoState&) { DoNotOptimize(Contains(c, target)); });
+	}
+};
+
+template <typename Container>
+struct FilterCase {
+	static constexpr const char* Name = "Filter";
+	static double Measure(std::size_t size) {
+		using Ty = typename Container::value_type;
+		const Container c = MakeFilled<Container>(size);
+		return MeasureNs([] { return NoState{}; }, [&](NoState&) {
+			auto result = Filter(c, [](const Ty& v) { return IsEven(v); });
+			DoNotOptimize(result);
+		});
+	}
+};
+
+template <typename Container>
+struct TransformCase {
+	static constexpr const char* Name = "Transform";
+	static double Measure(std::size_t size) {
+		using Ty = typename Container::value_type;
+		const Container c = MakeFilled<Container>(size);
+		return MeasureNs([] { return NoState{}; }, [&](NoState&) {
+			auto result = Transform(c, [](const Ty& v) { return IsEven(v) ? 1 : 0; });
+			DoNotOptimize(result);
+		});
+	}
+};
+
+template <typename Ty>
+void RunAll(std::size_t size) {
+	Run<AppendCase, Ty>(size);
+	Run<EmplaceBackCase, Ty>(size);
+	Run<InsertFrontCase, Ty>(size);
+	Run<InsertMiddleCase, Ty>(size);
+	Run<EraseIfCase, Ty>(size);
+	Run<ReserveShrinkCase, Ty>(size);
+	Run<CopyCase, Ty>(size);
+	Run<MoveCase, Ty>(size);
+	Run<FindCase, Ty>(size);
+	Run<CountCase, Ty>(size);
+	Run<IsContainCase, Ty>(size);
+	Run<FilterCase, Ty>(size);
+	Run<TransformCase, Ty>(size);
+}
+
+/**
+ * 搬运远大于 LLC 的数组: 对比普通 memcpy 与 TrivialRelocate (non-temporal) 的耗时,
+ * 以及搬运之后再次遍历一个 "热" 工作集的耗时, 后者反映了扩容对缓存的污染程度
+ */
+void StreamingRelocation(std::size_t count) {
+	std::vector<int> source(count);
+	for (std::size_t i = 0; i < count; ++i) source[i] = static_cast<int>(i);
+	std::vector<int> dest(count);
+	std::vector<int> hot(1u << 18, 1); // 1 MiB 的热工作集
+
+	auto probe_hot = [&hot] {
+		const auto t0 = Clock::now();
+		std::uint64_t sum = 0;
+		for (int v : hot) sum += v;
+		DoNotOptimize(sum);
+		return std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+	};
+
+	probe_hot();
+	const auto t0 = Clock::now();
+	std::memcpy(dest.data(), source.data(), count * sizeof(int));
+	const auto t1 = Clock::now();
+	const double memcpy_hot_us = probe_hot();
+
+	probe_hot();
+	const auto t2 = Clock::now();
+	Potato::MemoryTools::TrivialRelocate(dest.data(), source.data(), count);
+	const auto t3 = Clock::now();
+	const double streaming_hot_us = probe_hot();
+	DoNotOptimize(dest.data());
+
+	std::printf("streaming relocation (%zu ints): memcpy %.1f ms (hot probe %.0f us), streaming %.1f ms (hot probe %.0f us)\n",
+		count, std::chrono::duration<double, std::milli>(t1 - t0).count(), memcpy_hot_us,
+		std::chrono::duration<double, std::milli>(t3 - t2).count(), streaming_hot_us);
+}
+
+}
+
+int main(int argc, char** argv) {
+	std::size_t max_size = 100000;
+	if (argc > 1) {
+		max_size = static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+	}
+	std::printf("%-14s %-8s %9s %14s %14s %8s\n", "case", "type", "size", "Array(ns)", "vector(ns)", "ratio");
+	for (std::size_t size = 1000; size <= max_size; size *= 10) {
+		Bench::RunAll<int>(size);
+		Bench::RunAll<std::string>(size);
+		Bench::RunAll<Bench::Tracked>(size);
+	}
+	Bench::StreamingRelocation(std::size_t{ 1 } << 24); // 64 MiB 的 int, 超过默认的 non-temporal 阈值
+	return 0;
+}
@@ -0,0 +1,373 @@
+// Potato::Array 与 std::vector 的差分模糊测试
+//
+// 输入的字节流被解释为一串操作 (Append / Insert / Erase / Resize / Reserve / ShrinkToFit ...),
+// 同时作用在 Potato::Array 与 std::vector 上, 每一步之后比较大小, 返回的位置与全部元素, 不一致时 abort.
+// 第一个字节选择元素类型, 覆盖 Array 的三条内部路径:
+//     int                     平凡类型, memcpy / memmove
+//     std::string             非平凡且不可重定位, 逐个移动构造
+//     std::shared_ptr<int>    非平凡但可平凡重定位 (TraitsTools::TriviallyRelocatable)
+// Linux 上用 perf_event_open 统计每种操作在 Array 上执行的用户态指令数, 进程退出时输出到 stderr;
+// 不可用时 (容器, 权限, 非 Linux) 静默跳过.
+// 用法:
+//     clang: 定义 POTATO_LIBFUZZER 并以 -fsanitize=fuzzer,address,undefined 编译, 按 libFuzzer 的方式运行
+//     其他:  ArrayFuzz [runs] [seed]     生成 runs 个随机输入 (默认 10000)
+//            ArrayFuzz file...           逐个运行给定的输入文件 (例如 libFuzzer 的语料或崩溃样本)
+#include "Array.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+namespace Fuzz {
+
+constexpr std::size_t MaxSize = 4096;
+constexpr std::size_t MaxCount = 64;
+
+enum Operation : std::uint8_t {
+	OpAppend,
+	OpEmplaceBack,
+	OpInsert,
+	OpInsertCount,
+	OpInsertRange,
+	OpInsertZeroed,
+	OpAppendRange,
+	OpErase,
+	OpEraseRange,
+	OpEraseIf,
+	OpPop,
+	OpResize,
+	OpResizeValue,
+	OpReserve,
+	OpShrinkToFit,
+	OpClear,
+	OpCopyAssign,
+	OpCount,
+};
+
+constexpr const char* OperationNames[OpCount] = {
+	"Append", "EmplaceBack", "Insert", "InsertCount", "InsertRange", "InsertZeroed", "AppendRange",
+	"Erase", "EraseRange", "EraseIf", "Pop", "Resize", "ResizeValue", "Reserve", "ShrinkToFit", "Clear", "CopyAssign",
+};
+
+/**
+ * @brief: 用户态指令计数器, 每种操作累计调用次数, 总指令数与单次最大指令数
+ * @note: 计数器在第一次使用时打开, 之后一直处于启用状态, 每次操作前后各 read 一次
+ */
+class InstructionCounter {
+public:
+	InstructionCounter() {
+#if defined(__linux__)
+		perf_event_attr attr{};
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		m_Fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+		if (m_Fd >= 0) {
+			ioctl(m_Fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(m_Fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+
+	~InstructionCounter() {
+		if (m_Fd < 0) return;
+		std::fprintf(stderr, "%-14s %12s %16s %14s %12s\n", "operation", "calls", "instructions", "avg", "max");
+		for (int op = 0; op < OpCount; ++op) {
+			if (m_Calls[op] == 0) continue;
+			std::fprintf(stderr, "%-14s %12llu %16llu %14.1f %12llu\n", OperationNames[op],
+				static_cast<unsigned long long>(m_Calls[op]), static_cast<unsigned long long>(m_Total[op]),
+				static_cast<double>(m_Total[op]) / static_cast<double>(m_Calls[op]), static_cast<unsigned long long>(m_Max[op]));
+		}
+#if defined(__linux__)
+		close(m_Fd);
+#endif
+	}
+
+	[[nodiscard]] std::uint64_t Read() const noexcept {
+		std::uint64_t value = 0;
+#if defined(__linux__)
+		if (m_Fd >= 0 && read(m_Fd, &value, sizeof(value)) != sizeof(value)) value = 0;
+#endif
+		return value;
+	}
+
+	void Add(const Operation op, const std::uint64_t instructions) noexcept {
+		++m_Calls[op];
+		m_Total[op] += instructions;
+		m_Max[op] = std::max(m_Max[op], instructions);
+	}
+
+	[[nodiscard]] bool IsAvailable() const noexcept { return m_Fd >= 0; }
+
+	static InstructionCounter& Instance() {
+		static InstructionCounter counter;
+		return counter;
+	}
+
+private:
+	int m_Fd{ -1 };
+	std::uint64_t m_Calls[OpCount]{};
+	std::uint64_t m_Total[OpCount]{};
+	std::uint64_t m_Max[OpCount]{};
+};
+
+/* 只统计 Array 一侧的操作 */
+template <typename Fn>
+decltype(auto) Measure(const Operation op, Fn fn) {
+	auto& counter = InstructionCounter::Instance();
+	if (!counter.IsAvailable()) return fn();
+	struct Scope {
+		InstructionCounter& counter;
+		Operation op;
+		std::uint64_t begin;
+		~Scope() { counter.Add(op, counter.Read() - begin); }
+	} scope{ counter, op, counter.Read() };
+	return fn();
+}
+
+/* 输入耗尽之后一律返回 0 */
+class Input {
+public:
+	Input(const std::uint8_t* data, const std::size_t size) noexcept : m_Data(data), m_Size(size) {}
+
+	[[nodiscard]] bool IsEmpty() const noexcept { return m_Offset >= m_Size; }
+	std::uint8_t Byte() noexcept { return m_Offset < m_Size ? m_Data[m_Offset++] : 0; }
+	std::uint16_t Word() noexcept { return static_cast<std::uint16_t>(Byte() | (Byte() << 8)); }
+	/* [0, bound] 内的整数 */
+	std::size_t Below(const std::size_t bound) noexcept { return Word() % (bound + 1); }
+
+private:
+	const std::uint8_t* m_Data;
+	std::size_t m_Size;
+	std::size_t m_Offset{ 0 };
+};
+
+inline void Check(const bool condition, const char* what, const Operation op) {
+	if (condition) [[likely]] return;
+	std::fprintf(stderr, "Array/std::vector mismatch after %s: %s\n", OperationNames[op], what);
+	std::abort();
+}
+
+template <typename Ty> Ty MakeValue(std::uint16_t seed);
+template <> int MakeValue<int>(std::uint16_t seed) { return static_cast<int>(seed); }
+/* 一部分超过 SSO 长度, 搬运时需要真正的移动 */
+template <> std::string MakeValue<std::string>(std::uint16_t seed) {
+	return seed % 3 == 0 ? "potato-array-fuzz-long-string-" + std::to_string(seed) : std::to_string(seed);
+}
+template <> std::shared_ptr<int> MakeValue<std::shared_ptr<int>>(std::uint16_t seed) { return std::make_shared<int>(seed); }
+
+inline long long Key(const int value) { return value; }
+inline long long Key(const std::string& value) { return static_cast<long long>(value.size()) * 131 + (value.empty() ? 0 : value.back()); }
+inline long long Key(const std::shared_ptr<int>& value) { return value ? *value : -1; }
+
+inline bool Equal(const int a, const int b) { return a == b; }
+inline bool Equal(const std::string& a, const std::string& b) { return a == b; }
+/* 值初始化的 shared_ptr 为空; 两边共享同一批对象时比较指向的值 */
+inline bool Equal(const std::shared_ptr<int>& a, const std::shared_ptr<int>& b) { return Key(a) == Key(b); }
+
+template <typename Ty>
+void Compare(const Potato::Array<Ty>& array, const std::vector<Ty>& vector, const Operation op) {
+	Check(array.Size() == vector.size(), "size", op);
+	Check(array.Capacity() >= array.Size(), "capacity < size", op);
+	Check(array.IsEmpty() == vector.empty(), "IsEmpty", op);
+	for (std::size_t i = 0; i < vector.size(); ++i) {
+		Check(Equal(array[i], vector[i]), "element", op);
+	}
+}
+
+template <typename Ty>
+void Run(Input& input) {
+	Potato::Array<Ty> array;
+	std::vector<Ty> vector;
+
+	while (!input.IsEmpty()) {
+		const auto op = static_cast<Operation>(input.Byte() % OpCount);
+		const std::size_t size = vector.size();
+		const std::size_t room = MaxSize - std::min(size, MaxSize);
+		const Ty value = MakeValue<Ty>(input.Word());
+
+		switch (op) {
+		case OpAppend:
+			if (room == 0) break;
+			Measure(op, [&] { array.Append(value); });
+			vector.push_back(value);
+			break;
+		case OpEmplaceBack:
+			if (room == 0) break;
+			Measure(op, [&] { array.EmplaceBack(value); });
+			vector.emplace_back(value);
+			break;
+		case OpInsert: {
+			if (room == 0) break;
+			const std::size_t pos = input.Below(size);
+			const auto it = Measure(op, [&] { return array.Insert(array.cbegin() + pos, value); });
+			vector.insert(vector.cbegin() + pos, value);
+			Check(static_cast<std::size_t>(it - array.begin()) == pos, "Insert return", op);
+			break;
+		}
+		case OpInsertCount: {
+			const std::size_t pos = input.Below(size);
+			const std::size_t count = std::min(input.Below(MaxCount), room);
+			const auto it = Measure(op, [&] { return array.Insert(array.cbegin() + pos, count, value); });
+			vector.insert(vector.cbegin() + pos, count, value);
+			Check(static_cast<std::size_t>(it - array.begin()) == pos, "Insert(count) return", op);
+			break;
+		}
+		case OpInsertRange: {
+			const std::size_t pos = input.Below(size);
+			const std::size_t count = std::min(input.Below(MaxCount), room);
+			std::vector<Ty> source;
+			for (std::size_t i = 0; i < count; ++i) source.push_back(MakeValue<Ty>(input.Word()));
+			const auto it = Measure(op, [&] { return array.Insert(array.cbegin() + pos, source.begin(), source.end()); });
+			vector.insert(vector.cbegin() + pos, source.begin(), source.end());
+			Check(static_cast<std::size_t>(it - array.begin()) == pos, "Insert(range) return", op);
+			break;
+		}
+		case OpInsertZeroed: {
+			const std::size_t pos = input.Below(size);
+			const std::size_t count = std::min(input.Below(MaxCount), room);
+			if (count == 0) break;
+			Measure(op, [&] { array.InsertZeroedItem(array.cbegin() + pos, count); });
+			vector.insert(vector.cbegin() + pos, count, Ty{});
+			break;
+		}
+		case OpAppendRange: {
+			/* 有时以自身为源, 覆盖扩容时的别名问题 */
+			const std::size_t count = std::min(input.Below(MaxCount), room);
+			if (input.Byte() % 4 == 0 && count <= size) {
+				Measure(op, [&] { array.Append(static_cast<const Ty*>(array.Data()), count); });
+				std::vector<Ty> prefix(vector.begin(), vector.begin() + static_cast<std::ptrdiff_t>(count));
+				vector.insert(vector.end(), prefix.begin(), prefix.end());
+			} else {
+				std::vector<Ty> source;
+				for (std::size_t i = 0; i < count; ++i) source.push_back(MakeValue<Ty>(input.Word()));
+				Measure(op, [&] { array.Append(source.begin(), source.end()); });
+				vector.insert(vector.end(), source.begin(), source.end());
+			}
+			break;
+		}
+		case OpErase: {
+			if (size == 0) break;
+			const std::size_t pos = input.Below(size - 1);
+			const auto it = Measure(op, [&] { return array.Erase(array.cbegin() + pos); });
+			vector.erase(vector.cbegin() + pos);
+			Check(static_cast<std::size_t>(it - array.begin()) == pos, "Erase return", op);
+			break;
+		}
+		case OpEraseRange: {
+			const std::size_t first = input.Below(size);
+			const std::size_t last = first + input.Below(size - first);
+			const auto it = Measure(op, [&] { return array.Erase(array.cbegin() + first, array.cbegin() + last); });
+			vector.erase(vector.cbegin() + first, vector.cbegin() + last);
+			Check(static_cast<std::size_t>(it - array.begin()) == first, "Erase(range) return", op);
+			break;
+		}
+		case OpEraseIf: {
+			const long long modulus = input.Byte() % 5 + 2;
+			auto pred = [modulus](const Ty& element) { return Key(element) % modulus == 0; };
+			Measure(op, [&] { array.EraseIf(pred); });
+			std::erase_if(vector, pred);
+			break;
+		}
+		case OpPop:
+			if (size == 0) break;
+			Measure(op, [&] { array.Pop(); });
+			vector.pop_back();
+			break;
+		case OpResize: {
+			const std::size_t count = input.Below(std::min(size + MaxCount, MaxSize));
+			Measure(op, [&] { array.Resize(count); });
+			vector.resize(count);
+			break;
+		}
+		case OpResizeValue: {
+			const std::size_t count = input.Below(std::min(size + MaxCount, MaxSize));
+			Measure(op, [&] { array.Resize(count, value); });
+			vector.resize(count, value);
+			break;
+		}
+		case OpReserve: {
+			const std::size_t capacity = input.Below(MaxSize);
+			Measure(op, [&] { array.Reserve(capacity); });
+			vector.reserve(capacity);
+			Check(array.Capacity() >= capacity, "Reserve capacity", op);
+			break;
+		}
+		case OpShrinkToFit:
+			Measure(op, [&] { array.ShrinkToFit(); });
+			vector.shrink_to_fit();
+			break;
+		case OpClear:
+			Measure(op, [&] { array.Clear(); });
+			vector.clear();
+			break;
+		case OpCopyAssign: {
+			const Potato::Array<Ty> copy = array;
+			Compare(copy, vector, op);
+			Measure(op, [&] { array.Assign(copy.begin(), copy.end()); });
+			break;
+		}
+		case OpCount:
+			break;
+		}
+		Compare(array, vector, op);
+	}
+}
+
+inline void RunOne(const std::uint8_t* data, const std::size_t size) {
+	Input input(data, size);
+	switch (input.Byte() % 3) {
+	case 0: Run<int>(input); break;
+	case 1: Run<std::string>(input); break;
+	default: Run<std::shared_ptr<int>>(input); break;
+	}
+}
+
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+	Fuzz::RunOne(data, size);
+	return 0;
+}
+
+#if !defined(POTATO_LIBFUZZER)
+int main(int argc, char** argv) {
+	if (argc > 1 && !(argv[1][0] >= '0' && argv[1][0] <= '9')) {
+		for (int i = 1; i < argc; ++i) {
+			std::ifstream file(argv[i], std::ios::binary);
+			const std::vector<std::uint8_t> bytes{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+			LLVMFuzzerTestOneInput(bytes.data(), bytes.size());
+		}
+		std::printf("ran %d inputs\n", argc - 1);
+		return 0;
+	}
+
+	const std::size_t runs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+	const std::uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::random_device{}();
+	std::mt19937_64 random(seed);
+	std::vector<std::uint8_t> bytes;
+	for (std::size_t run = 0; run < runs; ++run) {
+		bytes.resize(random() % 4096);
+		for (auto& byte : bytes) byte = static_cast<std::uint8_t>(random());
+		LLVMFuzzerTestOneInput(bytes.data(), bytes.size());
+	}
+	std::printf("ran %zu random inputs, seed %llu\n", runs, static_cast<unsigned long long>(seed));
+	return 0;
+}
+#endif
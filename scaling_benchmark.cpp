@@ -0,0 +1,377 @@
+// Potato::Array 的多线程伸缩性基准测试
+//
+// 扫描线程数 (1, 2, 4, ... 直到 max_threads) 与元素大小 (8 / 64 / 256 字节), 两类场景:
+//     churn:  每个线程反复创建自己的 Array, Reserve 一次然后 Append 到 ChurnElements 个元素再销毁,
+//             分别使用 std::allocator, 线程私有的 Arena (只增不减, 每轮整体归还) 与 Pool (按 2 的幂分级的空闲链表)
+//     shared: 所有线程并发读同一个只读的有序 Array, 每次操作是一次随机 LowerBound
+// 每行输出 ops/sec, 单次操作延迟的 p50 / p99 / p999 (ns) 以及这一轮前后 RSS 的增长 (KiB).
+// 每次操作都单独计时, 延迟中包含一次 steady_clock::now() 的开销 (约 20ns), 吞吐量不包含.
+// 用法:
+//     ScalingBenchmark [max_threads] [--json]     默认 max_threads = hardware_concurrency, 默认输出 CSV
+#include "Array.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <latch>
+#include <memory>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#  include <unistd.h>
+#endif
+
+namespace Bench {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t ChurnRounds = 64;
+constexpr std::size_t ChurnElements = 1024;
+constexpr std::size_t ChurnReserve = 64;
+constexpr std::size_t SharedElements = 1 << 16;
+constexpr std::size_t SharedLookups = 1 << 16;
+
+/* 阻止编译器把结果优化掉 */
+template <typename Ty>
+inline void DoNotOptimize(const Ty& value) {
+#if defined(__GNUC__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+template <std::size_t Bytes>
+struct Blob {
+	static_assert(Bytes >= sizeof(std::uint64_t));
+	std::uint64_t key;
+	unsigned char payload[Bytes - sizeof(std::uint64_t)];
+
+	explicit Blob(std::uint64_t k = 0) noexcept : key(k) { std::memset(payload, static_cast<int>(k), sizeof(payload)); }
+	bool operator<(const Blob& other) const noexcept { return key < other.key; }
+	bool operator==(const Blob& other) const noexcept { return key == other.key; }
+};
+
+/* 只有键, 没有 payload (零长度数组不是合法的 C++) */
+template <>
+struct Blob<sizeof(std::uint64_t)> {
+	std::uint64_t key;
+
+	explicit Blob(std::uint64_t k = 0) noexcept : key(k) {}
+	bool operator<(const Blob& other) const noexcept { return key < other.key; }
+	bool operator==(const Blob& other) const noexcept { return key == other.key; }
+};
+
+/* 当前进程的常驻内存 (KiB), 只在 Linux 上可用, 其他平台返回 0 */
+inline long ResidentKiB() {
+#if defined(__linux__)
+	long pages = 0;
+	if (std::FILE* statm = std::fopen("/proc/self/statm", "r")) {
+		long size = 0;
+		if (std::fscanf(statm, "%ld %ld", &size, &pages) != 2) pages = 0;
+		std::fclose(statm);
+	}
+	return pages * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief: 线程私有的 bump 分配器, deallocate 什么都不做, 每轮结束时 Reset 把所有块一次性复用
+ * @note: 状态在 thread_local 中, 分配器本身无状态 (is_always_equal), 只能在同一个线程内分配与释放
+ */
+class ArenaState {
+public:
+	static constexpr std::size_t ChunkSize = 1 << 20;
+
+	~ArenaState() {
+		for (void* chunk : m_Chunks) ::operator delete(chunk, std::align_val_t{ alignof(std::max_align_t) });
+		M_ReleaseLarge();
+	}
+
+	void* Allocate(std::size_t bytes) {
+		bytes = (bytes + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+		if (bytes > ChunkSize) {
+			/* 超大块单独保存: 放进 m_Chunks 会被 M_NextChunk 当作空闲块, 交出与仍在使用的内存重叠的地址 */
+			m_Large.reserve(m_Large.size() + 1);
+			void* large = ::operator new(bytes, std::align_val_t{ alignof(std::max_align_t) });
+			m_Large.push_back(large);
+			return large;
+		}
+		if (m_Offset + bytes > ChunkSize) {
+			M_NextChunk();
+		}
+		void* result = static_cast<char*>(m_Chunks[m_Current]) + m_Offset;
+		m_Offset += bytes;
+		return result;
+	}
+
+	/* 之前分配的普通块全部复用, 不归还给系统; 超大块大小不一, 直接释放 */
+	void Reset() noexcept {
+		m_Current = 0;
+		m_Offset = m_Chunks.empty() ? ChunkSize : 0;
+		M_ReleaseLarge();
+	}
+
+	static ArenaState& Local() {
+		thread_local ArenaState state;
+		return state;
+	}
+
+private:
+	void M_ReleaseLarge() noexcept {
+		for (void* large : m_Large) ::operator delete(large, std::align_val_t{ alignof(std::max_align_t) });
+		m_Large.clear();
+	}
+
+	void M_NextChunk() {
+		if (m_Current + 1 < m_Chunks.size()) {
+			++m_Current;
+		} else {
+			m_Chunks.push_back(::operator new(ChunkSize, std::align_val_t{ alignof(std::max_align_t) }));
+			m_Current = m_Chunks.size() - 1;
+		}
+		m_Offset = 0;
+	}
+
+	std::vector<void*> m_Chunks;
+	std::vector<void*> m_Large;
+	std::size_t m_Current{ 0 };
+	std::size_t m_Offset{ ChunkSize };
+};
+
+template <typename Ty>
+struct ArenaAllocator {
+	using value_type = Ty;
+	using is_always_equal = std::true_type;
+
+	ArenaAllocator() = default;
+	template <typename Uty> ArenaAllocator(const ArenaAllocator<Uty>&) noexcept {}
+
+	Ty* allocate(std::size_t count) { return static_cast<Ty*>(ArenaState::Local().Allocate(count * sizeof(Ty))); }
+	void deallocate(Ty*, std::size_t) noexcept {}
+	template <typename Uty> bool operator==(const ArenaAllocator<Uty>&) const noexcept { return true; }
+};
+
+/**
+ * @brief: 线程私有的分级空闲链表, 块大小向上取 2 的幂, 释放时挂回对应的链表, 线程退出时归还
+ */
+class PoolState {
+public:
+	static constexpr std::size_t ClassCount = 48;
+
+	~PoolState() {
+		for (std::size_t index = 0; index < ClassCount; ++index) {
+			while (Node* node = m_Free[index]) {
+				m_Free[index] = node->next;
+				::operator delete(node);
+			}
+		}
+	}
+
+	void* Allocate(const std::size_t bytes) {
+		const std::size_t index = M_ClassOf(bytes);
+		if (Node* node = m_Free[index]) {
+			m_Free[index] = node->next;
+			return node;
+		}
+		return ::operator new(std::size_t{ 1 } << index);
+	}
+
+	void Deallocate(void* pointer, const std::size_t bytes) noexcept {
+		Node* node = static_cast<Node*>(pointer);
+		const std::size_t index = M_ClassOf(bytes);
+		node->next = m_Free[index];
+		m_Free[index] = node;
+	}
+
+	static PoolState& Local() {
+		thread_local PoolState state;
+		return state;
+	}
+
+private:
+	struct Node { Node* next; };
+
+	static std::size_t M_ClassOf(const std::size_t bytes) noexcept {
+		return static_cast<std::size_t>(std::bit_width(std::max(bytes, sizeof(Node)) - 1));
+	}
+
+	Node* m_Free[ClassCount]{};
+};
+
+template <typename Ty>
+struct PoolAllocator {
+	using value_type = Ty;
+	using is_always_equal = std::true_type;
+
+	PoolAllocator() = default;
+	template <typename Uty> PoolAllocator(const PoolAllocator<Uty>&) noexcept {}
+
+	Ty* allocate(std::size_t count) { return static_cast<Ty*>(PoolState::Local().Allocate(count * sizeof(Ty))); }
+	void deallocate(Ty* pointer, std::size_t count) noexcept { PoolState::Local().Deallocate(pointer, count * sizeof(Ty)); }
+	template <typename Uty> bool operator==(const PoolAllocator<Uty>&) const noexcept { return true; }
+};
+
+template <template <typename> class Alloc> const char* AllocatorName();
+template <> const char* AllocatorName<std::allocator>() { return "std"; }
+template <> const char* AllocatorName<ArenaAllocator>() { return "arena"; }
+template <> const char* AllocatorName<PoolAllocator>() { return "pool"; }
+
+struct Result {
+	const char* scenario;
+	const char* allocator;
+	std::size_t threads;
+	std::size_t element_bytes;
+	std::uint64_t ops;
+	double seconds;
+	std::uint64_t p50_ns;
+	std::uint64_t p99_ns;
+	std::uint64_t p999_ns;
+	long rss_growth_kib;
+};
+
+/* 每个线程各自记录延迟, 结束后合并; 各线程在 latch 上同时开始 */
+template <typename Body>
+Result RunThreads(const char* scenario, const char* allocator, std::size_t threads, std::size_t element_bytes, Body body) {
+	std::vector<std::vector<std::uint32_t>> latencies(threads);
+	std::vector<double> busy(threads);
+	std::latch start(static_cast<std::ptrdiff_t>(threads) + 1);
+	std::vector<std::thread> workers;
+	const long rss_before = ResidentKiB();
+	for (std::size_t index = 0; index < threads; ++index) {
+		workers.emplace_back([&, index] {
+			start.arrive_and_wait();
+			busy[index] = body(index, latencies[index]);
+		});
+	}
+	start.arrive_and_wait();
+	for (auto& worker : workers) worker.join();
+	const long rss_after = ResidentKiB();
+
+	std::vector<std::uint32_t> merged;
+	for (auto& local : latencies) merged.insert(merged.end(), local.begin(), local.end());
+	auto percentile = [&](const double quantile) -> std::uint64_t {
+		if (merged.empty()) return 0;
+		const auto nth = merged.begin() + static_cast<std::ptrdiff_t>(quantile * static_cast<double>(merged.size() - 1));
+		std::nth_element(merged.begin(), nth, merged.end());
+		return *nth;
+	};
+	/* 吞吐量 = 总操作数 / 最慢线程的忙碌时间 (已扣除两次计时之间以外的开销) */
+	const double seconds = *std::max_element(busy.begin(), busy.end());
+	return Result{ scenario, allocator, threads, element_bytes, merged.size(), seconds,
+		percentile(0.5), percentile(0.99), percentile(0.999), rss_after - rss_before };
+}
+
+/* 记录一次操作的延迟, 返回这次操作的耗时 (秒) */
+template <typename Fn>
+inline double Timed(std::vector<std::uint32_t>& latencies, Fn fn) {
+	const auto t0 = Clock::now();
+	fn();
+	const auto t1 = Clock::now();
+	const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+	latencies.push_back(static_cast<std::uint32_t>(std::min<long long>(ns, UINT32_MAX)));
+	return static_cast<double>(ns) * 1e-9;
+}
+
+template <typename Ty, template <typename> class Alloc>
+Result ChurnCase(std::size_t threads) {
+	return RunThreads("churn", AllocatorName<Alloc>(), threads, sizeof(Ty), [](std::size_t, std::vector<std::uint32_t>& latencies) {
+		latencies.reserve(ChurnRounds * (ChurnElements + 1));
+		double busy = 0;
+		for (std::size_t round = 0; round < ChurnRounds; ++round) {
+			{
+				Potato::Array<Ty, Alloc<Ty>> arr;
+				busy += Timed(latencies, [&] { arr.Reserve(ChurnReserve); });
+				for (std::size_t i = 0; i < ChurnElements; ++i) {
+					busy += Timed(latencies, [&] { arr.Append(Ty(i)); });
+				}
+			}
+			if constexpr (std::is_same_v<Alloc<Ty>, ArenaAllocator<Ty>>) {
+				ArenaState::Local().Reset();
+			}
+		}
+		return busy;
+	});
+}
+
+template <typename Ty>
+Result SharedCase(std::size_t threads) {
+	Potato::Array<Ty> shared;
+	shared.Reserve(SharedElements);
+	for (std::size_t i = 0; i < SharedElements; ++i) shared.Append(Ty(i * 2));
+	const auto& view = shared;
+	return RunThreads("shared", "std", threads, sizeof(Ty), [&view](std::size_t index, std::vector<std::uint32_t>& latencies) {
+		latencies.reserve(SharedLookups);
+		std::mt19937_64 random(index + 1);
+		double busy = 0;
+		std::uint64_t found = 0;
+		for (std::size_t i = 0; i < SharedLookups; ++i) {
+			const Ty key(random() % (SharedElements * 2));
+			busy += Timed(latencies, [&] { found += view.LowerBound(key).HasValue(); });
+		}
+		DoNotOptimize(found);
+		return busy;
+	});
+}
+
+void Print(const Result& result, const bool json, const bool first) {
+	const double ops_per_sec = result.seconds > 0 ? static_cast<double>(result.ops) / result.seconds : 0;
+	if (json) {
+		std::printf("%s\n  {\"scenario\":\"%s\",\"allocator\":\"%s\",\"threads\":%zu,\"element_bytes\":%zu,\"ops\":%llu,"
+			"\"ops_per_sec\":%.0f,\"p50_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,\"rss_growth_kib\":%ld}",
+			first ? "" : ",", result.scenario, result.allocator, result.threads, result.element_bytes,
+			static_cast<unsigned long long>(result.ops), ops_per_sec,
+			static_cast<unsigned long long>(result.p50_ns), static_cast<unsigned long long>(result.p99_ns),
+			static_cast<unsigned long long>(result.p999_ns), result.rss_growth_kib);
+	} else {
+		std::printf("%s,%s,%zu,%zu,%llu,%.0f,%llu,%llu,%llu,%ld\n", result.scenario, result.allocator, result.threads,
+			result.element_bytes, static_cast<unsigned long long>(result.ops), ops_per_sec,
+			static_cast<unsigned long long>(result.p50_ns), static_cast<unsigned long long>(result.p99_ns),
+			static_cast<unsigned long long>(result.p999_ns), result.rss_growth_kib);
+	}
+	std::fflush(stdout);
+}
+
+template <typename Ty>
+void RunAll(std::size_t threads, const bool json, bool& first) {
+	Print(ChurnCase<Ty, std::allocator>(threads), json, first); first = false;
+	Print(ChurnCase<Ty, ArenaAllocator>(threads), json, first);
+	Print(ChurnCase<Ty, PoolAllocator>(threads), json, first);
+	Print(SharedCase<Ty>(threads), json, first);
+}
+
+}
+
+int main(int argc, char** argv) {
+	std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+	bool json = false;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--json") == 0) {
+			json = true;
+		} else {
+			max_threads = std::max<std::size_t>(1, std::strtoull(argv[i], nullptr, 10));
+		}
+	}
+	if (json) {
+		std::printf("[");
+	} else {
+		std::printf("scenario,allocator,threads,element_bytes,ops,ops_per_sec,p50_ns,p99_ns,p999_ns,rss_growth_kib\n");
+	}
+	bool first = true;
+	for (std::size_t threads = 1;; threads = std::min(threads * 2, max_threads)) {
+		Bench::RunAll<Bench::Blob<8>>(threads, json, first);
+		Bench::RunAll<Bench::Blob<64>>(threads, json, first);
+		Bench::RunAll<Bench::Blob<256>>(threads, json, first);
+		if (threads == max_threads) break;
+	}
+	if (json) std::printf("\n]\n");
+	return 0;
+}
@@ -1,9 +1,30 @@
 #include "Array.h"
+#include "CowArray.h"
+#include "PersistentArray.h"
+#include "Optional.hpp"
+#include "OptionalArray.h"
+#include "Variant.hpp"
+#include "CapacityHint.h"
+#include "FlatMap.h"
+#include "BitArray.h"
+#include "StringArray.h"
 #include <vector>
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <chrono>
 #include <string>
+#include <sstream>
+#include <string_view>
+#include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
 #include <cassert>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <stdexcept>
 
 using namespace std::chrono;
 
@@ -92,12 +113,1206 @@ void PerformanceTest(std::size_t count) {
     std::cout << "append time: " << append_ms << " ms, iterate time: " << iter_ms << " ms, checksum=" << sum << "\n";
 }
 
+// 带状态的分配器: id 不同的实例互不相等, 用于检查容器新建的缓冲区是否沿用了自己的分配器
+// UntaggedAllocations 统计默认构造 (id 为 0) 的实例发生的分配次数
+inline std::size_t UntaggedAllocations = 0;
+
+template <typename Ty>
+struct TaggedAllocator {
+    using value_type = Ty;
+    int id = 0;
+    TaggedAllocator() = default;
+    explicit TaggedAllocator(int id) noexcept : id(id) {}
+    template <typename Uty>
+    TaggedAllocator(const TaggedAllocator<Uty>& other) noexcept : id(other.id) {}
+    Ty* allocate(std::size_t count) {
+        if (id == 0) ++UntaggedAllocations;
+        return std::allocator<Ty>{}.allocate(count);
+    }
+    void deallocate(Ty* pointer, std::size_t count) noexcept { std::allocator<Ty>{}.deallocate(pointer, count); }
+    template <typename Uty>
+    bool operator==(const TaggedAllocator<Uty>& other) const noexcept { return id == other.id; }
+};
+
+void CowArrayTest() {
+    std::cout << "=== CowArray Test ===\n";
+    Potato::CowArray<int> origin{ 1, 2, 3 };
+    Potato::CowArray<int> copy = origin;
+    bool ok = copy.IsShared() && copy.Data() == origin.Data();
+    copy.Append(4);
+    ok = ok && !origin.IsShared() && origin.Size() == 3 && copy.Size() == 4;
+    Potato::CowArray<int> other = copy;
+    other.EraseIf([](int v) { return v > 100; });
+    ok = ok && other.IsShared();
+    other[0] = 10;
+    ok = ok && copy[0] == 1 && other[0] == 10 && !copy.IsShared();
+
+    // 有状态的分配器: 第一次写入与 Detach 新建的缓冲区都沿用容器的分配器
+    Potato::CowArray<int, TaggedAllocator<int>> tagged(TaggedAllocator<int>(7));
+    tagged.Append(1);
+    auto detached = tagged;
+    detached.Append(2);
+    Potato::CowArray<int, TaggedAllocator<int>> listed({ 1, 2 }, TaggedAllocator<int>(8));
+    ok = ok && tagged->GetAllocator().id == 7 && detached->GetAllocator().id == 7 && listed->GetAllocator().id == 8;
+
+    // 不传播且不相等的分配器之间赋值: 不共享对方的缓冲区, 用自己的分配器深拷贝
+    const std::size_t untagged = UntaggedAllocations;
+    Potato::CowArray<int, TaggedAllocator<int>> assigned(TaggedAllocator<int>(9));
+    assigned = listed;
+    ok = ok && !assigned.IsShared() && !listed.IsShared() && assigned.Data() != listed.Data();
+    ok = ok && assigned->GetAllocator().id == 9 && assigned.Size() == 2 && assigned[1] == 2;
+    Potato::CowArray<int, TaggedAllocator<int>> move_target(TaggedAllocator<int>(10));
+    Potato::CowArray<int, TaggedAllocator<int>> move_source({ 5, 6, 7 }, TaggedAllocator<int>(11));
+    move_target = std::move(move_source);
+    ok = ok && move_target->GetAllocator().id == 10 && move_target.Size() == 3 && move_target.Back() == 7 && move_source.IsEmpty();
+    Potato::CowArray<int, TaggedAllocator<int>> same_id(TaggedAllocator<int>(8));
+    same_id = listed;
+    ok = ok && same_id.IsShared() && same_id.Data() == listed.Data() && UntaggedAllocations == untagged;
+
+    // 交出可写引用之后的拷贝必须深拷贝, 否则通过旧引用的写入会改到新副本
+    Potato::CowArray<int> source{ 1, 2, 3 };
+    Potato::CowArray<int> sibling = source;
+    int& slot = source[0];
+    Potato::CowArray<int> later = source;
+    Potato::CowArray<int> assigned_later;
+    assigned_later = source;
+    slot = 100;
+    ok = ok && source[0] == 100 && sibling[0] == 1 && later[0] == 1 && assigned_later[0] == 1 && !later.IsShared();
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+void PersistentArrayTest() {
+    std::cout << "=== PersistentArray Test ===\n";
+    Potato::Array<int> origin;
+    for (int i = 0; i < 1000; ++i) origin.Append(i);
+    Potato::PersistentArray<int> v1(origin);
+    auto v2 = v1.Set(500, -1).Append(1000);
+    auto v3 = v2.Slice(100, 600).Concat(v1.Slice(0, 10));
+    bool ok = v1[500] == 500 && v1.Size() == 1000;
+    ok = ok && v2[500] == -1 && v2.Back() == 1000 && v2.Size() == 1001;
+    ok = ok && v3.Size() == 510 && v3[400] == -1 && v3[0] == 100 && v3.Back() == 9;
+    ok = ok && v1.ToArray() == origin;
+
+    // 有状态的分配器: 新建与复制的节点都沿用容器的分配器
+    const std::size_t untagged = UntaggedAllocations;
+    Potato::PersistentArray<int, TaggedAllocator<int>> tagged(TaggedAllocator<int>(9));
+    for (int i = 0; i < 100; ++i) tagged = tagged.Append(i);
+    const auto edited = tagged.Set(50, -1).Slice(10, 90);
+    ok = ok && edited[40] == -1 && edited.ToArray().GetAllocator().id == 9 && UntaggedAllocations == untagged;
+
+    // 根分裂: 1024 (两层) 与 32768 (三层) 之后再追加, 旧版本保持不变
+    auto iota = [](int first, int last) {
+        std::vector<int> values;
+        for (int i = first; i < last; ++i) values.push_back(i);
+        return values;
+    };
+    auto matches = [](const Potato::PersistentArray<int>& version, const std::vector<int>& model) {
+        if (version.Size() != model.size()) return false;
+        for (std::size_t i = 0; i < model.size(); ++i) {
+            if (version[i] != model[i]) return false;
+        }
+        return true;
+    };
+    std::vector<int> model = iota(0, 1024);
+    const Potato::PersistentArray<int> full2(Potato::Array<int>(model.begin(), model.end()));
+    const auto split2 = full2.Append(1024).Set(3, -3);
+    ok = ok && matches(full2, model);
+    model.push_back(1024);
+    model[3] = -3;
+    ok = ok && matches(split2, model);
+
+    model = iota(0, 32768);
+    const Potato::PersistentArray<int> full3(Potato::Array<int>(model.begin(), model.end()));
+    const auto split3 = full3.Append(32768).Append(32769).Set(20000, -1);
+    ok = ok && matches(full3, model);
+    model.push_back(32768);
+    model.push_back(32769);
+    model[20000] = -1;
+    ok = ok && matches(split3, model);
+
+    // Transient 批量追加与修改: 起点版本以及事务中途取出的版本都不受影响
+    auto transient = full2.Transient();
+    const std::vector<int> tail = iota(1024, 40000);
+    transient.Append(tail.data(), 20000);
+    for (std::size_t i = 20000; i < tail.size(); ++i) transient.Append(tail[i]);
+    transient.Set(7, -7).Set(35000, -35000);
+    const auto batched = transient.Persistent();
+    std::vector<int> batched_model = iota(0, 40000);
+    batched_model[7] = -7;
+    batched_model[35000] = -35000;
+    ok = ok && transient.IsEmpty() && matches(batched, batched_model) && matches(full2, iota(0, 1024));
+    auto again = batched.Transient();
+    again.Set(7, 70).Append(40000);
+    const auto edited_again = again.Persistent();
+    ok = ok && batched[7] == -7 && batched.Size() == 40000 && edited_again[7] == 70 && edited_again.Back() == 40000;
+
+    // 带偏移的切片: Append 与 Concat 不能改动共享的叶子
+    const auto offset_slice = batched.Slice(1037, 5000);
+    const auto slice_appended = offset_slice.Append(-1);
+    const auto narrow = batched.Slice(33001, 33010).Append(-2);
+    std::vector<int> slice_model(batched_model.begin() + 1037, batched_model.begin() + 5000);
+    ok = ok && matches(offset_slice, slice_model);
+    slice_model.push_back(-1);
+    ok = ok && matches(slice_appended, slice_model) && batched[5000] == 5000 && matches(batched, batched_model);
+    std::vector<int> narrow_model(batched_model.begin() + 33001, batched_model.begin() + 33010);
+    narrow_model.push_back(-2);
+    ok = ok && matches(narrow, narrow_model) && batched[33010] == 33010;
+    const auto joined = batched.Slice(5, 70).Concat(batched.Slice(2000, 3100));
+    const auto joined_left = offset_slice.Concat(full2);
+    std::vector<int> joined_model(batched_model.begin() + 5, batched_model.begin() + 70);
+    joined_model.insert(joined_model.end(), batched_model.begin() + 2000, batched_model.begin() + 3100);
+    std::vector<int> joined_left_model(batched_model.begin() + 1037, batched_model.begin() + 5000);
+    const std::vector<int> full2_model = iota(0, 1024);
+    joined_left_model.insert(joined_left_model.end(), full2_model.begin(), full2_model.end());
+    ok = ok && matches(joined, joined_model) && matches(joined_left, joined_left_model) && matches(batched, batched_model);
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+void OptionalNicheTest() {
+    std::cout << "=== Optional Niche Test ===\n";
+    static_assert(sizeof(Core::Optional<double>) == sizeof(double));
+    static_assert(sizeof(Core::Optional<std::unique_ptr<int>>) == sizeof(std::unique_ptr<int>));
+    static_assert(std::is_trivially_copyable_v<Core::Optional<double>>);
+    Core::Optional<double> d;
+    bool ok = !d.HasValue();
+    d = 1.5;
+    ok = ok && d.HasValue() && *d == 1.5;
+    Core::Optional<std::unique_ptr<int>> p;
+    ok = ok && !p.HasValue();
+    p.Some(std::make_unique<int>(7));
+    Core::Optional<std::unique_ptr<int>> q(std::move(p));
+    ok = ok && !p.HasValue() && q.HasValue() && **q == 7;
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+struct OptionalArrayTestTag {};
+
+void OptionalArrayTest() {
+    std::cout << "=== OptionalArray Test ===\n";
+    Potato::OptionalArray<int> column;
+    for (int i = 0; i < 100; ++i) {
+        if (i % 4 == 0) column.AppendNull(); else column.Append(i);
+    }
+    auto doubled = column.Map([](int v) { return v * 2; });
+    auto positive = column.Filter([](auto slot) { return slot && *slot > 90; });
+    column[0] = 42;
+    bool ok = column.CountPresent() == 76 && *column[0] == 42 && !column[4];
+    ok = ok && doubled.CountPresent() == 75 && !doubled[0] && *doubled[99] == 198;
+    ok = ok && positive.Size() == 7 && *positive[0] == 91;
+
+    // 代理之间赋值: 复制槽位的内容 (包括空)
+    column[2] = column[3];
+    column[5] = column[4];
+    ok = ok && *column[2] == 3 && *column[3] == 3 && !column[5] && !column[4] && column.CountPresent() == 75;
+
+    // 非 std 分配器: 结果列沿用同一分配器族
+    Potato::OptionalArray<int, Potato::Instrumentation::CountingAllocator<int, OptionalArrayTestTag>> counted{ 1, Core::nullopt, 3 };
+    auto halves = counted.Map([](int v) { return v / 2.0; });
+    auto odd = counted.AndThen([](int v) { return v > 1 ? Core::Optional<long>(v) : Core::Optional<long>(); });
+    ok = ok && halves.CountPresent() == 2 && *halves[2] == 1.5 && odd.CountPresent() == 1 && *odd[2] == 3;
+
+    // 有状态的分配器: 构造, Filter, ToRows 以及从行式数组构造的结果都沿用同一个分配器
+    const std::size_t untagged = UntaggedAllocations;
+    Potato::OptionalArray<int, TaggedAllocator<int>> tagged(TaggedAllocator<int>(11));
+    for (int i = 0; i < 200; ++i) {
+        if (i % 3 == 0) tagged.AppendNull(); else tagged.Append(i);
+    }
+    Potato::OptionalArray<int, TaggedAllocator<int>> listed({ 1, Core::nullopt }, TaggedAllocator<int>(12));
+    const auto kept = tagged.Filter([](auto slot) { return !slot || *slot % 2 == 0; });
+    const auto rows = tagged.ToRows();
+    const Potato::OptionalArray<int, TaggedAllocator<int>> rebuilt(rows);
+    const Potato::OptionalArray<int, TaggedAllocator<int>> retagged(rows, TaggedAllocator<int>(13));
+    ok = ok && tagged.GetAllocator().id == 11 && listed.GetAllocator().id == 12 && listed.CountPresent() == 1;
+    ok = ok && kept.GetAllocator().id == 11 && kept.Validity().GetAllocator().id == 11 && kept.Size() == 133;
+    ok = ok && rows.GetAllocator().id == 11 && rows.Size() == 200 && !rows[0].HasValue() && *rows[1] == 1;
+    ok = ok && rebuilt.GetAllocator().id == 11 && rebuilt.CountPresent() == tagged.CountPresent();
+    ok = ok && retagged.GetAllocator().id == 13 && retagged.Validity().GetAllocator().id == 13;
+    ok = ok && UntaggedAllocations == untagged;
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+void OptionalReferenceTest() {
+    std::cout << "=== Optional<T&> Test ===\n";
+    static_assert(sizeof(Core::Optional<int&>) == sizeof(int*));
+    Potato::Array<std::string> names{ "alice", "bob" };
+    auto found = names.TryFind("bob");
+    bool ok = found.HasValue() && found->size() == 3;
+    *found = "carol";
+    ok = ok && names[1] == "carol" && !names.TryAt(2).HasValue() && *names.TryBack() == "carol";
+    auto length = names.TryFront().Map([](const std::string& s) { return s.size(); });
+    ok = ok && *length == 5 && names.TryAt(9).ValueOr("none") == "none";
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+void OptionalChainTest() {
+    std::cout << "=== OptionalChain Test ===\n";
+    Core::Optional<int> number(21);
+    auto text = number.Lazy()
+        .Map([](int v) { return v * 2; })
+        .AndThen([](int v) { return v > 0 ? Core::Optional<std::string>(std::to_string(v)) : Core::Optional<std::string>(); })
+        .Map([](const std::string& s) { return s + "!"; })
+        .Collect();
+    auto rejected = Core::Optional<int>(-1).Lazy()
+        .AndThen([](int v) { return v > 0 ? Core::Optional<int>(v) : Core::Optional<int>(); })
+        .Map([](int v) { return v + 1; })
+        .Collect();
+    bool ok = text.HasValue() && *text == "42!" && !rejected.HasValue();
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+// 12 字节的平凡类型: 大小不是 16 的约数, 检查批量路径按元素而不是按字节处理
+struct Pod12 {
+    int a, b, c;
+    bool operator==(const Pod12&) const = default;
+};
+
+template <typename Ty, typename Alloc>
+bool SameElements(const Potato::Array<Ty, Alloc>& arr, const std::vector<Ty>& vec) {
+    return arr.Size() == vec.size() && std::equal(arr.begin(), arr.end(), vec.begin());
+}
+
+// 平凡类型的 memcpy / memmove / memset 路径与 std::vector 逐步对比
+template <typename Ty, typename Make>
+bool TrivialBulkDifferential(std::mt19937_64& random, Make make) {
+    auto index = [&](std::size_t bound) { return static_cast<std::size_t>(random() % (bound + 1)); };
+    bool ok = true;
+    Potato::Array<Ty> arr;
+    std::vector<Ty> vec;
+    for (int step = 0; step < 400 && ok; ++step) {
+        const std::size_t count = index(step % 50 == 0 ? 200 : 12);
+        std::vector<Ty> source;
+        for (std::size_t i = 0; i < count; ++i) source.push_back(make(random()));
+        switch (random() % 10) {
+        case 0: {
+            const std::size_t pos = index(vec.size());
+            arr.Insert(arr.cbegin() + pos, source.begin(), source.end());
+            vec.insert(vec.begin() + pos, source.begin(), source.end());
+            break;
+        }
+        case 1: {
+            const std::size_t pos = index(vec.size());
+            arr.Insert(arr.cbegin() + pos, count, make(step));
+            vec.insert(vec.begin() + pos, count, make(step));
+            break;
+        }
+        case 2:
+            arr.Append(std::as_const(source).data(), source.size());
+            vec.insert(vec.end(), source.begin(), source.end());
+            break;
+        case 3:
+            arr.Append(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+            vec.insert(vec.end(), source.begin(), source.end());
+            break;
+        case 4: {
+            // 自身追加: 扩容时源区间就是即将被释放的旧缓冲区
+            const std::size_t first = index(vec.size());
+            const std::size_t length = index(vec.size() - first);
+            arr.Append(std::as_const(arr).Data() + first, length);
+            vec.insert(vec.end(), vec.begin() + first, vec.begin() + first + length);
+            break;
+        }
+        case 5: {
+            const std::size_t first = index(vec.size());
+            const std::size_t length = index(vec.size() - first);
+            arr.Erase(arr.cbegin() + first, arr.cbegin() + first + length);
+            vec.erase(vec.begin() + first, vec.begin() + first + length);
+            break;
+        }
+        case 6: {
+            const std::size_t size = index(vec.size() + 20);
+            arr.Resize(size, make(step));
+            vec.resize(size, make(step));
+            break;
+        }
+        case 7: {
+            const std::size_t size = index(vec.size() + 20);
+            arr.Resize(size);
+            vec.resize(size);
+            break;
+        }
+        case 8: {
+            const std::size_t pos = index(vec.size());
+            arr.InsertZeroedItem(arr.cbegin() + pos, count);
+            vec.insert(vec.begin() + pos, count, Ty{});
+            break;
+        }
+        default:
+            arr.Reserve(arr.Capacity() + count);
+            break;
+        }
+        ok = ok && SameElements(arr, vec);
+    }
+
+    // 拷贝构造与区间构造 (指针, vector 迭代器, move_iterator, 非连续的前向迭代器)
+    const Potato::Array<Ty> copy(arr);
+    const Potato::Array<Ty> from_pointer(vec.data(), vec.data() + vec.size());
+    const Potato::Array<Ty> from_iterator(vec.begin(), vec.end());
+    std::vector<Ty> moved_from = vec;
+    const Potato::Array<Ty> from_move(std::make_move_iterator(moved_from.begin()), std::make_move_iterator(moved_from.end()));
+    const std::list<Ty> listed(vec.begin(), vec.end());
+    const Potato::Array<Ty> from_list(listed.begin(), listed.end());
+    ok = ok && SameElements(copy, vec) && SameElements(from_pointer, vec) && SameElements(from_iterator, vec);
+    ok = ok && SameElements(from_move, vec) && SameElements(from_list, vec);
+
+    // count == 0 的插入与删除不改变数组
+    const std::size_t middle = vec.size() / 2;
+    arr.Insert(arr.cbegin() + middle, std::size_t{ 0 }, make(1));
+    arr.Insert(arr.cbegin() + middle, vec.end(), vec.end());
+    arr.InsertZeroedItem(arr.cbegin() + middle, 0);
+    arr.Erase(arr.cbegin() + middle, std::size_t{ 0 });
+    arr.Append(std::as_const(arr).Data(), arr.Size());
+    vec.insert(vec.end(), vec.begin(), vec.end());
+    ok = ok && SameElements(arr, vec);
+    return ok;
+}
+
+void TrivialBulkPathTest() {
+    std::cout << "=== Trivial Bulk Path Test ===\n";
+    std::mt19937_64 random(2801);
+    bool ok = TrivialBulkDifferential<int>(random, [](std::uint64_t v) { return static_cast<int>(v); });
+    ok = ok && TrivialBulkDifferential<Pod12>(random, [](std::uint64_t v) {
+        return Pod12{ static_cast<int>(v), static_cast<int>(v >> 21), static_cast<int>(v >> 42) };
+    });
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+// 24 字节的平凡类型, 走 memcpy 倍增分支
+struct Pod24 {
+    std::int64_t a, b, c;
+    bool operator==(const Pod24&) const = default;
+};
+
+// 在 16 字节对齐的缓冲区中偏移 offset 字节处填充 count 个 value, 检查内容与前后的哨兵字节
+template <typename Ty>
+bool CheckTrivialFill(const std::size_t count, const std::size_t offset, const Ty& value) {
+    constexpr unsigned char guard = 0xCD;
+    std::vector<unsigned char> buffer(count * sizeof(Ty) + offset + 64 + 16, guard);
+    unsigned char* base = buffer.data() + ((16 - reinterpret_cast<std::uintptr_t>(buffer.data()) % 16) % 16);
+    Ty* dest = reinterpret_cast<Ty*>(base + offset);
+    Ty* last = Potato::MemoryTools::TrivialFill(dest, count, value);
+    bool ok = last == dest + count;
+    for (std::size_t i = 0; i < count && ok; ++i) {
+        ok = std::memcmp(base + offset + i * sizeof(Ty), &value, sizeof(Ty)) == 0;
+    }
+    ok = ok && std::all_of(buffer.data(), base + offset, [](unsigned char c) { return c == guard; });
+    ok = ok && std::all_of(base + offset + count * sizeof(Ty), buffer.data() + buffer.size(), [](unsigned char c) { return c == guard; });
+    return ok;
+}
+
+void TrivialFillTest() {
+    std::cout << "=== Trivial Fill Test ===\n";
+    bool ok = true;
+    const Pod12 pod12{ 1, -2, 0x01020304 };
+    const Pod24 pod24{ 5, 0, -7 };
+    // 元素大小不整除 16 的倍增分支, 以及整除 16 的广播分支, 覆盖 0, 1, 2 的幂附近的个数
+    for (const std::size_t count : { 0u, 1u, 2u, 3u, 7u, 8u, 9u, 63u, 64u, 65u, 1000u }) {
+        const Potato::Array<Pod12> filled12(count, pod12);
+        const Potato::Array<Pod24> filled24(count, pod24);
+        const Potato::Array<int> filled_int(count, 0x5A5A0001);
+        ok = ok && SameElements(filled12, std::vector<Pod12>(count, pod12));
+        ok = ok && SameElements(filled24, std::vector<Pod24>(count, pod24));
+        ok = ok && SameElements(filled_int, std::vector<int>(count, 0x5A5A0001));
+    }
+    // 全零的值走 memset: 先写入非零内容, 缩小后在原来的内存上重新填充
+    Potato::Array<Pod12> reused(100, pod12);
+    reused.Resize(10);
+    reused.Resize(100, Pod12{});
+    Potato::Array<int> reused_int(100, -1);
+    reused_int.Resize(3);
+    reused_int.Resize(100, 0);
+    std::vector<Pod12> expected12(100, Pod12{});
+    std::fill_n(expected12.begin(), 10, pod12);
+    std::vector<int> expected_int(100, 0);
+    std::fill_n(expected_int.begin(), 3, -1);
+    ok = ok && SameElements(reused, expected12) && SameElements(reused_int, expected_int);
+
+    // 小于和超过 NonTemporalThreshold 的填充, 目标不对齐 16 字节时流式写入的头尾都不能越界
+    const std::size_t streaming = Potato::MemoryTools::NonTemporalThreshold;
+    for (const std::size_t offset : { 0u, 4u, 8u, 12u }) {
+        ok = ok && CheckTrivialFill<int>(100, offset, 0x11223344);
+        ok = ok && CheckTrivialFill<int>(streaming / sizeof(int) + 37, offset, 0x11223344);
+        ok = ok && CheckTrivialFill<int>(streaming / sizeof(int) + 37, offset, 0);
+        ok = ok && CheckTrivialFill<Pod12>(streaming / sizeof(Pod12) + 5, offset, pod12);
+    }
+    for (const std::size_t offset : { 1u, 7u, 15u }) {
+        ok = ok && CheckTrivialFill<unsigned char>(streaming + 3, offset, static_cast<unsigned char>(0x7E));
+        ok = ok && CheckTrivialFill<std::uint16_t>(streaming / 2 + 9, offset & ~std::size_t{ 1 }, std::uint16_t{ 0xBEEF });
+    }
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+// 剩余次数用完后拷贝与移动都会抛出异常 (budget < 0 时不限), 移动会清空源对象; 用于检查异常安全
+// live 统计存活对象数, 用于检查回滚时已构造的元素被正确销毁
+struct ThrowingCopy {
+    static inline int budget = -1;
+    static inline int live = 0;
+    int value;
+    ThrowingCopy() : value(0) { ++live; } // Array::EmplaceAt 需要默认构造
+    explicit ThrowingCopy(int v) : value(v) { ++live; }
+    ThrowingCopy(const ThrowingCopy& other) : value(other.value) { Tick(); ++live; }
+    ThrowingCopy(ThrowingCopy&& other) noexcept(false) : value(other.value) { Tick(); ++live; other.value = -1; }
+    ThrowingCopy& operator=(const ThrowingCopy&) = default;
+    ~ThrowingCopy() { --live; }
+    static void Tick() {
+        if (budget == 0) throw std::runtime_error("copy");
+        if (budget > 0) --budget;
+    }
+};
+
+void FillBackoutTest() {
+    std::cout << "=== Fill Backout Test ===\n";
+    bool ok = true;
+    const int live_before = ThrowingCopy::live;
+    {
+        const ThrowingCopy seed(7);
+        Potato::Array<ThrowingCopy> arr;
+        arr.Reserve(8);
+        arr.Append(seed);
+        arr.Append(seed);
+        // 容量足够的 Resize: 第 3 次拷贝抛出
+        ThrowingCopy::budget = 2;
+        try {
+            arr.Resize(6, seed);
+            ok = false;
+        } catch (const std::runtime_error&) {}
+        ThrowingCopy::budget = -1;
+        ok = ok && arr.Size() == 2 && ThrowingCopy::live == live_before + 3;
+        // 需要重新分配的 Resize
+        ThrowingCopy::budget = 2;
+        try {
+            arr.Resize(20, seed);
+            ok = false;
+        } catch (const std::runtime_error&) {}
+        ThrowingCopy::budget = -1;
+        ok = ok && arr.Size() == 2 && arr.Capacity() == 8 && arr[1].value == 7 && ThrowingCopy::live == live_before + 3;
+        // 填充构造
+        ThrowingCopy::budget = 2;
+        try {
+            Potato::Array<ThrowingCopy> filled(5, seed);
+            ok = false;
+        } catch (const std::runtime_error&) {}
+        ThrowingCopy::budget = -1;
+        ok = ok && ThrowingCopy::live == live_before + 3;
+    }
+    ok = ok && ThrowingCopy::live == live_before;
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+// Invalid 永远不会作为值出现, 所以 Expected / Variant 也可以借用这个 niche
+enum class SlotState : std::uint8_t { Free, Used, Invalid = 0xFF };
+template <>
+struct Core::OptionalTraits<SlotState> : Core::OptionalSentinelTraits<SlotState, SlotState::Invalid, true> {};
+
+struct NoError {
+    bool operator==(const NoError&) const = default;
+};
+
+void ExpectedTest() {
+    std::cout << "=== Expected Test ===\n";
+    static_assert(std::is_trivially_copyable_v<Core::Expected<int, Potato::ArrayErrc>>);
+    static_assert(sizeof(Core::Expected<SlotState, NoError>) == sizeof(SlotState));
+    static_assert(sizeof(Core::Expected<std::unique_ptr<int>, NoError>) > sizeof(std::unique_ptr<int>));
+    Potato::Array<int> arr{ 1, 2, 3 };
+    auto hit = arr.TryAt(2).Map([](int v) { return v * 10; });
+    auto miss = arr.TryAt(3);
+    auto reserved = arr.TryReserve(64);
+    auto too_large = arr.TryReserve(std::numeric_limits<std::size_t>::max());
+    bool ok = hit.HasValue() && *hit == 30;
+    ok = ok && !miss.HasValue() && miss.Error() == Potato::ArrayErrc::OutOfRange && miss.ValueOr(-1) == -1;
+    ok = ok && reserved.HasValue() && *reserved == 64 && arr.Capacity() == 64;
+    ok = ok && !too_large.HasValue() && too_large.Error() == Potato::ArrayErrc::LengthError;
+
+    // 切换状态时新成员的构造抛出异常: 原来的错误保持不变
+    using Result = Core::Expected<ThrowingCopy, std::string>;
+    Result failed(Core::unexpect, std::string("error that does not fit into SSO"));
+    const Result succeeded(std::in_place, 42);
+    ThrowingCopy::budget = 0;
+    try {
+        failed = succeeded;
+        ok = false;
+    } catch (const std::runtime_error&) {}
+    ThrowingCopy::budget = -1;
+    ok = ok && !failed.HasValue() && failed.Error() == "error that does not fit into SSO";
+    failed = succeeded;
+    ok = ok && failed.HasValue() && failed->value == 42;
+
+    // Optional 的哨兵 (空指针, 特定 payload 的 NaN) 对 Expected 来说是普通的值
+    const Core::Expected<std::unique_ptr<int>, NoError> null_pointer(std::unique_ptr<int>{});
+    const Core::Expected<float, NoError> nan_payload(std::bit_cast<float>(0x7FC0'DEADu));
+    const Core::Expected<std::shared_ptr<int>, NoError> null_shared(std::shared_ptr<int>{});
+    const Core::Expected<SlotState, NoError> invalid_slot(Core::unexpect);
+    ok = ok && null_pointer.HasValue() && *null_pointer == nullptr && nan_payload.HasValue() && null_shared.HasValue();
+    ok = ok && !invalid_slot.HasValue() && Core::Expected<SlotState, NoError>(SlotState::Free).HasValue();
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+void VariantTest() {
+    std::cout << "=== Variant Test ===\n";
+    struct Empty {};
+    static_assert(sizeof(Core::Variant<int, float>) == 8);
+    static_assert(std::is_trivially_copyable_v<Core::Variant<int, float>>);
+    static_assert(sizeof(Core::Variant<Empty, SlotState>) == sizeof(SlotState));
+    static_assert(sizeof(Core::Variant<Empty, double>) > sizeof(double));
+    using Message = Core::Variant<int, double, std::string>;
+    Message msg = std::string("payload that does not fit into SSO");
+    Message copy = msg;
+    Message number = 2.5;
+    auto size_of = Core::Overloaded{
+        [](int) { return std::size_t{ 1 }; },
+        [](double) { return std::size_t{ 2 }; },
+        [](const std::string& s) { return s.size(); }
+    };
+    bool ok = copy == msg && copy.Is<std::string>() && number.Index() == 1;
+    ok = ok && Core::Visit(size_of, copy) == std::strlen("payload that does not fit into SSO");
+    ok = ok && number.Visit(size_of) == 2 && !number.GetIf<int>().HasValue();
+    number = 7;
+    ok = ok && number.Get<int>() == 7 && *number.GetIf<int>() == 7;
+
+    // 空指针是第二个候选的值, 不是 Empty
+    const Core::Variant<Empty, std::unique_ptr<int>> null_pointer(std::unique_ptr<int>{});
+    const Core::Variant<Empty, double> nan_payload(std::bit_cast<double>(0x7FF8'0000'0000'DEADull));
+    Core::Variant<Empty, SlotState> slot;
+    const bool visited_pointer = null_pointer.Visit(Core::Overloaded{
+        [](const Empty&) { return false; },
+        [](const std::unique_ptr<int>& p) { return p == nullptr; }
+    });
+    ok = ok && null_pointer.Index() == 1 && visited_pointer && nan_payload.Index() == 1;
+    ok = ok && slot.Index() == 0;
+    slot = SlotState::Used;
+    ok = ok && slot.Index() == 1 && slot.Get<SlotState>() == SlotState::Used;
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+void OptionalBatchTest() {
+    std::cout << "=== Optional Batch Test ===\n";
+    Potato::Array<Core::Optional<int>> arr;
+    for (int i = 0; i < 37; ++i) {
+        arr.Append(i % 3 ? Core::Optional<int>(i) : Core::Optional<int>());
+    }
+    auto compacted = arr.Compact();
+    auto unwrapped = arr.Unwrap(-1);
+    std::vector<int> doubled(arr.Size(), 0);
+    const auto transformed = arr.TransformPresent([](int v) { return v * 2; }, doubled.begin());
+    bool ok = arr.CountPresent() == 24 && compacted.Size() == 24 && transformed == 24;
+    ok = ok && compacted[0] == 1 && compacted[1] == 2 && compacted[2] == 4 && compacted[23] == 35;
+    ok = ok && unwrapped.Size() == 37 && unwrapped[0] == -1 && unwrapped[1] == 1 && unwrapped[36] == -1;
+    ok = ok && doubled[0] == 0 && doubled[1] == 2 && doubled[35] == 70;
+
+    // 没有默认构造函数的 T 也走标志字节路径: 空位置直接写入 fallback
+    struct Meters {
+        explicit constexpr Meters(int value) noexcept : value(value) {}
+        int value;
+    };
+    static_assert(!std::is_default_constructible_v<Meters> && Core::OptionalLayout<Meters>::HasFlagByte);
+    Potato::Array<Core::Optional<Meters>> distances;
+    for (int i = 0; i < 19; ++i) {
+        distances.Append(i % 4 ? Core::Optional<Meters>(Meters(i)) : Core::Optional<Meters>());
+    }
+    const auto filled = distances.Unwrap(Meters(-7));
+    ok = ok && filled.Size() == 19 && filled[0].value == -7 && filled[1].value == 1 && filled[16].value == -7 && filled[18].value == 18;
+
+    // fn 对 T{} 没有定义: 空位置上既不调用 fn 也不读写 out
+    const Potato::Array<Core::Optional<int>> divisors{ Core::Optional<int>(5), Core::Optional<int>(), Core::Optional<int>(-4) };
+    std::array<int, 3> quotients{ -1, -1, -1 };
+    const auto divided = divisors.TransformPresent([](int x) { return 100 / x; }, quotients.begin());
+    ok = ok && divided == 2 && quotients[0] == 20 && quotients[1] == -1 && quotients[2] == -25;
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+struct RelocationProbe {
+    static inline int moves = 0;
+    int value = 0;
+    RelocationProbe() = default;
+    RelocationProbe(int v) : value(v) {}
+    RelocationProbe(const RelocationProbe&) = default;
+    RelocationProbe(RelocationProbe&& other) noexcept : value(other.value) { ++moves; }
+    RelocationProbe& operator=(const RelocationProbe&) = default;
+    ~RelocationProbe() {}
+    using TriviallyRelocatableTp = std::true_type;
+};
+
+void TriviallyRelocatableTest() {
+    std::cout << "=== Trivially Relocatable Test ===\n";
+    using Core::Traits::IsTriviallyRelocatableVal;
+    static_assert(IsTriviallyRelocatableVal<Core::Optional<std::shared_ptr<int>>>);
+    static_assert(IsTriviallyRelocatableVal<Core::Optional<std::unique_ptr<int>>>);
+    static_assert(IsTriviallyRelocatableVal<Potato::Array<std::string>>);
+    static_assert(!IsTriviallyRelocatableVal<Core::Optional<std::string>>);
+    Potato::Array<RelocationProbe> probes;
+    for (int i = 0; i < 100; ++i) probes.Append(RelocationProbe(i));
+    const int moves_before = RelocationProbe::moves;
+    probes.Reserve(1000);
+    auto shared = std::make_shared<int>(7);
+    Potato::Array<Core::Optional<std::shared_ptr<int>>> optionals;
+    for (int i = 0; i < 100; ++i) optionals.Append(Core::Optional<std::shared_ptr<int>>(shared));
+    bool ok = RelocationProbe::moves == moves_before && probes[99].value == 99;
+    ok = ok && shared.use_count() == 101 && **optionals[99] == 7;
+    optionals.Clear();
+    ok = ok && shared.use_count() == 1;
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+// 编译期查找表: 整个表在编译期求值, constinit 保证没有运行期初始化
+constexpr Core::Optional<int> HalfIfEven(int x) {
+    return x % 2 ? Core::Optional<int>() : Core::Optional<int>(x / 2);
+}
+constexpr auto SquareTable = [] {
+    std::array<Core::Optional<int>, 16> table{};
+    for (int i = 0; i < 16; ++i) {
+        if (i % 3) table[i] = i * i;
+    }
+    return table;
+}();
+constinit Core::Optional<int> ConstinitOptional = Core::Optional<int>(42);
+
+void OptionalConstexprTest() {
+    std::cout << "=== Optional Constexpr Test ===\n";
+    static_assert(!SquareTable[0].HasValue() && *SquareTable[4] == 16 && SquareTable[3] == Core::nullopt);
+    static_assert(SquareTable[5].ValueOr(0) == 25 && SquareTable[6].ValueOr(-1) == -1);
+    static_assert(HalfIfEven(8).AndThen(HalfIfEven).Map([](int v) { return v + 1; }) == 3);
+    static_assert(HalfIfEven(3).OrElse([] { return Core::Optional<int>(9); }) == 9);
+    static_assert(Core::Optional<int>() < Core::Optional<int>(0) && Core::Optional<int>(1) != Core::nullopt);
+    static_assert([] {
+        Core::Optional<int> a(1), b;
+        a.Swap(b);
+        b.Some(b.Value() + 1);
+        a.Reset();
+        return !a.HasValue() && *b == 2;
+    }());
+    static_assert([] {
+        Core::Optional<std::string> s(std::string("abc"));
+        auto n = s.Map([](const std::string& x) { return x.size(); });
+        s.Reset();
+        return *n == 3 && !s.HasValue();
+    }());
+    static_assert(Core::MakeOptional(4).Lazy().Map([](int v) { return v * 2; }).Collect() == 8);
+    static_assert(Core::nullopt == std::nullopt && std::nullopt == Core::nullopt && !(Core::nullopt != std::nullopt));
+    bool ok = *ConstinitOptional == 42 && SquareTable[15].ValueOr(0) == 0 && *SquareTable[14] == 196;
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+void SearchTest() {
+    std::cout << "=== Search Test ===\n";
+    Potato::Array<std::uint64_t> routes;
+    for (std::uint64_t i = 0; i < 1000; ++i) routes.Append(i * 10);
+    routes.Append(9990);
+    auto index = routes.BuildSearchIndex();
+    bool ok = *routes.LowerBound(15) == 2 && *routes.UpperBound(20) == 3 && !routes.LowerBound(10000).HasValue();
+    ok = ok && *routes.BinarySearch(9990) == 999 && !routes.BinarySearch(11).HasValue();
+    ok = ok && *routes.FindLast(9990) == 1000 && *routes.FindFirst(9990) == 999 && !routes.FindLastIf([](std::uint64_t v) { return v % 10 != 0; }).HasValue();
+    ok = ok && *index.LowerBound(15) == 2 && *index.BinarySearch(9990) == 999 && !index.BinarySearch(11).HasValue() && !index.LowerBound(10000).HasValue();
+
+    // 不可默认构造的元素与空数组
+    struct Fare {
+        int cents;
+        explicit Fare(int c) : cents(c) {}
+        auto operator<=>(const Fare&) const = default;
+    };
+    /* Array 的插入路径会默认构造空洞, 这里直接从 vector 建索引 */
+    std::vector<Fare> fares;
+    for (int i = 0; i < 37; ++i) fares.emplace_back(i * 5);
+    const Potato::SearchIndex<Fare> fare_index(fares.data(), fares.size());
+    ok = ok && fare_index.Size() == 37 && *fare_index.LowerBound(Fare(26)) == 6 && *fare_index.BinarySearch(Fare(180)) == 36;
+    const Potato::SearchIndex<Fare> empty_fares(nullptr, 0);
+    ok = ok && empty_fares.Size() == 0 && !empty_fares.LowerBound(Fare(1)).HasValue();
+
+    // 索引的键与秩数组都沿用源数组的分配器
+    const std::size_t untagged = UntaggedAllocations;
+    Potato::Array<int, TaggedAllocator<int>> tagged(TaggedAllocator<int>(21));
+    for (int i = 0; i < 50; ++i) tagged.Append(i * 2);
+    const auto tagged_index = tagged.BuildSearchIndex();
+    ok = ok && tagged_index.GetAllocator().id == 21 && *tagged_index.LowerBound(31) == 16 && UntaggedAllocations == untagged;
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+struct InstrumentationTestTag {};
+
+void InstrumentationTest() {
+    std::cout << "=== Instrumentation Test ===\n";
+    using Alloc = Potato::Instrumentation::CountingAllocator<int, InstrumentationTestTag>;
+    auto& record = Potato::Instrumentation::RecordOf<InstrumentationTestTag>();
+    record.Reset();
+    {
+        Potato::Array<int, Alloc> arr;
+        for (int i = 0; i < 1000; ++i) arr.Append(i);
+        arr.Reserve(4096);
+    }
+    const auto snapshots = Potato::Instrumentation::TakeSnapshot();
+    const auto found = std::find_if(snapshots.begin(), snapshots.end(),
+        [&](const Potato::Instrumentation::Snapshot& snap) { return snap.name == record.name; });
+    bool ok = found != snapshots.end() && found->allocations > 1 && found->allocations == found->deallocations;
+    ok = ok && found->live_bytes == 0 && found->peak_live_bytes >= 4096 * sizeof(int);
+
+    // Reset 时仍有存活的内存: 之后的释放不能让 live_bytes / peak_live_bytes 回绕
+    {
+        auto held = std::make_unique<Potato::Array<int, Alloc>>();
+        for (int i = 0; i < 1000; ++i) held->Append(i);
+        const std::size_t held_bytes = held->Capacity() * sizeof(int);
+        Potato::Instrumentation::ResetAll();
+        held.reset();
+        Potato::Array<int, Alloc> fresh;
+        fresh.Append(1);
+        const auto after = record.Load();
+        ok = ok && after.live_bytes == fresh.Capacity() * sizeof(int) && after.peak_live_bytes == held_bytes;
+    }
+
+#if defined(POTATO_ENABLE_INSTRUMENTATION)
+    // 扩容钩子: M_Relocate / M_InsertHoles / M_AppendRange / Reserve 各记录一次
+    record.Reset();
+    {
+        Potato::Array<int, Alloc> grown;
+        grown.Resize(10);
+        grown.Insert(grown.begin(), std::size_t{ 100 }, 7);
+        const std::vector<int> tail(500, 1);
+        grown.Append(tail.begin(), tail.end());
+        grown.Reserve(4096);
+        const auto growth = record.Load();
+        ok = ok && growth.growth_events == 4 && growth.moved_elements == 10 + 110 + 610 && growth.peak_capacity == 4096;
+        ok = ok && growth.growth_slack == (110 - 110) + (610 - 610) + (4096 - 610);
+    }
+#endif
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+void TraceTest() {
+    std::cout << "=== Trace Test ===\n";
+    namespace Trace = Potato::Trace;
+    Trace::Clear();
+    {
+        Trace::Scope outer(Trace::EventKind::BulkInsert, "int", 8, 32);
+        Trace::Scope inner(Trace::EventKind::Reallocate, "int", 4, 16);
+    }
+    Trace::ThreadBuffer* buffer = Trace::LocalBuffer();
+    for (std::size_t i = 0; i < Trace::ThreadBuffer::Capacity + 10; ++i) {
+        buffer->Push(Trace::EventKind::BulkErase, "int", i, i + 1, i, i * 4);
+    }
+    const auto events = Trace::Collect();
+    bool ok = events.size() == Trace::ThreadBuffer::Capacity;
+    ok = ok && events.front().kind == Trace::EventKind::BulkErase && events.front().count == 10;
+    ok = ok && events.back().count == Trace::ThreadBuffer::Capacity + 9;
+    Trace::Clear();
+    {
+        Trace::Scope scope(Trace::EventKind::Reallocate, "int", 1, 4);
+    }
+    std::ostringstream json;
+    Trace::WriteChromeTrace(json);
+    ok = ok && json.str().find("\"name\":\"Reallocate\"") != std::string::npos && json.str().find("\"ph\":\"X\"") != std::string::npos;
+    Trace::Clear();
+
+#if defined(POTATO_ENABLE_TRACE)
+    // Array 自身的钩子: 扩容, 批量插入与删除各自留下对应的事件
+    {
+        const int values[6] = { 1, 2, 3, 4, 5, 6 };
+        Potato::Array<int> arr;
+        arr.Reserve(4);
+        arr.Append(values, std::size_t{ 6 });
+        arr.Insert(arr.cbegin() + 1, std::size_t{ 3 }, 0);
+        arr.Erase(arr.cbegin(), arr.cbegin() + 2);
+        arr.Resize(100);
+    }
+    const auto array_events = Trace::Collect();
+    auto count_of = [&](Trace::EventKind kind, std::uint64_t count) {
+        return std::count_if(array_events.begin(), array_events.end(), [&](const Trace::Event& event) {
+            return event.kind == kind && event.count == count && std::string_view(event.type) == typeid(int).name();
+        });
+    };
+    // Reserve(4) 与 Resize(100) 各一次 Reallocate; 超过容量的 Append 与 Insert 在 BulkInsert 内部嵌套一次 Reallocate
+    ok = ok && array_events.size() == 7;
+    ok = ok && count_of(Trace::EventKind::Reallocate, 0) == 2 && count_of(Trace::EventKind::Reallocate, 6) == 1;
+    ok = ok && count_of(Trace::EventKind::Reallocate, 7) == 1;
+    ok = ok && count_of(Trace::EventKind::BulkInsert, 6) == 1 && count_of(Trace::EventKind::BulkInsert, 3) == 1;
+    ok = ok && count_of(Trace::EventKind::BulkErase, 2) == 1;
+    Trace::Clear();
+#endif
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+void CapacityHintTest() {
+    std::cout << "=== CapacityHint Test ===\n";
+    bool ok = true;
+    for (std::uint64_t size : { 0ull, 7ull, 8ull, 100ull, 1000ull, 123456789ull }) {
+        const std::size_t bucket = Potato::CapacityHint::BucketOf(size);
+        ok = ok && Potato::CapacityHint::BucketUpperBound(bucket) >= size;
+        ok = ok && (bucket == 0 || Potato::CapacityHint::BucketUpperBound(bucket - 1) < size);
+    }
+    auto& hint = POTATO_CAPACITY_HINT("CapacityHintTestSite");
+    ok = ok && hint.Suggest() == 0;
+    for (int round = 0; round < 32; ++round) {
+        Potato::Array<int> arr;
+        Potato::ScopedCapacityHint guard(arr, hint);
+        const int count = round % 10 == 0 ? 5000 : 100;
+        for (int i = 0; i < count; ++i) arr.Append(i);
+    }
+    Potato::Array<int> learned;
+    {
+        Potato::ScopedCapacityHint guard(learned, hint);
+        ok = ok && learned.Capacity() >= 100 && learned.Capacity() < 5000;
+    }
+    auto& baked = POTATO_CAPACITY_HINT("CapacityHintBakedSite", 64);
+    ok = ok && baked.Suggest() == 64;
+    std::ostringstream dump;
+    Potato::WriteCapacityHints(dump);
+    ok = ok && dump.str().find("CapacityHintTestSite = ") != std::string::npos;
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+void EraseEmptyRangeTest() {
+    std::cout << "=== Erase Empty Range Test ===\n";
+    Potato::Array<std::string> arr;
+    for (int i = 0; i < 4; ++i) arr.Append("potato-erase-empty-range-" + std::to_string(i));
+    const auto it = arr.Erase(arr.cbegin() + 1, arr.cbegin() + 1);
+    arr.Erase(arr.cbegin() + 2, std::size_t{ 0 });
+    bool ok = arr.Size() == 4 && it == arr.begin() + 1;
+    for (int i = 0; i < 4; ++i) ok = ok && arr[i] == "potato-erase-empty-range-" + std::to_string(i);
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+// 剩余次数用完后抛出异常的哈希函数, 用于检查扩容时的异常安全
+struct ThrowingHash {
+    static inline int budget = -1;
+    std::size_t operator()(const int key) const {
+        if (budget == 0) throw std::runtime_error("hash");
+        if (budget > 0) --budget;
+        return std::hash<int>{}(key);
+    }
+};
+
+struct ThrowingLess {
+    static inline int budget = -1;
+    bool operator()(const int lhs, const int rhs) const {
+        if (budget == 0) throw std::runtime_error("less");
+        if (budget > 0) --budget;
+        return lhs < rhs;
+    }
+};
+
+// 与标准库容器对照的随机 插入/删除/查找 序列, HashMap 与 FlatMap 共用
+template <typename Map, typename Reference>
+bool MapDifferentialCheck(Map& map, Reference& reference, std::mt19937_64& random, const int operations, const int key_range) {
+    bool ok = true;
+    for (int i = 0; i < operations; ++i) {
+        const int key = static_cast<int>(random() % key_range);
+        switch (random() % 3) {
+        case 0: map[key] = i; reference[key] = i; break;
+        case 1: ok = ok && map.Erase(key) == reference.erase(key); break;
+        default: {
+            const auto found = map.Find(key);
+            const auto it = reference.find(key);
+            ok = ok && found.HasValue() == (it != reference.end()) && (!found.HasValue() || *found == it->second);
+        }
+        }
+    }
+    return ok && map.Size() == reference.size();
+}
+
+void HashMapTest() {
+    std::cout << "=== HashMap Test ===\n";
+    Potato::HashMap<int, int> map;
+    std::unordered_map<int, int> reference;
+    std::mt19937_64 random(12345);
+    bool ok = MapDifferentialCheck(map, reference, random, 20000, 1000);
+    std::size_t visited = 0;
+    for (const auto& [key, value] : map) {
+        ok = ok && reference.at(key) == value;
+        ++visited;
+    }
+    ok = ok && visited == reference.size();
+
+    Potato::HashMap<std::string, int> names{ { "potato", 1 }, { "tomato", 2 } };
+    ok = ok && names.Find(std::string_view("potato")).HasValue() && *names.Find("tomato") == 2 && !names.Contains("carrot");
+    names.Reserve(512);
+    const std::size_t capacity = names.Capacity();
+    for (int i = 0; i < 510; ++i) names.InsertOrAssign(std::to_string(i), i);
+    ok = ok && names.Capacity() == capacity && names.Size() == 512;
+
+    const Potato::Array<int> lhs{ 1, 2, 2, 3, 4, 5 };
+    const Potato::Array<int> rhs{ 4, 5, 5, 6, 2 };
+    ok = ok && lhs.Intersection(rhs) == Potato::Array<int>{ 2, 4, 5 };
+    ok = ok && lhs.Union(rhs) == Potato::Array<int>{ 1, 2, 3, 4, 5, 6 };
+    ok = ok && lhs.Difference(rhs) == Potato::Array<int>{ 1, 3 };
+
+    // 扩容时哈希函数抛出异常: 原表保持不变, 元素仍然有效
+    Potato::HashMap<int, std::shared_ptr<int>, ThrowingHash> shared;
+    for (int i = 0; i < 14; ++i) shared[i] = std::make_shared<int>(i);
+    ThrowingHash::budget = 3;
+    try {
+        for (int i = 14; i < 100; ++i) shared[i] = std::make_shared<int>(i);
+        ok = false;
+    } catch (const std::runtime_error&) {}
+    ThrowingHash::budget = -1;
+    int total = 0;
+    for (const auto& [key, value] : shared) total += (value && *value == key) ? 1 : 0;
+    ok = ok && total == static_cast<int>(shared.Size()) && shared.Size() >= 14;
+
+    // 不传播且不相等的分配器之间赋值: 目标保留自己的分配器, 元素在自己的存储中逐个重建
+    using TaggedMap = Potato::HashMap<int, std::string, Potato::DefaultHash<int>, std::equal_to<>,
+        TaggedAllocator<std::pair<const int, std::string>>>;
+    const std::size_t untagged = UntaggedAllocations;
+    TaggedMap tagged_source({}, {}, TaggedAllocator<std::pair<const int, std::string>>(3));
+    for (int i = 0; i < 40; ++i) tagged_source.InsertOrAssign(i, std::to_string(i));
+    TaggedMap copy_target({}, {}, TaggedAllocator<std::pair<const int, std::string>>(4));
+    copy_target.InsertOrAssign(-1, "stale");
+    copy_target = tagged_source;
+    ok = ok && copy_target.GetAllocator().id == 4 && copy_target.Size() == 40 && !copy_target.Contains(-1);
+    ok = ok && *copy_target.Find(17) == "17" && tagged_source.Size() == 40;
+    TaggedMap move_target({}, {}, TaggedAllocator<std::pair<const int, std::string>>(5));
+    move_target = std::move(tagged_source);
+    ok = ok && move_target.GetAllocator().id == 5 && move_target.Size() == 40 && *move_target.Find(39) == "39";
+    ok = ok && tagged_source.IsEmpty() && UntaggedAllocations == untagged;
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+void FlatMapTest() {
+    std::cout << "=== FlatMap Test ===\n";
+    Potato::FlatMap<int, int> map;
+    std::map<int, int> reference;
+    std::mt19937_64 random(2024);
+    bool ok = MapDifferentialCheck(map, reference, random, 5000, 500);
+    // 批量插入: 已存在的键保留原值, 批内重复的键保留第一次出现的
+    std::vector<std::pair<int, int>> batch;
+    for (int i = 0; i < 2000; ++i) batch.emplace_back(static_cast<int>(random() % 1000), -i);
+    const std::size_t before = reference.size();
+    for (const auto& item : batch) reference.insert(item);
+    ok = ok && map.InsertRange(batch.begin(), batch.end()) == reference.size() - before;
+    ok = ok && map.Size() == reference.size();
+    auto it = reference.begin();
+    for (const auto& [key, value] : map) {
+        ok = ok && it != reference.end() && it->first == key && it->second == value;
+        ++it;
+    }
+
+    // 归并中途抛出异常: 原有元素不能被移走, map 保持不变
+    Potato::FlatMap<int, ThrowingCopy> guarded;
+    for (int i = 0; i < 100; ++i) guarded.TryEmplace(i * 2, i);
+    std::vector<std::pair<int, ThrowingCopy>> odd;
+    for (int i = 0; i < 50; ++i) odd.emplace_back(i * 4 + 1, ThrowingCopy(-i));
+    ThrowingCopy::budget = 80;
+    try {
+        guarded.InsertRange(odd.begin(), odd.end());
+        ok = false;
+    } catch (const std::runtime_error&) {}
+    ThrowingCopy::budget = -1;
+    ok = ok && guarded.Size() == 100;
+    for (int i = 0; i < 100; ++i) ok = ok && guarded.Keys()[i] == i * 2 && guarded.Values()[i].value == i;
+
+    Potato::FlatMap<std::string, int> names{ { "tomato", 2 }, { "potato", 1 }, { "tomato", 3 } };
+    ok = ok && names.Size() == 2 && names.At(std::string_view("tomato")) == 2 && *names.Find("potato") == 1;
+    ok = ok && names.Keys() == Potato::Array<std::string>{ "potato", "tomato" };
+
+    Potato::FlatSet<int> set{ 5, 1, 3 };
+    std::set<int> reference_set{ 5, 1, 3 };
+    const std::vector<int> values{ 4, 3, 9, 4, 0, 1 };
+    reference_set.insert(values.begin(), values.end());
+    ok = ok && set.InsertRange(values.begin(), values.end()) == 3 && set.Insert(7) && !set.Insert(7);
+    reference_set.insert(7);
+    ok = ok && std::equal(set.begin(), set.end(), reference_set.begin(), reference_set.end());
+    ok = ok && set.Contains(9) && !set.Contains(2) && set.Erase(9) == 1 && !set.Contains(9);
+
+    // 比较在排序或归并的任意一步抛出: 集合保持有序且不变
+    Potato::FlatSet<int, ThrowingLess> strict;
+    for (int i = 0; i < 64; ++i) strict.Insert(i * 3);
+    std::vector<int> incoming;
+    for (int i = 0; i < 50; ++i) incoming.push_back(static_cast<int>(random() % 200));
+    Potato::FlatSet<int, ThrowingLess> probe = strict;
+    ThrowingLess::budget = 1 << 20;
+    probe.InsertRange(incoming.begin(), incoming.end());
+    const int comparisons = (1 << 20) - ThrowingLess::budget;
+    for (int budget = 0; budget < comparisons; budget += 37) {
+        ThrowingLess::budget = budget;
+        try {
+            strict.InsertRange(incoming.begin(), incoming.end());
+            ok = false;
+        } catch (const std::runtime_error&) {}
+        ThrowingLess::budget = -1;
+        ok = ok && strict.Size() == 64;
+        for (int i = 0; i < 64; ++i) ok = ok && strict.Keys()[i] == i * 3;
+    }
+
+    // 有状态的分配器: 构造函数接受分配器, InsertRange 的临时数组都沿用它
+    const std::size_t untagged = UntaggedAllocations;
+    Potato::FlatMap<int, int, std::less<>, TaggedAllocator<int>, TaggedAllocator<int>> tagged_map(
+        TaggedAllocator<int>(12), TaggedAllocator<int>(13));
+    tagged_map.InsertRange(batch.begin(), batch.end());
+    Potato::FlatSet<int, std::less<>, TaggedAllocator<int>> tagged_set({ 4, 2, 2, 8 }, {}, TaggedAllocator<int>(14));
+    tagged_set.InsertRange(values.begin(), values.end());
+    ok = ok && tagged_map.GetKeyAllocator().id == 12 && tagged_map.GetValueAllocator().id == 13;
+    std::set<int> batch_keys;
+    for (const auto& item : batch) batch_keys.insert(item.first);
+    ok = ok && tagged_map.Size() == batch_keys.size() && std::ranges::equal(tagged_map.Keys(), batch_keys);
+    ok = ok && tagged_set.GetAllocator().id == 14 && tagged_set.Size() == 7 && UntaggedAllocations == untagged;
+
+    Potato::Array<int> numbers{ 3, 1, 2 };
+    ok = ok && numbers.Sort() == Potato::Array<int>{ 1, 2, 3 } && numbers == Potato::Array<int>{ 3, 1, 2 };
+    ok = ok && numbers.SortInPlace(std::greater<>{}) == Potato::Array<int>{ 3, 2, 1 };
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+void BitArrayTest() {
+    std::cout << "=== BitArray Test ===\n";
+    bool ok = true;
+    Potato::BitArray bits;
+    std::vector<bool> reference;
+    std::mt19937_64 random(777);
+    for (int i = 0; i < 3000; ++i) {
+        const unsigned op = random() % 8;
+        if (op < 4 || reference.empty()) {
+            const bool value = random() % 3 == 0;
+            bits.Append(value);
+            reference.push_back(value);
+        } else if (op == 4) {
+            bits.Pop();
+            reference.pop_back();
+        } else if (op == 5) {
+            const std::size_t index = random() % reference.size();
+            bits.Flip(index);
+            reference[index] = !reference[index];
+        } else if (op == 6) {
+            const std::size_t count = random() % 200;
+            const bool value = random() % 2 == 0;
+            bits.Resize(count, value);
+            reference.resize(count, value);
+        } else {
+            const Potato::BitArray copy(bits);
+            bits.Append(copy);
+            const std::vector<bool> tail(reference);
+            reference.insert(reference.end(), tail.begin(), tail.end());
+            if (reference.size() > 4096) { bits.Resize(100); reference.resize(100); }
+        }
+        ok = ok && bits.Size() == reference.size()
+            && bits.Count() == static_cast<std::size_t>(std::count(reference.begin(), reference.end(), true));
+    }
+    for (std::size_t i = 0; i < reference.size(); ++i) ok = ok && bits[i] == reference[i];
+    for (const bool value : { true, false }) {
+        for (std::size_t start = 0; start <= reference.size(); start += 7) {
+            const auto it = std::find(reference.begin() + static_cast<std::ptrdiff_t>(start), reference.end(), value);
+            const std::size_t expected = it == reference.end() ? Potato::BitArray::npos : static_cast<std::size_t>(it - reference.begin());
+            ok = ok && bits.Find(value, start) == expected;
+        }
+        const auto last = std::find(reference.rbegin(), reference.rend(), value);
+        ok = ok && bits.FindLast(value).HasValue() == (last != reference.rend())
+            && (last == reference.rend() || *bits.FindLast(value) == static_cast<std::size_t>(reference.rend() - last - 1));
+    }
+
+    // 逻辑运算: 长度不同时较短的一方用 0 补齐, 结果长度取左侧
+    Potato::BitArray lhs(1000), rhs(900);
+    for (std::size_t i = 0; i < 1000; ++i) lhs[i] = i % 3 == 0;
+    for (std::size_t i = 0; i < 900; ++i) rhs[i] = i % 5 == 0;
+    const Potato::BitArray both = lhs & rhs, either = lhs | rhs, diff = lhs ^ rhs;
+    Potato::BitArray only = lhs;
+    only.AndNot(rhs);
+    for (std::size_t i = 0; i < 1000; ++i) {
+        const bool a = i % 3 == 0, b = i < 900 && i % 5 == 0;
+        ok = ok && both[i] == (a && b) && either[i] == (a || b) && diff[i] == (a != b) && only[i] == (a && !b);
+    }
+    ok = ok && both.Size() == 1000 && (~lhs).Count() == 1000 - lhs.Count();
+    std::size_t visited = 0;
+    both.ForEachSet([&](std::size_t index) { ok = ok && index % 15 == 0; ++visited; });
+    ok = ok && visited == both.Count() && visited == 60;
+    ok = ok && Potato::BitArray(70, true).All() && Potato::BitArray(70).None() && !Potato::BitArray{ false, true }.All();
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+void StringArrayTest() {
+    std::cout << "=== StringArray Test ===\n";
+    bool ok = true;
+    Potato::StringArray strings;
+    std::vector<std::string> reference;
+    std::mt19937_64 random(4242);
+    for (int i = 0; i < 2000; ++i) {
+        // 长度 0 ~ 39, 覆盖 16 字节前缀之内与之外的比较
+        std::string value(random() % 40, 'a');
+        for (char& c : value) c = static_cast<char>('a' + random() % 3);
+        strings.Append(value);
+        reference.push_back(value);
+    }
+    strings.Append(strings[5]); // 指向自身字节区的追加
+    reference.push_back(reference[5]);
+    ok = ok && strings.Size() == reference.size();
+    for (std::size_t i = 0; i < reference.size(); ++i) ok = ok && strings[i] == reference[i];
+    for (std::size_t probe = 0; probe < 200; ++probe) {
+        const std::string& needle = reference[random() % reference.size()];
+        const auto it = std::find(reference.begin(), reference.end(), needle);
+        ok = ok && strings.Find(needle) == static_cast<std::size_t>(it - reference.begin())
+            && strings.Count(needle) == static_cast<std::size_t>(std::count(reference.begin(), reference.end(), needle));
+        const std::string_view prefix = std::string_view(needle).substr(0, needle.size() / 2);
+        const auto hit = std::find_if(reference.begin(), reference.end(), [&](const std::string& s) { return s.starts_with(prefix); });
+        ok = ok && strings.FindPrefix(prefix) == static_cast<std::size_t>(hit - reference.begin());
+    }
+    ok = ok && !strings.IsContain("abd") && !strings.FindFirst(std::string(50, 'a')).HasValue();
+
+    const std::size_t erased = strings.EraseIf([](std::string_view s) { return s.size() % 2 == 1; });
+    std::erase_if(reference, [](const std::string& s) { return s.size() % 2 == 1; });
+    ok = ok && strings.Size() == reference.size() && erased > 0
+        && std::equal(strings.begin(), strings.end(), reference.begin(), reference.end());
+    strings.Pop();
+    reference.pop_back();
+    ok = ok && strings.Back() == reference.back();
+
+    // 空的 needle 与只含空串的数组 (字节区为 nullptr)
+    Potato::StringArray empties{ "", "" };
+    ok = ok && empties.Find(std::string_view{}) == 0 && empties.FindPrefix("") == 0 && empties.Data() == nullptr;
+    ok = ok && empties.EraseIf([](std::string_view) { return false; }) == 0 && empties.Size() == 2;
+
+    const Potato::StringArray words{ "potato", "", "tomato" };
+    ok = ok && words.Size() == 3 && words.At(1).empty() && words.Find("") == 1 && words.ByteSize() == 12;
+    ok = ok && !(words == Potato::StringArray(reference.begin(), reference.begin())) && words == Potato::StringArray{ "potato", "", "tomato" };
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
+// StreamingCopy 的正确性: 覆盖小于一条缓存行, 目标不对齐, 以及带尾部的长度; 计时见 ArrayBenchmark
+void StreamingCopyTest() {
+    std::cout << "=== Streaming Copy Test ===\n";
+    bool ok = true;
+    std::vector<unsigned char> source(4096 + 64);
+    for (std::size_t i = 0; i < source.size(); ++i) source[i] = static_cast<unsigned char>(i * 131 + 7);
+    for (const std::size_t bytes : { 0u, 1u, 15u, 63u, 64u, 65u, 200u, 1000u, 4096u }) {
+        for (std::size_t offset = 0; offset < 16; offset += 5) {
+            std::vector<unsigned char> dest(bytes + 64, 0xCD);
+            Potato::MemoryTools::StreamingCopy(dest.data() + offset, source.data() + 3, bytes);
+            ok = ok && std::equal(dest.begin() + offset, dest.begin() + offset + bytes, source.begin() + 3);
+            ok = ok && std::all_of(dest.begin(), dest.begin() + offset, [](unsigned char c) { return c == 0xCD; });
+            ok = ok && std::all_of(dest.begin() + offset + bytes, dest.end(), [](unsigned char c) { return c == 0xCD; });
+        }
+    }
+    // 目标先填入哨兵值, 搬运没有发生时比较必然失败
+    std::vector<int> values(10000);
+    for (std::size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>(i);
+    std::vector<int> relocated(values.size(), -1);
+    Potato::MemoryTools::TrivialRelocate(relocated.data(), values.data(), values.size());
+    ok = ok && relocated == values;
+    std::cout << "validation: " << (ok ? "PASS" : "FAIL") << "\n";
+}
+
 int main() {
     try {
         BasicLogicTest();
         // Choose counts conservative for CI; you can increase locally
         MemoryPressureTest(10000); // 10k (reduced for debugging)
         PerformanceTest(50000); // 50k (reduced for debugging)
+        CowArrayTest();
+        PersistentArrayTest();
+        OptionalNicheTest();
+        OptionalArrayTest();
+        OptionalReferenceTest();
+        OptionalChainTest();
+        TrivialBulkPathTest();
+        TrivialFillTest();
+        FillBackoutTest();
+        ExpectedTest();
+        VariantTest();
+        OptionalBatchTest();
+        TriviallyRelocatableTest();
+        OptionalConstexprTest();
+        SearchTest();
+        InstrumentationTest();
+        TraceTest();
+        CapacityHintTest();
+        EraseEmptyRangeTest();
+        HashMapTest();
+        FlatMapTest();
+        BitArrayTest();
+        StringArrayTest();
+        StreamingCopyTest();
     } catch (const std::exception& ex) {
         std::cerr << "Unhandled exception: " << ex.what() << '\n';
         return 2;